@@ -0,0 +1,72 @@
+/**
+ * @file bench.h
+ * @brief Timing helpers shared by the benchmarks
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_BENCH_H
+#define SSRE_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#if defined(__unix__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace ssre::bench {
+
+/**
+ * @brief Median run time of fn in seconds
+ *
+ * @param repeats runs, at least one
+ * @param fn
+ * @param before called ahead of every run, not timed
+ */
+template<typename F, typename B>
+double median(int repeats, F&& fn, B&& before) {
+    std::vector<double> times;
+    for(int i = 0; i < std::max(repeats, 1); ++i) {
+        before();
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+    return times[times.size() / 2];
+}
+
+template<typename F>
+double median(int repeats, F&& fn) {
+    return median(repeats, std::forward<F>(fn), []() {});
+}
+
+/**
+ * @brief Drop the cached pages of a file so the next read goes to the disk. Only clean pages are dropped,
+ * on systems without posix_fadvise the file stays cached and cold runs measure warm reads.
+ *
+ * @param path
+ * @return true the pages were dropped
+ */
+inline bool evictFromPageCache(const std::string& path) {
+#if defined(__unix__)
+    const int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+    const bool evicted = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(fd);
+    return evicted;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+} // ssre::bench
+
+#endif // SSRE_BENCH_H
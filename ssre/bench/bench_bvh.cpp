@@ -0,0 +1,108 @@
+/**
+ * @file bench_bvh.cpp
+ * @brief DynamicBVH build, update and queries against a flat scan of the same boxes
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include "bench.h"
+
+#include <bvh.h>
+#include <frustum.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace ssre;
+
+namespace {
+
+// objects spread over a flat 1km square, like a level
+std::vector<AABB> randomBoxes(std::mt19937& rng, size_t count) {
+    std::uniform_real_distribution<float> position{-500.f, 500.f};
+    std::uniform_real_distribution<float> radius{0.2f, 3.f};
+    std::vector<AABB> boxes(count);
+    for(AABB& box : boxes)
+        box = AABB::fromSphere(BoundingSphere{glm::vec3{position(rng), position(rng) * 0.05f, position(rng)}, radius(rng)});
+    return boxes;
+}
+
+} // namespace
+
+// usage: bench_bvh [repeats] [object count ...], defaults to 10k, 100k and 1M objects
+int main(int argc, char** argv) {
+    const int repeats = argc > 1 ? std::atoi(argv[1]) : 20;
+    std::vector<size_t> counts;
+    for(int i = 2; i < argc; ++i)
+        counts.push_back(std::strtoull(argv[i], nullptr, 10));
+    if(counts.empty())
+        counts = {10000, 100000, 1000000};
+
+    const glm::mat4 projection = glm::perspective(glm::radians(50.f), 16.f / 9.f, 0.1f, 200.f);
+    const glm::mat4 view = glm::lookAt(glm::vec3{0.f, 2.f, 0.f}, glm::vec3{10.f, 0.f, -20.f}, glm::vec3{0.f, 1.f, 0.f});
+    const Frustum frustum{projection * view};
+    const BoundingSphere sphere{glm::vec3{10.f, 0.f, 10.f}, 30.f};
+    const glm::vec3 rayOrigin{-600.f, 0.f, 1.f}, rayDirection{1.f, 0.001f, 0.002f};
+
+    std::printf("median of %d runs, times in ms\n\n", repeats);
+    std::printf("%10s %8s %10s %10s %10s %10s %10s %10s %10s\n",
+        "objects", "height", "build", "update", "frustum", "flat scan", "sphere", "ray", "visible");
+
+    std::mt19937 rng{5};
+    for(size_t count : counts) {
+        std::vector<AABB> boxes = randomBoxes(rng, count);
+
+        DynamicBVH tree;
+        std::vector<int32_t> proxies(count);
+        // a single build, the other columns reuse the tree
+        const double build = bench::median(1, [&]() {
+            for(size_t i = 0; i < count; ++i)
+                proxies[i] = tree.insert(boxes[i], static_cast<uint32_t>(i));
+        });
+
+        // a frame where a tenth of the objects move a little and one in a hundred jumps out of its enlarged box
+        std::uniform_real_distribution<float> jitter{-0.3f, 0.3f};
+        const double update = bench::median(repeats, [&]() {
+            for(size_t i = 0; i < count; i += 10) {
+                const glm::vec3 offset{i % 100 == 0 ? 50.f : jitter(rng), 0.f, 0.f};
+                boxes[i].min += offset;
+                boxes[i].max += offset;
+                tree.move(proxies[i], boxes[i]);
+            }
+        });
+
+        std::vector<uint32_t> visible;
+        const double frustumQuery = bench::median(repeats, [&]() {
+            visible.clear();
+            tree.query(frustum, visible);
+        });
+        size_t scanned = 0;
+        const double flatScan = bench::median(repeats, [&]() {
+            scanned = 0;
+            for(const AABB& box : boxes)
+                scanned += frustum.intersects(box);
+        });
+        std::vector<uint32_t> hits;
+        const double sphereQuery = bench::median(repeats, [&]() {
+            hits.clear();
+            tree.query(sphere, hits);
+        });
+        const double rayQuery = bench::median(repeats, [&]() {
+            hits.clear();
+            tree.query(rayOrigin, rayDirection, 1200.f, hits);
+        });
+
+        std::printf("%10zu %8d %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f %10zu\n", count, tree.getHeight(), build * 1e3,
+            update * 1e3, frustumQuery * 1e3, flatScan * 1e3, sphereQuery * 1e3, rayQuery * 1e3, visible.size());
+        // the tree tests enlarged boxes, it may return more objects than the scan but never fewer
+        if(visible.size() < scanned) {
+            std::fprintf(stderr, "frustum query returned %zu objects, the flat scan %zu\n", visible.size(), scanned);
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file bench_draw_calls.cpp
+ * @brief Uniform lookups by name against UniformHandle lookups in the renderer's per draw and per program work
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include "bench.h"
+
+#include <headless_context.h>
+#include <simpleShading.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace ssre;
+
+namespace {
+
+struct Timing {
+    double names = 0.;      // seconds per iteration
+    double handles = 0.;
+};
+
+void print(const char* label, const Timing& timing) {
+    std::printf("%-36s %12.1f %12.1f\n", label, timing.names * 1e9, timing.handles * 1e9);
+}
+
+} // namespace
+
+// usage: bench_draw_calls [repeats] [draws]
+int main(int argc, char** argv) {
+    const int repeats = argc > 1 ? std::atoi(argv[1]) : 5;
+    const int draws = std::max(argc > 2 ? std::atoi(argv[2]) : 200000, 1);
+
+    HeadlessContext context;
+    if(!gladLoadGLLoader((GLADloadproc)HeadlessContext::getProcAddress)) {
+        std::fprintf(stderr, "could not load GL\n");
+        return EXIT_FAILURE;
+    }
+    std::printf("%s, %d iterations, median of %d runs\n\n", glGetString(GL_RENDERER), draws, repeats);
+
+    PBRShading program;
+    program.SetShaderPath(gl::GLSLShaderType::VERTEX_SHADER, SSRE_BENCH_SHADERS "/draw.glsl.vert");
+    program.SetShaderPath(gl::GLSLShaderType::FRAGMENT_SHADER, SSRE_BENCH_SHADERS "/draw.glsl.frag");
+    program.loadAndBuild();
+
+    const UniformHandle farPlane{"lightFarPlane"}, nearPlane{"lightNearPlane"}, radius{"SamplingRadius"};
+    const UniformHandle shadowMap{mat_spec::ShadowMapSamplerName};
+    if(program.getUniformLocation(mat_spec::ModelMatrixUniform) != program.getUniformInfo(mat_spec::ModelMatrixUniformName).Location
+        || program.getUniformLocation(radius) != program.getUniformInfo("SamplingRadius").Location) {
+        std::fprintf(stderr, "handle and name lookups disagree\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("%-36s %12s %12s\n", "ns per iteration", "names", "handles");
+    volatile GLint sink = 0;
+
+    // the model and normal matrix locations of every draw
+    Timing lookups;
+    lookups.names = bench::median(repeats, [&]() {
+        for(int i = 0; i < draws; ++i)
+            sink = sink + program.getUniformInfo(mat_spec::ModelMatrixUniformName).Location
+                + program.getUniformInfo(mat_spec::NormalMatrixUniformName).Location;
+    }) / draws;
+    lookups.handles = bench::median(repeats, [&]() {
+        for(int i = 0; i < draws; ++i)
+            sink = sink + program.getUniformLocation(mat_spec::ModelMatrixUniform) + program.getUniformLocation(mat_spec::NormalMatrixUniform);
+    }) / draws;
+    print("per draw lookups", lookups);
+
+    // the shadow parameters set on every program switch
+    Timing switches;
+    switches.names = bench::median(repeats, [&]() {
+        for(int i = 0; i < draws; ++i) {
+            program.setShaderParameter("lightFarPlane", 100.f);
+            program.setShaderParameter("lightNearPlane", 0.1f);
+            sink = sink + program.getUniformInfo("SamplingRadius").Location + program.getUniformInfo(mat_spec::ShadowMapSamplerName).Location;
+        }
+    }) / draws;
+    switches.handles = bench::median(repeats, [&]() {
+        for(int i = 0; i < draws; ++i) {
+            program.setShaderParameter(farPlane, 100.f);
+            program.setShaderParameter(nearPlane, 0.1f);
+            sink = sink + program.getUniformLocation(radius) + program.getUniformLocation(shadowMap);
+        }
+    }) / draws;
+    print("per program switch", switches);
+
+    // empty draws measure the submission cost of the loop, not rasterization
+    GLuint framebuffer = 0, renderbuffer = 0, vao = 0;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glGenRenderbuffers(1, &renderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 1, 1);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffer);
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glViewport(0, 0, 1, 1);
+    program.use();
+
+    const glm::mat4 model{1.f};
+    const glm::mat3 normal{1.f};
+    Timing loop;
+    loop.names = bench::median(repeats, [&]() {
+        for(int i = 0; i < draws; ++i) {
+            gl::glUniform(model, program.getUniformInfo(mat_spec::ModelMatrixUniformName).Location);
+            gl::glUniform(normal, program.getUniformInfo(mat_spec::NormalMatrixUniformName).Location);
+            glDrawArrays(GL_TRIANGLES, 0, 0);
+        }
+        glFinish();
+    }) / draws;
+    loop.handles = bench::median(repeats, [&]() {
+        for(int i = 0; i < draws; ++i) {
+            gl::glUniform(model, program.getUniformLocation(mat_spec::ModelMatrixUniform));
+            gl::glUniform(normal, program.getUniformLocation(mat_spec::NormalMatrixUniform));
+            glDrawArrays(GL_TRIANGLES, 0, 0);
+        }
+        glFinish();
+    }) / draws;
+    print("draw loop, 2 uniforms + empty draw", loop);
+
+    const GLenum error = glGetError();
+    glDeleteVertexArrays(1, &vao);
+    glDeleteRenderbuffers(1, &renderbuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+    if(error != GL_NO_ERROR) {
+        std::fprintf(stderr, "GL error %x\n", error);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file bench_material_switch.cpp
+ * @brief Material switches through the per program material uniform block against default block uniforms
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include "bench.h"
+
+#include <headless_context.h>
+#include <material.h>
+#include <simpleShading.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using namespace ssre;
+
+namespace {
+
+struct Result {
+    double applyOnly = 0.;  // seconds per switch
+    double applyDraw = 0.;
+    bool correct = false;
+};
+
+// one pixel per material, checks that every draw saw the factors of its material
+bool checkPixels(uint32_t count) {
+    std::vector<uint8_t> pixels(size_t{count} * 4);
+    glReadPixels(0, 0, static_cast<GLsizei>(count), 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    for(uint32_t i = 0; i < count; ++i) {
+        const uint8_t* p = &pixels[size_t{i} * 4];
+        if(std::abs(p[0] - int(i % 250)) > 1 || std::abs(p[1] - int(i / 250 % 250)) > 1 || std::abs(p[2] - 191) > 1 || std::abs(p[3] - 191) > 1)
+            return false;
+    }
+    return true;
+}
+
+Result run(const char* fragmentShader, uint32_t count, int repeats, uint32_t switches) {
+    PBRShading program;
+    program.SetShaderPath(gl::GLSLShaderType::VERTEX_SHADER, SSRE_BENCH_SHADERS "/fullscreen.glsl.vert");
+    program.SetShaderPath(gl::GLSLShaderType::FRAGMENT_SHADER, fragmentShader);
+    program.loadAndBuild();
+
+    std::vector<std::unique_ptr<Material>> materials;
+    for(uint32_t i = 0; i < count; ++i) {
+        MaterialInfo info{};
+        info.diffuse = glm::vec3{(i % 250) / 255.f, (i / 250 % 250) / 255.f, 0.5f};
+        info.emission = glm::vec3{0.f, 0.f, 0.25f};
+        info.roughness = 0.25f;
+        info.metallic = 0.5f;
+        materials.push_back(program.createMaterial(info));
+    }
+
+    Result result;
+    program.use();
+    for(uint32_t i = 0; i < count; ++i) {
+        glViewport(static_cast<GLint>(i), 0, 1, 1);
+        program.applyMaterial(materials[i]);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+    result.correct = checkPixels(count);
+
+    glViewport(0, 0, 1, 1);
+    result.applyOnly = bench::median(repeats, [&]() {
+        for(uint32_t k = 0; k < switches; ++k)
+            program.applyMaterial(materials[k % count]);
+        glFinish();
+    }) / switches;
+    // draws make the driver consume the changed state
+    result.applyDraw = bench::median(repeats, [&]() {
+        for(uint32_t k = 0; k < switches / 10; ++k) {
+            program.applyMaterial(materials[k % count]);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+        }
+        glFinish();
+    }) / (switches / 10);
+    return result;
+}
+
+} // namespace
+
+// usage: bench_material_switch [repeats] [materials] [switches]
+int main(int argc, char** argv) {
+    const int repeats = argc > 1 ? std::atoi(argv[1]) : 5;
+    const uint32_t count = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 1000;
+    const uint32_t switches = std::max(argc > 3 ? static_cast<uint32_t>(std::atoi(argv[3])) : 200000u, 10u);
+
+    HeadlessContext context;
+    if(!gladLoadGLLoader((GLADloadproc)HeadlessContext::getProcAddress)) {
+        std::fprintf(stderr, "could not load GL\n");
+        return EXIT_FAILURE;
+    }
+    std::printf("%s, %u materials, median of %d runs\n\n", glGetString(GL_RENDERER), count, repeats);
+
+    // a pixel row per material and a triangle covering the viewport
+    GLuint framebuffer = 0, renderbuffer = 0, vao = 0, vbo = 0;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glGenRenderbuffers(1, &renderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, static_cast<GLsizei>(count), 1);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffer);
+    const float triangle[] = {-1.f, -1.f, 0.f, 3.f, -1.f, 0.f, -1.f, 3.f, 0.f};
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle), triangle, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    std::printf("%-20s %16s %16s %8s\n", "parameters", "apply ns", "apply+draw ns", "correct");
+    bool correct = true;
+    struct Variant {
+        const char* label;
+        const char* shader;
+    };
+    for(const Variant& variant : {Variant{"uniform block", SSRE_BENCH_SHADERS "/material_block.glsl.frag"},
+        Variant{"default uniforms", SSRE_BENCH_SHADERS "/material_uniforms.glsl.frag"}}) {
+        const Result result = run(variant.shader, count, repeats, switches);
+        std::printf("%-20s %16.1f %16.1f %8s\n", variant.label, result.applyOnly * 1e9, result.applyDraw * 1e9, result.correct ? "yes" : "no");
+        correct &= result.correct;
+    }
+
+    glDeleteBuffers(1, &vbo);
+    glDeleteVertexArrays(1, &vao);
+    glDeleteRenderbuffers(1, &renderbuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+    return correct ? EXIT_SUCCESS : EXIT_FAILURE;
+}
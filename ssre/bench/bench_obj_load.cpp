@@ -0,0 +1,107 @@
+/**
+ * @file bench_obj_load.cpp
+ * @brief OBJ import through tinyobj::LoadObj with serial vertex building against obj::loadObj
+ * with vertex building on the pool, the two paths of Resource::loadObj
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include "bench.h"
+
+#include <geometry.h>
+#include <obj_loader.h>
+#include <thread_pool.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace ssre;
+
+namespace {
+
+struct Imported {
+    size_t shapes = 0;
+    size_t vertices = 0;
+};
+
+Imported loadTinyobj(const std::string& path, const std::string& baseDir, bool buildBuffers) {
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn, err;
+    if(!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str(), baseDir.c_str())) {
+        std::fprintf(stderr, "tinyobj: %s\n", err.c_str());
+        std::exit(EXIT_FAILURE);
+    }
+    Imported imported{shapes.size(), 0};
+    if(buildBuffers) {
+        for(const tinyobj::shape_t& shape : shapes)
+            imported.vertices += obj::buildShapeBuffer(attrib, shape).buffer_data.size() / GeomSizeAndStride;
+    }
+    return imported;
+}
+
+Imported loadParallel(const std::string& path, const std::string& baseDir, util::ThreadPool& pool, bool buildBuffers) {
+    obj::ObjFile file;
+    std::string warn, err;
+    if(!obj::loadObj(file, path, baseDir, pool, warn, err)) {
+        std::fprintf(stderr, "obj: %s\n", err.c_str());
+        std::exit(EXIT_FAILURE);
+    }
+    Imported imported{file.shapes.size(), 0};
+    if(buildBuffers) {
+        std::vector<size_t> vertices(file.shapes.size());
+        pool.parallel_for(file.shapes.size(), [&](size_t s) {
+            vertices[s] = obj::buildShapeBuffer(file.attrib, file.shapes[s]).buffer_data.size() / GeomSizeAndStride;
+        });
+        for(size_t v : vertices)
+            imported.vertices += v;
+    }
+    return imported;
+}
+
+} // namespace
+
+// usage: bench_obj_load [repeats] [file.obj ...], defaults to bunny.obj and dog.obj of vfc_base2022v2
+int main(int argc, char** argv) {
+    const int repeats = argc > 1 ? std::atoi(argv[1]) : 10;
+    std::vector<std::string> files;
+    for(int i = 2; i < argc; ++i)
+        files.push_back(argv[i]);
+    if(files.empty())
+        files = {SSRE_BENCH_RESOURCES "/bunny.obj", SSRE_BENCH_RESOURCES "/dog.obj"};
+
+    util::ThreadPool pool;
+    std::printf("%zu workers, median of %d runs, cold runs drop the file from the page cache first\n\n", pool.size(), repeats);
+    std::printf("%-12s %-22s %10s %10s %10s %10s\n", "file", "path", "cold ms", "warm ms", "shapes", "vertices");
+
+    for(const std::string& path : files) {
+        const std::string name = path.substr(path.find_last_of("/\\") + 1);
+        const std::string baseDir = path.substr(0, path.find_last_of("/\\") + 1);
+        bool evicted = true;
+        auto evict = [&]() {evicted &= bench::evictFromPageCache(path);};
+
+        struct Variant {
+            const char* label;
+            bool parallel;
+            bool buildBuffers;
+        };
+        for(const Variant& variant : {Variant{"tinyobj parse", false, false}, Variant{"tinyobj + buffers", false, true},
+            Variant{"parallel parse", true, false}, Variant{"parallel + buffers", true, true}}) {
+            Imported imported;
+            auto run = [&]() {
+                imported = variant.parallel ? loadParallel(path, baseDir, pool, variant.buildBuffers)
+                    : loadTinyobj(path, baseDir, variant.buildBuffers);
+            };
+            const double cold = bench::median(repeats, run, evict);
+            const double warm = bench::median(repeats, run);
+            std::printf("%-12s %-22s %10.3f %10.3f %10zu %10zu\n", name.c_str(), variant.label, cold * 1e3, warm * 1e3,
+                imported.shapes, imported.vertices);
+        }
+        if(!evicted)
+            std::printf("%s could not be dropped from the page cache, cold runs read cached data\n", name.c_str());
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file bench_texture_stream.cpp
+ * @brief Texture streaming under load, fails when an update overruns the renderer's upload budget
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include "bench.h"
+
+#include <headless_context.h>
+#include <renderer.h>
+#include <texture.h>
+#include <texture_streamer.h>
+#include <thread_pool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ssre;
+
+// usage: bench_texture_stream [textures] [image ...], defaults to the images of vfc_base2022v2
+int main(int argc, char** argv) {
+    const uint32_t count = std::max(argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 100u, 1u);
+    std::vector<std::string> files;
+    for(int i = 2; i < argc; ++i)
+        files.push_back(argv[i]);
+    if(files.empty()) {
+        files = {SSRE_BENCH_RESOURCES "/cartoonWood.jpg", SSRE_BENCH_RESOURCES "/cloud.bmp", SSRE_BENCH_RESOURCES "/desert.jpg",
+            SSRE_BENCH_RESOURCES "/flowers.jpg", SSRE_BENCH_RESOURCES "/grass.jpg", SSRE_BENCH_RESOURCES "/skybox/back.jpg",
+            SSRE_BENCH_RESOURCES "/skybox/bottom.jpg", SSRE_BENCH_RESOURCES "/skybox/front.jpg", SSRE_BENCH_RESOURCES "/skybox/left.jpg",
+            SSRE_BENCH_RESOURCES "/skybox/right.jpg", SSRE_BENCH_RESOURCES "/skybox/top.jpg"};
+    }
+
+    HeadlessContext context;
+    if(!gladLoadGLLoader((GLADloadproc)HeadlessContext::getProcAddress)) {
+        std::fprintf(stderr, "could not load GL\n");
+        return EXIT_FAILURE;
+    }
+    const double budget = Renderer::TextureUploadBudget;
+    util::ThreadPool workers;
+    std::printf("%s, %u textures, %zu workers, budget %.1f ms\n\n", glGetString(GL_RENDERER), count, workers.size(), budget * 1e3);
+
+    // update once per frame until every texture is uploaded
+    TextureStreamer streamer{workers};
+    std::vector<std::shared_ptr<Texture2D>> textures;
+    for(uint32_t i = 0; i < count; ++i) {
+        textures.push_back(std::make_shared<Texture2D>(files[i % files.size()]));
+        streamer.load(textures.back(), files[i % files.size()]);
+    }
+    // a single upload may exceed the budget, it is always done
+    double single = 0., several = 0.;
+    uint64_t updates = 0;
+    const auto start = std::chrono::steady_clock::now();
+    while(!streamer.idle()) {
+        const uint64_t done = streamer.getStats().uploaded + streamer.getStats().failed;
+        streamer.update(budget);
+        glFlush();
+        const TextureStreamStats& stats = streamer.getStats();
+        double& slowest = stats.uploaded + stats.failed - done > 1 ? several : single;
+        slowest = std::max(slowest, stats.lastUpdateTime);
+        ++updates;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    glFinish();
+    const double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const TextureStreamStats& stats = streamer.getStats();
+    std::printf("%-32s %12llu\n", "uploaded", static_cast<unsigned long long>(stats.uploaded));
+    std::printf("%-32s %12llu\n", "failed", static_cast<unsigned long long>(stats.failed));
+    std::printf("%-32s %12.1f\n", "uploaded MB", stats.uploadedBytes / 1e6);
+    std::printf("%-32s %12llu\n", "updates", static_cast<unsigned long long>(updates));
+    std::printf("%-32s %12.1f\n", "total ms", total * 1e3);
+    std::printf("%-32s %12.2f\n", "slowest single upload update ms", single * 1e3);
+    std::printf("%-32s %12.2f\n", "slowest multi upload update ms", several * 1e3);
+
+    // destroying a streamer waits for its decodes
+    for(uint32_t round = 0; round < 16; ++round) {
+        TextureStreamer dropped{workers, 4};
+        for(uint32_t i = 0; i < count; ++i)
+            dropped.load(std::make_shared<Texture2D>(files[i % files.size()]), files[(i + round) % files.size()]);
+        dropped.update(budget);
+    }
+
+    bool passed = true;
+    // an update stops uploading once the budget is spent, so it overruns by at most one upload
+    if(several > budget + std::max(single, budget)) {
+        std::fprintf(stderr, "an update uploading several textures took %.2f ms, budget %.1f ms\n", several * 1e3, budget * 1e3);
+        passed = false;
+    }
+    if(stats.failed > 0 || stats.uploaded != count) {
+        std::fprintf(stderr, "%llu of %u textures uploaded\n", static_cast<unsigned long long>(stats.uploaded), count);
+        passed = false;
+    }
+    const GLenum error = glGetError();
+    if(error != GL_NO_ERROR) {
+        std::fprintf(stderr, "GL error %x\n", error);
+        passed = false;
+    }
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,12 @@
+#version 450
+
+uniform float SamplingRadius;
+uniform sampler2D lightShadowAtlas;
+
+in vec3 Normal;
+
+out vec4 FragColor;
+
+void main() {
+    FragColor = vec4(Normal, SamplingRadius) * texture(lightShadowAtlas, Normal.xy);
+}
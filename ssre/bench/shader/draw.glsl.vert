@@ -0,0 +1,23 @@
+#version 450
+
+// the per draw and per program inputs the renderer sets on color programs
+layout(std140) uniform Globals {
+    mat4 V;
+    mat4 P;
+};
+layout(std140) uniform ShaderData {
+    float lightFarPlane;
+    float lightNearPlane;
+};
+
+uniform mat4 M;
+uniform mat3 G;
+
+in vec3 VertPos;
+
+out vec3 Normal;
+
+void main() {
+    Normal = G * vec3(lightFarPlane, lightNearPlane, 1.0);
+    gl_Position = P * V * M * vec4(VertPos, 1.0);
+}
@@ -0,0 +1,12 @@
+#version 450
+
+// PBRShading requires the global block, its matrices are not needed here
+layout(std140) uniform Globals {
+    mat4 P;
+};
+
+in vec3 VertPos;
+
+void main() {
+    gl_Position = vec4(VertPos, 1.0);
+}
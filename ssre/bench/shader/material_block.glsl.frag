@@ -0,0 +1,15 @@
+#version 450
+
+// PBRShading packs these into the per program material block
+layout(std140) uniform MaterialData {
+    vec3 albedoFactor;
+    float roughnessFactor;
+    vec3 emissiveFactor;
+    float metallicFactor;
+};
+
+out vec4 FragColor;
+
+void main() {
+    FragColor = vec4(albedoFactor + emissiveFactor, roughnessFactor + metallicFactor);
+}
@@ -0,0 +1,13 @@
+#version 450
+
+// the same parameters as default block uniforms, set one by one on every material switch
+uniform vec3 albedoFactor;
+uniform float roughnessFactor;
+uniform vec3 emissiveFactor;
+uniform float metallicFactor;
+
+out vec4 FragColor;
+
+void main() {
+    FragColor = vec4(albedoFactor + emissiveFactor, roughnessFactor + metallicFactor);
+}
@@ -0,0 +1,98 @@
+/**
+ * @file bounds.h
+ * @brief bounding volumes
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_BOUNDS_H
+#define SSRE_BOUNDS_H
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+namespace ssre {
+
+struct BoundingSphere;
+
+/**
+ * @brief Axis aligned bounding box
+ */
+struct AABB {
+    glm::vec3 min{std::numeric_limits<float>::max()};
+    glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+    bool valid() const noexcept {return min.x <= max.x && min.y <= max.y && min.z <= max.z;}
+
+    glm::vec3 center() const noexcept {return (min + max) * 0.5f;}
+    glm::vec3 extent() const noexcept {return (max - min) * 0.5f;}
+
+    void expand(const glm::vec3& p) noexcept {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+
+    void expand(const AABB& b) noexcept {
+        min = glm::min(min, b.min);
+        max = glm::max(max, b.max);
+    }
+
+    bool contains(const AABB& b) const noexcept {
+        return min.x <= b.min.x && min.y <= b.min.y && min.z <= b.min.z &&
+            max.x >= b.max.x && max.y >= b.max.y && max.z >= b.max.z;
+    }
+
+    float surfaceArea() const noexcept {
+        const glm::vec3 d = max - min;
+        return 2.f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    static AABB merge(const AABB& a, const AABB& b) noexcept {
+        return AABB{glm::min(a.min, b.min), glm::max(a.max, b.max)};
+    }
+
+    static AABB fromSphere(const BoundingSphere& s) noexcept;
+
+    /**
+     * @brief box containing this box after transformation by m
+     */
+    AABB transformed(const glm::mat4& m) const noexcept {
+        const glm::vec3 c = glm::vec3{m * glm::vec4{center(), 1.f}};
+        const glm::vec3 e = extent();
+        // extent of the transformed box is |M| * e
+        glm::vec3 te{0.f};
+        for(int col = 0; col < 3; ++col)
+            te += glm::abs(glm::vec3{m[col]}) * e[col];
+        return AABB{c - te, c + te};
+    }
+};
+
+/**
+ * @brief Bounding sphere
+ */
+struct BoundingSphere {
+    glm::vec3 center{0.f};
+    float radius = 0.f;
+
+    /**
+     * @brief sphere containing this sphere after transformation by m, radius is scaled by the largest axis scale
+     */
+    BoundingSphere transformed(const glm::mat4& m) const noexcept {
+        const float sx = glm::dot(glm::vec3{m[0]}, glm::vec3{m[0]});
+        const float sy = glm::dot(glm::vec3{m[1]}, glm::vec3{m[1]});
+        const float sz = glm::dot(glm::vec3{m[2]}, glm::vec3{m[2]});
+        return BoundingSphere{glm::vec3{m * glm::vec4{center, 1.f}}, radius * std::sqrt(std::max(sx, std::max(sy, sz)))};
+    }
+};
+
+inline AABB AABB::fromSphere(const BoundingSphere& s) noexcept {
+    return AABB{s.center - glm::vec3{s.radius}, s.center + glm::vec3{s.radius}};
+}
+
+}
+
+#endif // SSRE_BOUNDS_H
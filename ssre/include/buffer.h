@@ -13,6 +13,8 @@
 #define SSRE_BUFFER_H
 
 #include <vector>
+#include <memory>
+#include <cstdint>
 
 #include <ssre_gl.h>
 
@@ -38,6 +40,14 @@ public:
     template<typename T>
     void CopyData(const std::vector<T>& source);
 
+    /**
+     * @brief Fill entire buffer with raw bytes, eg. from a mapped file
+     * 
+     * @param source 
+     * @param bytes 
+     */
+    void CopyData(const void* source, std::size_t bytes);
+
     /**
      * @brief Update part of data in buffer. Buffer should have data allocated before call is made to sub data
      * 
@@ -58,6 +68,15 @@ public:
     template<typename T>
     void SubData(const std::vector<T>& source, uint32_t offset, uint32_t stride);
 
+    /**
+     * @brief Update part of data in buffer with raw bytes. Buffer should have data allocated before call is made to sub data
+     * 
+     * @param source 
+     * @param bytes 
+     * @param offset 
+     */
+    void SubData(const void* source, std::size_t bytes, std::size_t offset);
+
     /**
      * @brief Allocate buffer data
      * 
@@ -65,6 +84,14 @@ public:
      */
     void Allocate(std::size_t bytes);
 
+    /**
+     * @brief Allocate immutable storage. Allocate, CopyData and SubData must not be used on the buffer afterwards
+     * 
+     * @param bytes number of bytes to allocate
+     * @param flags glBufferStorage flags
+     */
+    void Storage(std::size_t bytes, GLbitfield flags);
+
     /**
      * @brief Bind this buffer to its target
      */
@@ -132,6 +159,91 @@ void Buffer::SubData(const std::vector<T>& source, uint32_t offset, uint32_t str
     }
 }
 
+/**
+ * @brief Buffer for data written by the CPU every frame. Storage is persistently mapped and split into one
+ * region per frame in flight, so data is written with memcpy while the GPU reads the regions of earlier frames.
+ * A region is written again only after the fence of the frame that last used it has signaled.
+ */
+class StreamBuffer {
+public:
+    static constexpr uint32_t FramesInFlight = 3;
+
+    /**
+     * @brief Create a stream buffer
+     * 
+     * @param target 
+     * @param frameBytes bytes that can be written per frame before the buffer grows
+     */
+    StreamBuffer(gl::BindingTarget target, std::size_t frameBytes);
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer& o) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    /**
+     * @brief Reserve bytes in the region of the current frame. If the region is full the buffer is replaced by a larger one,
+     * commands issued before the call keep reading the old storage but handles and offsets returned earlier must not be used again.
+     * 
+     * @param bytes 
+     * @param alignment required alignment of the returned offset
+     * @return std::size_t offset in bytes from the start of the buffer
+     */
+    std::size_t allocate(std::size_t bytes, std::size_t alignment);
+
+    /**
+     * @brief Copy data into the region of the current frame
+     * 
+     * @param source 
+     * @param bytes 
+     * @param alignment 
+     * @return std::size_t offset of the data from the start of the buffer
+     */
+    std::size_t write(const void* source, std::size_t bytes, std::size_t alignment);
+
+    /**
+     * @brief mapped storage at offset returned by allocate
+     */
+    void* data(std::size_t offset) noexcept {return mapped + offset;}
+
+    GLuint Handle() noexcept {return buffer->Handle();}
+
+    /**
+     * @brief bytes that can be written per frame
+     */
+    std::size_t getFrameSize() const noexcept {return regionSize;}
+
+    /**
+     * @brief End the frame for all stream buffers. Fences the commands issued so far and waits until the GPU
+     * has finished the frame whose regions are written next. Called once per frame after all draws are issued.
+     */
+    static void EndFrame();
+
+    /**
+     * @brief GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, offsets of uniform buffer ranges must be a multiple of this
+     */
+    static std::size_t UniformOffsetAlignment();
+
+    /**
+     * @brief GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, offsets of shader storage buffer ranges must be a multiple of this
+     */
+    static std::size_t StorageOffsetAlignment();
+
+private:
+    void reallocate(std::size_t frameBytes);
+
+    const gl::BindingTarget target;
+
+    std::unique_ptr<Buffer> buffer;
+    uint8_t* mapped = nullptr;
+
+    std::size_t regionSize = 0;
+    std::size_t head = 0;       // next free byte in the region of frame
+    uint64_t frame = 0;         // frame head belongs to
+
+    static uint64_t frame_counter;
+    static GLsync frame_fences[FramesInFlight];
+};
+
 } // ssre
 
 #endif // SSRE_BUFFER_H
\ No newline at end of file
@@ -0,0 +1,132 @@
+/**
+ * @file bvh.h
+ * @brief dynamic bounding volume hierarchy
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_BVH_H
+#define SSRE_BVH_H
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include <bounds.h>
+
+namespace ssre {
+
+class Frustum;
+
+/**
+ * @brief Dynamic AABB tree. Leaves store an enlarged box so small movements do not change the tree,
+ * a leaf is only reinserted when its object leaves the enlarged box. Inserts choose the sibling with the
+ * lowest surface area cost and rotations keep the tree balanced.
+ */
+class DynamicBVH {
+public:
+    static constexpr int32_t Null = -1;
+
+    DynamicBVH() = default;
+
+    /**
+     * @brief Add an object
+     *
+     * @param box world bounds
+     * @param userData returned by queries
+     * @return int32_t proxy id
+     */
+    int32_t insert(const AABB& box, uint32_t userData);
+
+    void remove(int32_t proxy);
+
+    /**
+     * @brief Update the bounds of an object
+     *
+     * @param proxy
+     * @param box
+     * @return true if the proxy was reinserted
+     */
+    bool move(int32_t proxy, const AABB& box);
+
+    void setUserData(int32_t proxy, uint32_t userData) noexcept {nodes[proxy].userData = userData;}
+    uint32_t getUserData(int32_t proxy) const noexcept {return nodes[proxy].userData;}
+
+    /**
+     * @brief enlarged bounds stored for proxy
+     */
+    const AABB& getFatBounds(int32_t proxy) const noexcept {return nodes[proxy].box;}
+
+    /**
+     * @brief Append user data of objects whose bounds intersect the frustum
+     *
+     * @param frustum
+     * @param out
+     */
+    void query(const Frustum& frustum, std::vector<uint32_t>& out) const;
+
+    /**
+     * @brief Append user data of objects whose bounds intersect the sphere
+     */
+    void query(const BoundingSphere& sphere, std::vector<uint32_t>& out) const;
+
+    /**
+     * @brief Append user data of objects whose bounds are hit by the ray within maxDistance
+     *
+     * @param origin
+     * @param direction does not need to be normalized, maxDistance is in units of direction
+     * @param maxDistance
+     * @param out
+     */
+    void query(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<uint32_t>& out) const;
+
+    size_t size() const noexcept {return proxyCount;}
+
+    /**
+     * @brief height of the tree, 0 when empty or a single leaf
+     */
+    int32_t getHeight() const noexcept {return root == Null ? 0 : nodes[root].height;}
+
+private:
+    struct TreeNode {
+        AABB box;
+        int32_t parent = Null;  // next free node when on the free list
+        int32_t child1 = Null;
+        int32_t child2 = Null;
+        int32_t height = 0;     // leaf 0, free -1
+        uint32_t userData = 0;
+
+        bool isLeaf() const noexcept {return child1 == Null;}
+    };
+
+    int32_t allocateNode();
+    void freeNode(int32_t node);
+
+    void insertLeaf(int32_t leaf);
+    void removeLeaf(int32_t leaf);
+
+    /**
+     * @brief rotate if the children of node differ in height by more than one
+     *
+     * @return int32_t new root of the subtree
+     */
+    int32_t balance(int32_t node);
+
+    /**
+     * @brief recompute boxes and heights from node up to the root
+     */
+    void refitAncestors(int32_t node);
+
+    void collectLeaves(int32_t node, std::vector<uint32_t>& out) const;
+
+    std::vector<TreeNode> nodes;
+    int32_t root = Null;
+    int32_t freeList = Null;
+    size_t proxyCount = 0;
+};
+
+}
+
+#endif // SSRE_BVH_H
@@ -0,0 +1,163 @@
+/**
+ * @file clusters.h
+ * @brief clustered forward light lists
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_CLUSTERS_H
+#define SSRE_CLUSTERS_H
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include <bounds.h>
+
+namespace ssre {
+
+namespace util {
+class ThreadPool;
+}
+
+/**
+ * @brief Light read by color programs from the light buffer, std430 layout
+ */
+struct ClusterLight {
+    glm::vec4 positionRange;    // xyz world position, w range where the light's contribution ends
+    glm::vec4 color;            // rgb radiant intensity
+};
+static_assert(sizeof(ClusterLight) == 32, "ClusterLight must match the light buffer layout");
+
+/**
+ * @brief Grid parameters at the start of the cluster buffer, followed by one uvec2 (offset, count) per cluster, std430 layout.
+ * Programs find their cluster with
+ *      x = gl_FragCoord.x / tileSize.x, y = gl_FragCoord.y / tileSize.y
+ *      z = log(view depth) * depthParams.x + depthParams.y
+ * and the cluster index x + gridSize.x * (y + gridSize.y * z).
+ */
+struct ClusterHeader {
+    glm::uvec4 gridSize;    // xyz cluster counts, w number of lights
+    glm::vec4 depthParams;  // x slice scale, y slice bias, z near, w far
+    glm::vec4 tileSize;     // xy tile size in pixels
+};
+static_assert(sizeof(ClusterHeader) == 48, "ClusterHeader must match the cluster buffer layout");
+
+/**
+ * @brief View space froxel grid with the lights intersecting each cluster. Tiles split the viewport evenly,
+ * depth slices are exponential between the near and far plane of the projection.
+ */
+class LightClusters {
+public:
+    /**
+     * @brief lights binned in parallel when there are at least this many
+     */
+    static constexpr size_t ParallelLightCount = 32;
+
+    /**
+     * @brief Create a grid
+     *
+     * @param tilesX
+     * @param tilesY
+     * @param slices
+     */
+    LightClusters(uint32_t tilesX = 16, uint32_t tilesY = 9, uint32_t slices = 24);
+
+    /**
+     * @brief Set the projection and viewport size. Cluster bounds are recomputed if either changed.
+     * Near and far are taken from the projection matrix, which must be a finite OpenGL perspective projection.
+     *
+     * @param projection
+     * @param width
+     * @param height
+     */
+    void setProjection(const glm::mat4& projection, uint32_t width, uint32_t height);
+
+    /**
+     * @brief Bin lights into clusters. Each depth slice only tests lights whose depth range covers it,
+     * and only the columns and rows of clusters whose bounds overlap the light's.
+     *
+     * @param view
+     * @param lights xyz world position, w range
+     * @param pool if not null, depth slices are binned in parallel when there are enough lights
+     */
+    void build(const glm::mat4& view, const std::vector<glm::vec4>& lights, util::ThreadPool* pool = nullptr);
+
+    /**
+     * @brief Reference binning, tests every light against every cluster. Produces the same lists as build.
+     *
+     * @param view
+     * @param lights
+     */
+    void buildReference(const glm::mat4& view, const std::vector<glm::vec4>& lights);
+
+    const ClusterHeader& getHeader() const noexcept {return header;}
+
+    /**
+     * @brief offset into getLightIndices() and light count of each cluster
+     */
+    const std::vector<glm::uvec2>& getClusters() const noexcept {return clusters;}
+
+    /**
+     * @brief light lists of all clusters, light indices are indices into the lights passed to build
+     */
+    const std::vector<uint32_t>& getLightIndices() const noexcept {return lightIndices;}
+
+    /**
+     * @brief view space bounds of each cluster
+     */
+    const std::vector<AABB>& getClusterBounds() const noexcept {return bounds;}
+
+    uint32_t getClusterIndex(uint32_t x, uint32_t y, uint32_t z) const noexcept {return x + tilesX * (y + tilesY * z);}
+
+    uint32_t getClusterCount() const noexcept {return tilesX * tilesY * slices;}
+
+    /**
+     * @brief depth slice containing a positive view depth, may be outside [0, slices)
+     */
+    int32_t getSlice(float depth) const noexcept;
+
+    const uint32_t tilesX, tilesY, slices;
+
+private:
+    // view space sphere of a light and the slices it may touch
+    struct LightBounds {
+        glm::vec3 center;
+        float radius;
+        int32_t minZ, maxZ;
+    };
+
+    // light lists of one depth slice, clusters in the slice are in index order
+    struct SliceLists {
+        std::vector<glm::uvec2> clusters;   // offset in indices, count
+        std::vector<uint32_t> indices;
+        std::vector<uint32_t> candidates;   // lights whose depth range covers the slice
+        std::vector<glm::ivec4> candidateTiles; // first and last column, first and last row of each candidate
+    };
+
+    void computeLightBounds(const glm::mat4& view, const std::vector<glm::vec4>& lights);
+    void binSlice(uint32_t z);
+    void gatherSlices(uint32_t lightCount);
+
+    static bool intersects(const AABB& box, const glm::vec3& center, float radius) noexcept;
+
+    glm::mat4 projection{0.f};
+    uint32_t width = 0, height = 0;
+    float nearPlane = 0.f, farPlane = 0.f;
+
+    ClusterHeader header{};
+    std::vector<AABB> bounds;
+    // view space x extent of each column and y extent of each row of clusters, per slice
+    std::vector<glm::vec2> columnBounds, rowBounds;
+    std::vector<glm::uvec2> clusters;
+    std::vector<uint32_t> lightIndices;
+
+    std::vector<LightBounds> lightBounds;
+    std::vector<SliceLists> sliceLists;
+};
+
+}
+
+#endif // SSRE_CLUSTERS_H
@@ -0,0 +1,72 @@
+/**
+ * @file frustum.h
+ * @brief view frustum culling
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_FRUSTUM_H
+#define SSRE_FRUSTUM_H
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include <bounds.h>
+
+namespace ssre {
+
+/**
+ * @brief Spheres stored as separate coordinate arrays for batched tests
+ */
+struct SphereList {
+    std::vector<float> x, y, z, radius;
+
+    void clear() noexcept {x.clear(); y.clear(); z.clear(); radius.clear();}
+
+    void push_back(const BoundingSphere& s) {
+        x.push_back(s.center.x);
+        y.push_back(s.center.y);
+        z.push_back(s.center.z);
+        radius.push_back(s.radius);
+    }
+
+    size_t size() const noexcept {return x.size();}
+};
+
+class Frustum {
+public:
+    /**
+     * @brief Extract the six planes of a view projection matrix. Planes are normalized and point inwards.
+     *
+     * @param viewProjection
+     */
+    explicit Frustum(const glm::mat4& viewProjection);
+
+    /**
+     * @brief planes in order left, right, bottom, top, near, far. xyz normal, w distance
+     */
+    const glm::vec4& getPlane(int i) const noexcept {return planes[i];}
+
+    bool intersects(const BoundingSphere& s) const noexcept;
+
+    bool intersects(const AABB& box) const noexcept;
+
+    /**
+     * @brief Test all spheres, 4 at a time when SSE is available
+     *
+     * @param spheres
+     * @param visible set to 1 for spheres intersecting the frustum, 0 otherwise. spheres.size() entries
+     * @return uint32_t number of visible spheres
+     */
+    uint32_t intersects(const SphereList& spheres, uint8_t* visible) const noexcept;
+
+private:
+    glm::vec4 planes[6];
+};
+
+}
+
+#endif // SSRE_FRUSTUM_H
@@ -20,6 +20,8 @@
 #include <ssre.h>
 #include <buffer.h>
 #include <material.h>
+#include <bounds.h>
+#include <geometry_arena.h>
 
 namespace ssre {
 
@@ -28,11 +30,16 @@ namespace ssre {
  * 
  */
 struct DrawObject {
-    std::unique_ptr<Buffer> element_buffer{
-        std::make_unique<Buffer>(gl::BindingTarget::ELEMENT_ARRAY, gl::Usage::STATIC_DRAW)
-    };
+    /**
+     * @brief indices from the start of the geometry vertex data. Moved into the geometry arena by Geometry.
+     */
+    std::vector<GLuint> elements;
     size_t numElements;
     size_t material_id;
+    /**
+     * @brief offset of the indices in the arena index buffer, relative to the geometry range
+     */
+    uint32_t firstIndex = 0;
 };
 
 constexpr size_t GeomSizeAndStride = 11;
@@ -42,6 +49,30 @@ constexpr size_t GeomTangentOffsetBytes = 3 * sizeof(GLfloat);
 constexpr size_t GeomBitangentOffset = 6 * sizeof(GLfloat);
 constexpr size_t GeomTexCoordOffsetBytes = 9 * sizeof(GLfloat);
 
+constexpr size_t GeomCompactStrideBytes = 20;
+constexpr size_t GeomCompactVertexOffsetBytes = 0;
+constexpr size_t GeomCompactTangentOffsetBytes = 8;
+constexpr size_t GeomCompactBitangentOffsetBytes = 12;
+constexpr size_t GeomCompactTexCoordOffsetBytes = 16;
+
+/**
+ * @brief Vertex buffer layouts supported by Geometry
+ */
+enum class VertexFormat {
+    /**
+     * @brief 11 floats per vertex, see Geometry
+     */
+    Float,
+    /**
+     * @brief 20 bytes per vertex, vertex positions must be inside the unit cube
+     *      vertex data:    4 x snorm16 (w unused), offset 0
+     *      tangent data:   snorm 10_10_10_2, offset 8
+     *      bitangent data: snorm 10_10_10_2, offset 12
+     *      tex coord:      2 x half float, offset 16
+     */
+    Compact
+};
+
 /**
  * @brief Geometry data
  * layout:
@@ -77,16 +108,64 @@ constexpr size_t GeomTexCoordOffsetBytes = 9 * sizeof(GLfloat);
  */
 class Geometry {
 public:
+    /**
+     * @brief Geometry from interleaved vertex data, data is rescaled to fit the unit cube
+     */
     Geometry(std::vector<DrawObject> dobjs, const std::vector<GLfloat>& data);
+
+    /**
+     * @brief Geometry from final interleaved vertex data, uploaded as is
+     * 
+     * @param dobjs 
+     * @param data nVertices * GeomSizeAndStride floats
+     * @param nVertices 
+     */
+    Geometry(std::vector<DrawObject> dobjs, const GLfloat* data, size_t nVertices, VertexFormat format = VertexFormat::Float);
     Geometry(float uvextent);
+    ~Geometry();
+
+    Geometry(const Geometry&) = delete;
+    Geometry& operator=(const Geometry&) = delete;
+
+    /**
+     * @brief center and scale interleaved vertex data to fit in [-1, 1], normalizes tangent and bitangent
+     * 
+     * @param data 
+     */
+    static void fitToUnitCube(std::vector<GLfloat>& data);
+
+    /**
+     * @brief convert interleaved float vertex data to the VertexFormat::Compact layout. Positions are clamped to the unit cube.
+     * 
+     * @param data nVertices * GeomSizeAndStride floats
+     * @param nVertices 
+     * @return std::vector<uint8_t> nVertices * GeomCompactStrideBytes bytes
+     */
+    static std::vector<uint8_t> packCompact(const GLfloat* data, size_t nVertices);
+
+    VertexFormat getVertexFormat() const noexcept {return format;}
+
+    /**
+     * @brief unique geometry id, meshes sharing a geometry are batched by it
+     */
+    uint32_t getGeometryId() const noexcept {return geometry_id;}
+
+    /**
+     * @brief object space bounds of the uploaded vertex positions
+     */
+    const AABB& getBounds() const noexcept {return bounds;}
+    const BoundingSphere& getBoundingSphere() const noexcept {return boundingSphere;}
 
     void setMaterials(const std::vector<MaterialInfo>& mat) noexcept {materials = mat;}
     const std::vector<MaterialInfo>& getMaterials() const noexcept {return materials;}
 
-    const std::unique_ptr<Buffer>& getBuffer() const noexcept {return buffer;}
+    /**
+     * @brief location of the vertex and index data in the geometry arena
+     */
+    const ArenaRange& getArenaRange() const noexcept {return range;}
 
     bool setMaterialId(uint32_t shape, int32_t id) {
-        if(shape < drawObjects.size() && id < materials.size()) {
+        if(shape < drawObjects.size() && id >= 0 && static_cast<size_t>(id) < materials.size()) {
             drawObjects[shape].material_id = id;
             return true;
         }
@@ -116,27 +195,57 @@ public:
     const std::vector<DrawObject>& getDrawObjects() const noexcept {return drawObjects;}
 
     /**
-     * @brief configure a vao to point to buffers with geom data
+     * @brief arena VAO for the inputs, shared by all geometry in the same arena block
+     * 
+     * @param inputs 
+     * @return GLuint 
+     */
+    GLuint getVAO(const VertexInputs& inputs) const;
+
+    /**
+     * @brief draw parameters of a shape with a VAO from getVAO bound, instanceCount is 1 and baseInstance 0
      * 
-     * @param vao_id 
-     * @param vert_loc 
-     * @param tan_loc 
-     * @param bitan_loc 
-     * @param texc_loc 
+     * @param shape 
+     * @return gl::DrawElementsIndirectCommand 
      */
-    void configVaoAttribPtrs(uint32_t shape, GLuint vao_id, GLint vert_loc, GLint tan_loc, GLint bitan_loc, GLint texc_loc);
+    gl::DrawElementsIndirectCommand getDrawCommand(uint32_t shape) const;
 
 protected:
     /**
-     * @brief Buffers for mesh data. All index buffers count from start of vertex data buffers. 
-     * vertex_buffer, normal_buffer, and tex_buffer shared between all
+     * @brief compute bounds and boundingSphere from interleaved float vertex data
      */
-    std::unique_ptr<Buffer> buffer;
+    void computeBounds(const GLfloat* data, size_t nVertices);
+
+    /**
+     * @brief copy vertex data and the indices of all draw objects into the geometry arena
+     * 
+     * @param vertexData nVertices in the geometry format
+     * @param nVertices 
+     */
+    void upload(const void* vertexData, size_t nVertices);
+
+    /**
+     * @brief mesh data in the geometry arena. All draw object indices count from range.baseVertex.
+     */
+    ArenaRange range;
 
     std::vector<DrawObject> drawObjects;
 
+    // layout of buffer
+    VertexFormat format = VertexFormat::Float;
+
     // materials indexed by material id
     std::vector<MaterialInfo> materials;
+
+    AABB bounds;
+    BoundingSphere boundingSphere;
+
+    /**
+     * @brief unique geometry id counter
+     */
+    static uint32_t geometry_id_counter;
+
+    const uint32_t geometry_id = geometry_id_counter++;
 };
 
 }
@@ -0,0 +1,197 @@
+/**
+ * @file geometry_arena.h
+ * @brief shared vertex and index buffers for all geometry
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_GEOMETRY_ARENA_H
+#define SSRE_GEOMETRY_ARENA_H
+
+#include <map>
+#include <memory>
+#include <vector>
+#include <limits>
+#include <cstdint>
+
+#include <ssre_gl.h>
+#include <buffer.h>
+
+namespace ssre {
+
+enum class VertexFormat;
+class Program;
+
+/**
+ * @brief First fit allocator of ranges in [0, capacity). Freed ranges are merged with their neighbours.
+ */
+class RangeAllocator {
+public:
+    static constexpr uint32_t Invalid = std::numeric_limits<uint32_t>::max();
+
+    explicit RangeAllocator(uint32_t capacity = 0);
+
+    /**
+     * @brief allocate count consecutive elements
+     *
+     * @param count
+     * @return uint32_t offset of the range, Invalid if there is no free range large enough
+     */
+    uint32_t allocate(uint32_t count);
+
+    /**
+     * @brief return a range from allocate
+     */
+    void free(uint32_t offset, uint32_t count);
+
+    /**
+     * @brief add the elements [capacity, newCapacity) as free space
+     *
+     * @param newCapacity not smaller than the current capacity
+     */
+    void grow(uint32_t newCapacity);
+
+    /**
+     * @brief capacity needed so that count consecutive elements can be allocated, the current capacity if they fit already
+     */
+    uint64_t capacityFor(uint32_t count) const noexcept;
+
+    uint32_t getCapacity() const noexcept {return capacity;}
+    uint32_t getUsed() const noexcept {return used;}
+
+private:
+    // free ranges, offset -> count
+    std::map<uint32_t, uint32_t> freeRanges;
+    uint32_t capacity;
+    uint32_t used = 0;
+};
+
+/**
+ * @brief vertex input locations of a program. Programs with equal inputs share arena VAOs.
+ */
+struct VertexInputs {
+    GLint vertex = -1;
+    GLint tangent = -1;
+    GLint bitangent = -1;
+    GLint texCoord = -1;
+    GLint instanceModel = -1;
+    GLint instanceMaterial = -1;
+
+    static VertexInputs fromProgram(const Program& program);
+
+    bool operator==(const VertexInputs& o) const noexcept {
+        return vertex == o.vertex && tangent == o.tangent && bitangent == o.bitangent && texCoord == o.texCoord &&
+            instanceModel == o.instanceModel && instanceMaterial == o.instanceMaterial;
+    }
+};
+
+/**
+ * @brief location of geometry data in the arena. Indices count from baseVertex.
+ */
+struct ArenaRange {
+    uint32_t block = RangeAllocator::Invalid;
+    uint32_t baseVertex = 0;
+    uint32_t vertexCount = 0;
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+
+    bool valid() const noexcept {return block != RangeAllocator::Invalid;}
+};
+
+/**
+ * @brief Vertex and index data of all Geometry. Data is sub allocated from blocks, each block holds one
+ * vertex buffer of a single VertexFormat and one index buffer. Blocks start small and are reallocated with twice
+ * the size when full, up to the maximum block size, a new block is added when no block can grow. The VAOs of a
+ * block are pointed at its new buffers, so their names stay valid. Draws from the same block and program share
+ * one VAO and can be combined into a single glMultiDrawElementsIndirect.
+ */
+class GeometryArena {
+public:
+    static constexpr size_t InitialBlockVertexBytes = 1024 * 1024;
+    static constexpr uint32_t InitialBlockIndices = 256 * 1024;
+    static constexpr size_t MaxBlockVertexBytes = 64 * 1024 * 1024;
+    static constexpr uint32_t MaxBlockIndices = 16 * 1024 * 1024;
+
+    /**
+     * @brief Create an empty arena, blocks are created by allocate
+     *
+     * @param maxBlockVertexBytes blocks do not grow past this size, larger geometry gets a block of its own size
+     * @param maxBlockIndices
+     */
+    GeometryArena(size_t maxBlockVertexBytes = MaxBlockVertexBytes, uint32_t maxBlockIndices = MaxBlockIndices);
+    ~GeometryArena();
+
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    /**
+     * @brief reserve space for vertex and index data, adds a block if needed
+     *
+     * @param format layout of the vertex data
+     * @param nVertices
+     * @param nIndices
+     * @return ArenaRange
+     */
+    ArenaRange allocate(VertexFormat format, uint32_t nVertices, uint32_t nIndices);
+
+    /**
+     * @brief release a range from allocate
+     */
+    void free(const ArenaRange& range);
+
+    /**
+     * @brief upload data into an allocated range
+     *
+     * @param range
+     * @param vertexData range.vertexCount vertices in the block format
+     * @param indexData range.indexCount indices
+     */
+    void upload(const ArenaRange& range, const void* vertexData, const GLuint* indexData);
+
+    /**
+     * @brief VAO reading vertices and indices of a block with the given inputs. Instance inputs read
+     * mat_spec::InstanceBufferBinding, which the user binds.
+     *
+     * @param block
+     * @param inputs
+     * @return GLuint owned by the arena
+     */
+    GLuint getVAO(uint32_t block, const VertexInputs& inputs);
+
+    size_t getBlockCount() const noexcept {return blocks.size();}
+
+private:
+    struct Block {
+        VertexFormat format;
+        size_t stride;
+        std::unique_ptr<Buffer> vertices;
+        std::unique_ptr<Buffer> indices;
+        RangeAllocator vertexRanges;
+        RangeAllocator indexRanges;
+        std::vector<std::pair<VertexInputs, GLuint>> vaos;
+    };
+
+    uint32_t addBlock(VertexFormat format, uint32_t minVertices, uint32_t minIndices);
+
+    /**
+     * @brief try to allocate a range in block
+     */
+    bool allocateIn(uint32_t block, uint32_t nVertices, uint32_t nIndices, ArenaRange& range);
+
+    /**
+     * @brief reallocate the buffers of block so nVertices and nIndices fit, copies the data and updates the VAOs
+     *
+     * @return false if the block would grow past the maximum block size
+     */
+    bool growBlock(uint32_t block, uint32_t nVertices, uint32_t nIndices);
+
+    const size_t maxBlockVertexBytes;
+    const uint32_t maxBlockIndices;
+
+    std::vector<Block> blocks;
+};
+
+}
+
+#endif // SSRE_GEOMETRY_ARENA_H
@@ -48,6 +48,11 @@ struct MaterialInfo {
     std::shared_ptr<Texture> sheen_tex;      // map_Ps
     std::shared_ptr<Texture> emissive_tex;   // map_Ke
     std::shared_ptr<Texture> normal_tex;     // norm. For normal mapping.
+
+    glm::vec3 diffuse{1.f};     // Kd
+    glm::vec3 emission{0.f};    // Ke
+    float roughness = 1.f;      // Pr
+    float metallic = 0.f;       // Pm
 };
 
 /**
@@ -80,6 +85,21 @@ public:
 
     uint32_t getProgramId() const noexcept {return program_id;}
 
+    /**
+     * @brief unique id of this material, used to sort draws by material
+     */
+    uint32_t getMaterialId() const noexcept {return material_id;}
+
+    /**
+     * @brief index of this material's record in the material table, MaterialTable::NoIndex until it is added
+     */
+    uint32_t getTableIndex() const noexcept {return table_index;}
+
+    /**
+     * @brief incremented when a parameter is set, programs repack the material's parameter block when it changes
+     */
+    uint32_t getParameterRevision() const noexcept {return parameter_revision;}
+
     /**
      * @brief Set a Parameter value
      * 
@@ -119,6 +139,28 @@ protected:
      */
     const uint32_t program_id;
 
+    /**
+     * @brief unique material id, copies get a new id
+     */
+    const uint32_t material_id;
+
+    /**
+     * @brief unique material id counter
+     */
+    static uint32_t material_id_counter;
+
+    /**
+     * @brief set by the material table, copies are not in the table
+     */
+    uint32_t table_index = 0xffffffffu;
+
+    /**
+     * @brief parameter change counter
+     */
+    uint32_t parameter_revision = 0;
+
+    friend class MaterialTable;
+
     template<typename T>
     void addParameter(const std::string& name, const T& value);
 
@@ -129,9 +171,10 @@ template<typename T>
 bool Material::setParameter(const std::string& name, const T& value) {
     auto itr = parameters.find(name);
     if(itr != parameters.end()) { // update parameter value
-        Uniform<T>* param = dynamic_cast<Uniform<T>*>(itr->second);
+        Uniform<T>* param = dynamic_cast<Uniform<T>*>(itr->second.get());
         if(param != nullptr) {
             param->setValue(value);
+            ++parameter_revision;
         } else
             return false;
         return true;
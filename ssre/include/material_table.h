@@ -0,0 +1,119 @@
+/**
+ * @file material_table.h
+ * @brief material textures resident in texture arrays
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_MATERIAL_TABLE_H
+#define SSRE_MATERIAL_TABLE_H
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include <ssre_gl.h>
+
+namespace ssre {
+
+class Material;
+class Texture;
+class Buffer;
+
+/**
+ * @brief Textures of one material in the material buffer, std430 layout. Map i is maps[i / 4][i % 4],
+ * the texture array in the high 16 bits and the layer in the low 16 bits, or MaterialRecord::NoTexture.
+ */
+struct MaterialRecord {
+    static constexpr uint32_t MaxMaps = 8;
+    static constexpr uint32_t NoTexture = 0xffffffffu;
+
+    glm::uvec4 maps[MaxMaps / 4];
+};
+static_assert(sizeof(MaterialRecord) == 32, "MaterialRecord must match the material buffer layout");
+
+/**
+ * @brief Keeps the 2D textures of materials resident in texture arrays, one array per format, size and mip count,
+ * so programs reading the material buffer switch materials by index instead of binding textures.
+ * Textures are copied into a layer of their array, and copied again when they are replaced, e.g. by the texture streamer.
+ * Materials stay resident until the table is destroyed.
+ */
+class MaterialTable {
+public:
+    static constexpr uint32_t NoIndex = 0xffffffffu;
+
+    MaterialTable();
+    ~MaterialTable();
+
+    MaterialTable(const MaterialTable&) = delete;
+    MaterialTable& operator=(const MaterialTable&) = delete;
+
+    /**
+     * @brief Add a material, its textures are made resident on the next update
+     *
+     * @param material
+     * @return uint32_t index of the material's record, unchanged if it was added before
+     */
+    uint32_t add(Material& material);
+
+    /**
+     * @brief Copy new and changed textures into their arrays and upload changed records. Call before drawing.
+     */
+    void update();
+
+    /**
+     * @brief Bind the arrays to their texture units and the records to the material buffer binding
+     */
+    void bind() const;
+
+    size_t getMaterialCount() const noexcept {return records.size();}
+
+    size_t getArrayCount() const noexcept {return arrays.size();}
+
+    /**
+     * @brief number of textures copied into arrays, including copies after a texture changed
+     */
+    uint64_t getTextureCopies() const noexcept {return textureCopies;}
+
+private:
+    struct TextureArray {
+        GLuint handle = 0;
+        GLenum internalFormat = 0;
+        uint32_t width = 0, height = 0, levels = 0;
+        uint32_t capacity = 0, used = 0;
+        std::vector<uint32_t> freeLayers;
+    };
+
+    // a texture copied into an array layer
+    struct Resident {
+        std::shared_ptr<Texture> texture;
+        uint32_t revision = 0;
+        uint32_t map = MaterialRecord::NoTexture;
+        std::vector<uint32_t> users;    // records referencing the texture, with their map slot in the low 3 bits
+    };
+
+    uint32_t makeResident(Resident& resident);
+    void release(uint32_t map);
+    uint32_t allocateLayer(GLenum internalFormat, uint32_t width, uint32_t height, uint32_t levels);
+    void grow(TextureArray& array);
+
+    std::vector<TextureArray> arrays;
+    std::unordered_map<const Texture*, Resident> residents;
+    std::unordered_map<uint32_t, uint32_t> materialIndices;    // material id to record index
+    std::vector<MaterialRecord> records;
+    bool recordsChanged = false;
+    bool arraysFull = false;
+    uint64_t textureCopies = 0;
+    GLuint stagingBuffer = 0;
+
+    // created on the first update, the table is constructed before the context
+    std::unique_ptr<Buffer> recordBuffer;
+};
+
+}
+
+#endif // SSRE_MATERIAL_TABLE_H
@@ -41,6 +41,43 @@ public:
 
     void drawDepth() override;
 
+    /**
+     * @brief adds one command per draw object
+     */
+    void enqueue(RenderQueue& queue, RenderPass pass, const glm::mat4& viewMatrix) override;
+
+    void draw(RenderPass pass, uint32_t object, DrawState& state) override;
+
+    /**
+     * @brief model matrix and material of the draw object
+     */
+    void writeInstance(uint32_t object, InstanceData& out) const override;
+
+    /**
+     * @brief draws instances using the VAO and material of this mesh, used when the pass program is instanced
+     */
+    void drawInstanced(RenderPass pass, uint32_t object, uint32_t firstInstance, uint32_t instanceCount, DrawState& state) override;
+
+    /**
+     * @brief draw object range in the geometry arena, batched commands of all meshes can be drawn indirect
+     */
+    bool writeIndirect(uint32_t object, gl::DrawElementsIndirectCommand& out) const override;
+
+    /**
+     * @brief multi draw using the VAO and material of this mesh
+     */
+    void drawIndirect(RenderPass pass, uint32_t object, uint32_t firstIndirect, uint32_t indirectCount, DrawState& state) override;
+
+    /**
+     * @brief geometry bounding sphere in world space
+     */
+    bool getWorldBounds(BoundingSphere& sphere) const override;
+
+    /**
+     * @brief geometry bounding box in world space
+     */
+    AABB getWorldAABB() const;
+
     const std::shared_ptr<Program>& getColorProgram() const noexcept override {return color_program;}
     const std::shared_ptr<Program>& getDepthProgram() const noexcept override {return depth_program;}
 
@@ -71,6 +108,11 @@ protected:
      */
     void rebuildVAOs();
 
+    /**
+     * @brief rebuild VAOs if either program was reloaded
+     */
+    void updateVAOs();
+
     void forceVAORebuildOnNextDraw() noexcept {
         lastColorProgramId = std::numeric_limits<uint32_t>::max();
         lastColorModifiedCount = std::numeric_limits<uint32_t>::max();
@@ -93,9 +135,10 @@ protected:
     std::shared_ptr<Program> depth_program;
 
     struct VAODrawObject {
+        // arena VAOs, shared with other geometry and owned by the geometry arena
         GLuint color_vao_id;
         GLuint depth_vao_id;
-        uint32_t elementCount;
+        gl::DrawElementsIndirectCommand command;
         size_t mat_id;
     };
     using VAODrawObjectList = std::vector<VAODrawObject>;
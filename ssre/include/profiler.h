@@ -0,0 +1,162 @@
+/**
+ * @file profiler.h
+ * @brief frame profiler with cpu scopes and gpu timer queries
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_PROFILER_H
+#define SSRE_PROFILER_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+
+#include <ssre_gl.h>
+
+namespace ssre {
+
+/**
+ * @brief A timed scope. Names must have static storage duration, e.g. string literals.
+ */
+struct ProfileEvent {
+    const char* name;
+    double start;       // seconds since the profiler was created
+    double duration;    // seconds
+    uint32_t depth;     // nesting level of cpu scopes
+};
+
+/**
+ * @brief Timings of one frame. Gpu events are filled in Profiler::QueryLatency frames later.
+ */
+struct FrameProfile {
+    uint64_t frame = 0;
+    double start = 0.;
+    double duration = 0.;
+    std::vector<ProfileEvent> cpu;  // in begin order
+    std::vector<ProfileEvent> gpu;  // in submission order, start is the cpu submission time
+    bool gpuReady = false;
+};
+
+/**
+ * @brief Records cpu scopes and GL_TIME_ELAPSED queries of the last frames in a ring buffer.
+ * Gpu scopes cannot nest. Query results are read when their slot is reused, QueryLatency frames later.
+ */
+class Profiler {
+public:
+    static constexpr uint32_t QueryLatency = 3;
+
+    /**
+     * @brief Create a profiler
+     *
+     * @param historySize frames kept
+     */
+    explicit Profiler(size_t historySize = 300);
+    ~Profiler();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    void setEnabled(bool on) noexcept {enabled = on;}
+    bool isEnabled() const noexcept {return enabled;}
+
+    void beginFrame();
+    void endFrame();
+
+    void beginScope(const char* name);
+    void endScope();
+
+    /**
+     * @brief Start a timer query, ended by endGpuScope
+     *
+     * @param name
+     */
+    void beginGpuScope(const char* name);
+    void endGpuScope();
+
+    /**
+     * @brief Read the results of all finished frames, waits for the gpu. Call before exporting.
+     */
+    void resolveQueries();
+
+    /**
+     * @brief number of recorded frames in the history
+     */
+    size_t getFrameCount() const noexcept {return std::min<uint64_t>(frameIndex, history.size());}
+
+    /**
+     * @brief recorded frame, 0 is the oldest
+     */
+    const FrameProfile& getFrame(size_t i) const noexcept {return history[(frameIndex - getFrameCount() + i) % history.size()];}
+
+    /**
+     * @brief Write the history as Chrome trace events, cpu scopes on thread 1 and gpu scopes on thread 2.
+     * Open in chrome://tracing or Perfetto.
+     *
+     * @param path
+     * @return true if written
+     */
+    bool writeChromeTrace(const std::string& path) const;
+
+    /**
+     * @brief Write count, mean, min, max and 95th percentile in milliseconds of the frame and every scope name
+     *
+     * @param path
+     * @return true if written
+     */
+    bool writeCsv(const std::string& path) const;
+
+private:
+    // timer queries of one frame
+    struct QueryFrame {
+        uint64_t frame = 0;
+        std::vector<GLuint> queries;
+        size_t used = 0;
+    };
+
+    double now() const noexcept {return std::chrono::duration<double>(std::chrono::steady_clock::now() - epoch).count();}
+
+    void readQueries(QueryFrame& queries);
+
+    bool enabled = true;
+    bool inFrame = false;
+    bool gpuOpen = false;
+    uint64_t frameIndex = 0;
+    const std::chrono::steady_clock::time_point epoch;
+
+    std::vector<FrameProfile> history;
+    std::vector<size_t> openScopes;
+    QueryFrame queryFrames[QueryLatency + 1];
+};
+
+/**
+ * @brief Times the enclosing block as a cpu scope, and as a gpu scope if requested
+ */
+class ProfileScope {
+public:
+    ProfileScope(Profiler& profiler, const char* name, bool gpu = false) : profiler{profiler}, gpu{gpu} {
+        profiler.beginScope(name);
+        if(gpu)
+            profiler.beginGpuScope(name);
+    }
+
+    ~ProfileScope() {
+        if(gpu)
+            profiler.endGpuScope();
+        profiler.endScope();
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Profiler& profiler;
+    const bool gpu;
+};
+
+}
+
+#endif // SSRE_PROFILER_H
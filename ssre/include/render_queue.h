@@ -0,0 +1,173 @@
+/**
+ * @file render_queue.h
+ * @brief sorted draw command list
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_RENDER_QUEUE_H
+#define SSRE_RENDER_QUEUE_H
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include <ssre_gl.h>
+
+namespace ssre {
+
+class Drawable;
+class Material;
+
+enum class RenderPass : uint8_t {
+    Depth = 0,
+    Color = 1
+};
+
+/**
+ * @brief A single draw. Key layout, most significant bits first:
+ *      pass     2 bits
+ *      program 10 bits
+ *      material 20 bits
+ *      vao     16 bits
+ *      depth   16 bits (front to back)
+ */
+struct RenderCommand {
+    uint64_t key;
+    Drawable* drawable;
+    uint32_t object;    // draw object index in drawable
+    uint32_t index;     // drawable index set by setDrawableIndex, used for visibility lookups
+    uint64_t batch;     // commands with equal keys and equal non zero batch are drawn instanced
+};
+
+/**
+ * @brief Per instance data in the instance buffer, read by programs with instance inputs
+ */
+struct InstanceData {
+    glm::mat4 model;
+    GLuint material;
+    GLuint pad[3];
+};
+static_assert(sizeof(InstanceData) == 80, "InstanceData must match the instance buffer layout");
+
+constexpr size_t InstanceModelOffsetBytes = 0;
+constexpr size_t InstanceMaterialOffsetBytes = sizeof(glm::mat4);
+
+/**
+ * @brief A draw call made from one command, from a run of commands with the same batch,
+ * or from consecutive runs with the same program, material and vao drawn with one multi draw
+ */
+struct RenderDraw {
+    const RenderCommand* command;   // first command of the run
+    uint32_t firstInstance;
+    uint32_t instanceCount;         // 0 for commands without a batch
+    uint32_t firstIndirect;         // first command in the indirect buffer
+    uint32_t indirectCount;         // 0 if not drawn indirect
+};
+
+/**
+ * @brief number of state changes needed to submit a command list
+ */
+struct RenderStats {
+    uint32_t draws = 0;
+    uint32_t programChanges = 0;
+    uint32_t materialChanges = 0;
+    uint32_t vaoChanges = 0;
+    uint32_t drawCalls = 0; // draws after instancing, set from the draw list
+
+    RenderStats& operator+=(const RenderStats& o) noexcept {
+        draws += o.draws;
+        drawCalls += o.drawCalls;
+        programChanges += o.programChanges;
+        materialChanges += o.materialChanges;
+        vaoChanges += o.vaoChanges;
+        return *this;
+    }
+};
+
+/**
+ * @brief GL state during submission of a queue, used by drawables to skip redundant binds.
+ * Reset when the program changes.
+ */
+struct DrawState {
+    const Drawable* drawable = nullptr; // drawable with per draw uniforms uploaded
+    const Material* material = nullptr;
+    GLuint vao = 0;
+    GLuint instanceBuffer = 0;  // buffer with InstanceData for instanced draws
+    GLintptr instanceOffset = 0;    // offset in bytes of the frame's instance data in instanceBuffer
+    GLintptr indirectOffset = 0;    // offset in bytes of the frame's commands in the bound draw indirect buffer
+};
+
+class RenderQueue {
+public:
+    /**
+     * @brief Set the view depth mapped to the largest depth key. Commands further away share the last key.
+     *
+     * @param far
+     */
+    void setDepthRange(float far) noexcept {depthScale = far > 0.f ? 1.f / far : 0.f;}
+
+    void clear() noexcept {commands.clear();}
+
+    /**
+     * @brief Set the index recorded in commands pushed after this call
+     *
+     * @param index
+     */
+    void setDrawableIndex(uint32_t index) noexcept {drawableIndex = index;}
+
+    /**
+     * @brief Add a command
+     *
+     * @param pass
+     * @param program program_id of program used
+     * @param material sort id of material, 0 if none
+     * @param vao
+     * @param depth view space distance
+     * @param drawable
+     * @param object passed back to drawable->draw
+     * @param batch non zero to merge with neighbouring commands of equal key and batch into one instanced draw
+     */
+    void push(RenderPass pass, uint32_t program, uint32_t material, GLuint vao, float depth, Drawable* drawable, uint32_t object, uint64_t batch = 0);
+
+    /**
+     * @brief sort commands by key, stable
+     */
+    void sort();
+
+    /**
+     * @brief count program, material and vao changes when submitting commands in their current order
+     *
+     * @param visible if not null, commands with visible[index] == 0 are skipped
+     * @return RenderStats
+     */
+    RenderStats countStateChanges(const uint8_t* visible = nullptr) const noexcept;
+
+    /**
+     * @brief Build draw calls in command order, merging runs of commands with the same key and batch into instanced draws.
+     * Consecutive instanced runs that differ only in batch are merged into one indirect draw if their drawable supports it.
+     *
+     * @param visible if not null, commands with visible[index] == 0 are skipped
+     * @param instances instance data of instanced draws is appended
+     * @param indirect multi draw commands of indirect draws are appended
+     * @param draws draw calls are appended
+     */
+    void buildDraws(const uint8_t* visible, std::vector<InstanceData>& instances, std::vector<gl::DrawElementsIndirectCommand>& indirect, std::vector<RenderDraw>& draws) const;
+
+    const std::vector<RenderCommand>& getCommands() const noexcept {return commands;}
+
+    size_t size() const noexcept {return commands.size();}
+
+private:
+    std::vector<RenderCommand> commands;
+    std::vector<RenderCommand> scratch;
+
+    float depthScale = 0.f;
+    uint32_t drawableIndex = 0;
+};
+
+}
+
+#endif // SSRE_RENDER_QUEUE_H
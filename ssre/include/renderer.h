@@ -20,12 +20,18 @@
 
 #include <ssre_gl.h>
 #include <viewport.h>
+#include <render_queue.h>
+#include <bounds.h>
+#include <frustum.h>
+#include <shadow.h>
+#include <clusters.h>
+#include <profiler.h>
 
 namespace ssre {
 
 class Program;
 class Buffer;
-class Texture3D;
+class StreamBuffer;
 
 /**
  * @brief Render Info. Has information about currently active program.
@@ -42,6 +48,84 @@ public:
     virtual void drawDepth() = 0;
     virtual const std::shared_ptr<Program>& getColorProgram() const noexcept = 0;
     virtual const std::shared_ptr<Program>& getDepthProgram() const noexcept = 0;
+
+    /**
+     * @brief Add draw commands for pass to queue. Default adds a single command drawing everything with drawColor or drawDepth.
+     * 
+     * @param queue 
+     * @param pass 
+     * @param viewMatrix used for depth sorting
+     */
+    virtual void enqueue(RenderQueue& queue, RenderPass pass, const glm::mat4& viewMatrix);
+
+    /**
+     * @brief Draw a command added by enqueue. The pass program is active.
+     * 
+     * @param pass 
+     * @param object 
+     * @param state binds made by previous commands since the program was activated
+     */
+    virtual void draw(RenderPass pass, uint32_t object, DrawState& state);
+
+    /**
+     * @brief Write instance data for a command pushed with a batch
+     * 
+     * @param object 
+     * @param out 
+     */
+    virtual void writeInstance(uint32_t object, InstanceData& out) const;
+
+    /**
+     * @brief Draw instances of a batched command. Default is not an instanced draw: it calls draw once per instance,
+     * ignores the instance buffer and firstInstance, so every copy uses this drawable's transform. Drawables pushing batched commands override it.
+     * 
+     * @param pass 
+     * @param object 
+     * @param firstInstance first instance in the instance buffer
+     * @param instanceCount 
+     * @param state 
+     */
+    virtual void drawInstanced(RenderPass pass, uint32_t object, uint32_t firstInstance, uint32_t instanceCount, DrawState& state);
+
+    /**
+     * @brief Multi draw parameters for a batched command. Default returns false, the command is drawn with drawInstanced.
+     * Batches of drawables returning true are merged with following batches of equal key above the depth bits.
+     * 
+     * @param object 
+     * @param out count, firstIndex and baseVertex, the queue sets the instance fields
+     * @return true if the command can be drawn with drawIndirect
+     */
+    virtual bool writeIndirect(uint32_t object, gl::DrawElementsIndirectCommand& out) const;
+
+    /**
+     * @brief Draw commands [firstIndirect, firstIndirect + indirectCount) of the bound draw indirect buffer
+     * with one multi draw. object is the object of the first command.
+     * 
+     * @param pass 
+     * @param object 
+     * @param firstIndirect 
+     * @param indirectCount 
+     * @param state 
+     */
+    virtual void drawIndirect(RenderPass pass, uint32_t object, uint32_t firstIndirect, uint32_t indirectCount, DrawState& state);
+
+    /**
+     * @brief World space bounds for culling. Default has no bounds and is never culled.
+     * 
+     * @param sphere 
+     * @return true if sphere was set
+     */
+    virtual bool getWorldBounds(BoundingSphere& sphere) const;
+};
+
+/**
+ * @brief Frustum culling results of a frame. Shadow counts are per drawable and light drawn this frame, cached lights are not counted.
+ */
+struct CullStats {
+    uint32_t cameraVisible = 0;
+    uint32_t cameraCulled = 0;
+    uint32_t shadowVisible = 0;
+    uint32_t shadowCulled = 0;
 };
 
 class Scene;
@@ -50,6 +134,8 @@ class Renderer {
 public:
     static constexpr uint32_t DepthMapWidth = 512, DepthMapHeight = 512;
     static constexpr float DepthMapNear = 0.1f, DepthMapFar = 25.f;
+    static constexpr uint32_t ShadowAtlasSize = 4096, ShadowTileMin = 64; // DepthMapWidth is the largest shadow tile
+    static constexpr double TextureUploadBudget = 0.002; // seconds per frame spent uploading streamed textures
 
     Renderer();
     ~Renderer();
@@ -62,10 +148,38 @@ public:
 
     void setViewPortSize(uint32_t w, uint32_t h) noexcept {width = w; height = h;}
 
+    /**
+     * @brief Set the framebuffer the color pass draws to, 0 is the window. Window::SetRenderer sets the window's framebuffer.
+     * 
+     * @param fbo 
+     */
+    void setTargetFramebuffer(GLuint fbo) noexcept {targetFramebuffer = fbo;}
+    GLuint getTargetFramebuffer() const noexcept {return targetFramebuffer;}
+
     void setScene(const std::shared_ptr<Scene>& s) {scene = s;}
 
     void render(float delta);
 
+    /**
+     * @brief Draw state changes of the last frame, in scene order and after sorting
+     */
+    const RenderStats& getUnsortedStats() const noexcept {return unsortedStats;}
+    const RenderStats& getSortedStats() const noexcept {return sortedStats;}
+
+    const CullStats& getCullStats() const noexcept {return cullStats;}
+
+    const ShadowStats& getShadowStats() const noexcept {return shadows->getStats();}
+
+    /**
+     * @brief cpu and gpu timings of the last frames
+     */
+    Profiler& getProfiler() noexcept {return profiler;}
+
+    /**
+     * @brief light lists of the last frame
+     */
+    const LightClusters& getLightClusters() const noexcept {return clusters;}
+
 private:
     double lastDrawTime = 0.;
 
@@ -75,16 +189,46 @@ private:
     glm::mat4 projectionMatrix{1.f};
 
     uint32_t width, height;
+    GLuint targetFramebuffer = 0;
 
-    std::shared_ptr<Buffer> globalUBO;
+    // global uniform block, written once per frame
+    std::unique_ptr<StreamBuffer> globalUBO;
     uint32_t nextUBOLocation = 1;
 
     // scene to render
     std::shared_ptr<Scene> scene;
 
-    std::vector<GLuint> lightDepthFbs;
-    std::vector<std::unique_ptr<Texture3D>> depthTexs;
-    std::vector<glm::mat4> lightMatrices;
+    // draw commands, rebuilt every frame
+    RenderQueue depthQueue;
+    RenderQueue colorQueue;
+
+    RenderStats unsortedStats;
+    RenderStats sortedStats;
+
+    // visibility of scene drawables, indexed as Scene::getDrawables
+    std::vector<uint8_t> cameraVisible;
+    CullStats cullStats;
+
+    // per frame instance data and draw lists, depth draws of light i are [lightDrawOffsets[i], lightDrawOffsets[i + 1])
+    std::unique_ptr<StreamBuffer> instanceBuffer;
+    std::vector<InstanceData> instances;
+    std::unique_ptr<StreamBuffer> indirectBuffer;
+    std::vector<gl::DrawElementsIndirectCommand> indirect;
+    std::vector<RenderDraw> colorDraws;
+    std::vector<RenderDraw> depthDraws;
+    std::vector<size_t> lightDrawOffsets;
+
+    // shadow maps of all lights and their records for color programs
+    std::unique_ptr<StreamBuffer> shadowBuffer;
+    std::unique_ptr<ShadowMaps> shadows;
+
+    // scene lights and their cluster lists, written to one storage buffer range per frame
+    std::vector<ClusterLight> lights;
+    std::vector<glm::vec4> lightSpheres;
+    LightClusters clusters;
+    std::unique_ptr<StreamBuffer> clusterBuffer;
+
+    Profiler profiler;
 };
 
 }
@@ -20,10 +20,21 @@
 
 namespace ssre {
 
+namespace util {
+class ThreadPool;
+}
+
 class Texture;
+class Texture2D;
+enum class TextureCompression;
+enum class TextureUsage;
 class Geometry;
+enum class VertexFormat;
 class Program;
 class Mesh;
+class GeometryArena;
+class MaterialTable;
+class TextureStreamer;
 
 class Resource : public util::Singleton<Resource> {
 public:
@@ -43,15 +54,48 @@ public:
      * @brief Load a 2D texture. If texture with name already exists, that texture will be returned
      * 
      * @param path 
-     * @param name 
+     * @param usage selects the format when textures are compressed
      * @return std::shared_ptr<Texture> 
      */
+    std::shared_ptr<Texture> load2DTexture(const std::string& path, TextureUsage usage);
     std::shared_ptr<Texture> load2DTexture(const std::string& path);
 
+    /**
+     * @brief Load a 2D texture on the worker threads. The returned texture shows a placeholder until
+     * the texture streamer uploaded its data. If texture with name already exists, that texture will be returned
+     * 
+     * @param path 
+     * @param usage selects the format when textures are compressed
+     * @return std::shared_ptr<Texture> 
+     */
+    std::shared_ptr<Texture> load2DTextureAsync(const std::string& path, TextureUsage usage);
+    std::shared_ptr<Texture> load2DTextureAsync(const std::string& path);
+
+    /**
+     * @brief Set the block compression of 2D textures loaded after the call. Compressed textures are read from
+     * a .sstex cache file next to the source image. A missing or stale cache is baked on load and written.
+     * Falls back to uncompressed textures if the context does not support the formats.
+     * 
+     * @param compression 
+     */
+    void setTextureCompression(TextureCompression compression);
+    TextureCompression getTextureCompression() const noexcept {return textureCompression;}
+
+    /**
+     * @brief Offline baker, writes the texture cache of every image below the asset path in parallel.
+     * Files with "normal" in their name are baked as normal maps. Does not need a GL context.
+     * 
+     * @param compression 
+     * @param directory relative to the asset path
+     * @return size_t number of images baked
+     */
+    size_t bakeTextures(TextureCompression compression, const std::string& directory = "");
+
     std::shared_ptr<Texture> loadCubeTexture(const std::string& path);
 
     /**
-     * @brief base dir should be terminated in /, path should be file in baseDir
+     * @brief base dir should be terminated in /, path should be file in baseDir. The file is parsed
+     * and tangent frames are built on the resource worker threads.
      * 
      * @param path 
      * @param baseDir 
@@ -61,18 +105,100 @@ public:
 
     const std::string& getAssetPath() const noexcept {return assetPath;}
 
+    /**
+     * @brief Set the grid size used to weld vertices of loaded obj files. 0 merges only identical vertices.
+     * Affects geometry loaded after the call.
+     * 
+     * @param epsilon 
+     */
+    void setWeldEpsilon(float epsilon) noexcept {weldEpsilon = epsilon;}
+    float getWeldEpsilon() const noexcept {return weldEpsilon;}
+
+    /**
+     * @brief Enable reordering of triangles and vertices of loaded obj files for vertex cache and fetch locality.
+     * Affects geometry loaded after the call.
+     * 
+     * @param optimize 
+     */
+    void setOptimizeMeshes(bool optimize) noexcept {optimizeMeshes = optimize;}
+    bool getOptimizeMeshes() const noexcept {return optimizeMeshes;}
+
+    /**
+     * @brief Set the vertex buffer layout of loaded obj geometry. Affects geometry loaded after the call.
+     * 
+     * @param format 
+     */
+    void setVertexFormat(VertexFormat format) noexcept {vertexFormat = format;}
+    VertexFormat getVertexFormat() const noexcept {return vertexFormat;}
+
+    /**
+     * @brief storage of the vertex and index data of all Geometry
+     * 
+     * @return GeometryArena& 
+     */
+    GeometryArena& getGeometryArena() noexcept {return *geometryArena;}
+
+    /**
+     * @brief texture arrays and records of materials drawn with programs using the material table
+     * 
+     * @return MaterialTable& 
+     */
+    MaterialTable& getMaterialTable() noexcept {return *materialTable;}
+
+    /**
+     * @brief worker threads shared by asset import and per frame work
+     * 
+     * @return util::ThreadPool& 
+     */
+    util::ThreadPool& getWorkers() noexcept {return *workers;}
+
+    /**
+     * @brief uploads textures requested with load2DTextureAsync, updated by the renderer every frame
+     * 
+     * @return TextureStreamer& 
+     */
+    TextureStreamer& getTextureStreamer() noexcept {return *textureStreamer;}
+
 private:
     friend util::Singleton<Resource>;
 
     Resource(std::string assetPath);
     ~Resource();
 
+    /**
+     * @brief key for the current import settings, stored in mesh caches
+     */
+    uint64_t importKey() const noexcept;
+
+    /**
+     * @brief load path from its texture cache, null if it cannot be read or baked
+     */
+    std::shared_ptr<Texture2D> loadCompressed2DTexture(const std::string& path, TextureUsage usage);
+
+    // declared first so geometry can release its data while the resource is destroyed
+    std::unique_ptr<GeometryArena> geometryArena;
+
+    std::unique_ptr<MaterialTable> materialTable;
+
     // textures by name
     std::unordered_map<std::string, std::shared_ptr<Texture>> textures;
 
     // geometry by path
     std::unordered_map<std::string, std::shared_ptr<Geometry>> geometries;
 
+    // workers for asset import and per frame work
+    std::unique_ptr<util::ThreadPool> workers;
+
+    // declared after workers so it is destroyed while they still run its decodes
+    std::unique_ptr<TextureStreamer> textureStreamer;
+
+    TextureCompression textureCompression;
+
+    // obj import settings
+    float weldEpsilon = 0.f;
+    bool optimizeMeshes = true;
+    VertexFormat vertexFormat;
+
     /**
      * @brief root path of assets 
      */
@@ -19,8 +19,15 @@
 
 #include <glm/glm.hpp>
 
+#include <transform_hierarchy.h>
+#include <bvh.h>
+
 namespace ssre {
 
+/**
+ * @brief Scene graph node. Once added to a Scene, the node is a handle to an entry in the
+ * scene TransformHierarchy. Before that, the transform is stored in the node.
+ */
 class Node {
 public:
     explicit Node(std::string name) noexcept;
@@ -39,17 +46,21 @@ public:
      * 
      * @param position 
      */
-    void setPosition(const glm::vec3& position) noexcept {this->position = position;}
-    glm::vec3 getPosition() const noexcept {return position;}
+    void setPosition(const glm::vec3& position) noexcept {editLocal().position = position;}
+    glm::vec3 getPosition() const noexcept {return local().position;}
 
-    void setScale(const glm::vec3& s) noexcept {scale = s;}
+    void setScale(const glm::vec3& s) noexcept {editLocal().scale = s;}
+    glm::vec3 getScale() const noexcept {return local().scale;}
 
     /**
      * @brief Set the offset of the local system, applied before rotation
      * 
      * @param origin 
      */
-    void setOrigin(const glm::vec3& origin) noexcept {offset = -origin;}
+    void setOrigin(const glm::vec3& origin) noexcept {editLocal().offset = -origin;}
+
+    void setRotation(const glm::mat4& r) noexcept {editLocal().rotation = r;}
+    const glm::mat4& getRotation() const noexcept {return local().rotation;}
 
     /**
      * @brief Rotate Node about local axis
@@ -66,37 +77,36 @@ public:
      */
     virtual void update(float delta);
 
-    const glm::mat4& getModelMatrix() const noexcept {return model_matrix;}
+    const glm::mat4& getModelMatrix() const noexcept {return hierarchy ? hierarchy->world(transformIndex) : model_matrix;}
 
-protected:
-
-    const std::string name;
+    /**
+     * @brief Get the Normal Matrix, transpose(inverse(M)) of the model matrix. Cached, updated with the model matrix.
+     * 
+     * @return const glm::mat3& 
+     */
+    const glm::mat3& getNormalMatrix() const noexcept {return hierarchy ? hierarchy->normal(transformIndex) : normal_matrix;}
 
-    glm::vec3 position{};
-    glm::vec3 offset{};
-    glm::vec3 scale{1.f};
+    const std::string& getName() const noexcept {return name;}
 
-    glm::mat4 rotation{1.f};
+protected:
 
-    std::vector<std::shared_ptr<Node>> children;
+    const std::string name;
 
 private:
     friend class Scene;
-    glm::mat4 model_matrix{1.f};
 
-    // parent pointer managed by Scene
-    std::weak_ptr<Node> parent;
+    // local transform for modification, marks the scene entry dirty
+    LocalTransform& editLocal() noexcept {return hierarchy ? hierarchy->edit(transformIndex) : detached;}
+    const LocalTransform& local() const noexcept {return hierarchy ? hierarchy->local(transformIndex) : detached;}
 
-    /**
-     * @brief Add child to list
-     * @param parent 
-     */
-    void addChild(const std::shared_ptr<Node>& node) noexcept;
+    // transform storage while not in a scene
+    LocalTransform detached;
+    glm::mat4 model_matrix{1.f};
+    glm::mat3 normal_matrix{1.f};
 
-    /**
-     * @brief pre render operation, update children with current transform information
-     */
-    void pre_render(const glm::mat4& parentModelMatrix);
+    // scene transform entry, managed by Scene
+    TransformHierarchy* hierarchy = nullptr;
+    uint32_t transformIndex = 0;
 };
 
 class Mesh;
@@ -115,11 +125,19 @@ public:
     void setActive(bool on) noexcept {active = on;}
     bool isAcitve() const noexcept {return active;}
 
+    /**
+     * @brief Set the distance where the light's contribution ends, used to bin the light into clusters
+     * 
+     * @param r 
+     */
+    void setRange(float r) noexcept {range = r;}
+    float getRange() const noexcept {return range;}
+
     glm::vec3 pos{};
     float w = 0;
     void update(float delta) override {
         if(pos == glm::vec3{0, 0, 0})
-            pos = position;
+            pos = getPosition();
         w += delta;
         setPosition(pos + glm::vec3{1.f, 0, 0} * (float)sin(w));
     }
@@ -127,14 +145,17 @@ public:
 protected:
     glm::vec3 radiantIntensity{1.f}; // watts per seradian
     bool active = true;
+    float range = 25.f;
 };
 
 class SkySphere;
+class Drawable;
+class Frustum;
 
 class Scene {
 public:
     Scene(std::shared_ptr<Node> root);
-    ~Scene() = default;
+    ~Scene();
 
     Scene& operator=(const Scene&) = delete;
     Scene& operator=(Scene&&) = delete;
@@ -146,7 +167,7 @@ public:
 
     void update(float delta);
 
-    void setRootNode(const std::shared_ptr<Node>& root) {rootNode = root; addNodeToList(root);}
+    void setRootNode(const std::shared_ptr<Node>& root) {rootNode = root; addNodeToList(root, TransformHierarchy::NoParent);}
     const std::shared_ptr<Node>& getRoot() const noexcept {return rootNode;}
 
     void setCamera(const std::shared_ptr<Camera>& cam);
@@ -159,21 +180,107 @@ public:
      * @brief Add a new node
      * 
      * @param node 
+     * @param parent must already be in the scene, root if null
      * @return true 
-     * @return false node with name already exists
+     * @return false node with name already exists or parent is not in this scene
      */
     bool addNode(const std::shared_ptr<Node>& node, const std::shared_ptr<Node>& parent = nullptr);
 
+    /**
+     * @brief Remove a node and all of its descendants. The root cannot be removed.
+     * 
+     * @param node 
+     * @return true 
+     * @return false node is not in this scene
+     */
+    bool removeNode(const std::shared_ptr<Node>& node);
+
     const std::unordered_map<std::string, std::shared_ptr<Node>>& getNodes() const {return nodes;}
 
+    /**
+     * @brief Drawable nodes in the scene, in the order they were added
+     */
+    const std::vector<Drawable*>& getDrawables() const noexcept {return drawables;}
+
+    /**
+     * @brief Light nodes in the scene, in the order they were added
+     */
+    const std::vector<PointLight*>& getLights() const noexcept {return lights;}
+
+    const TransformHierarchy& getTransforms() const noexcept {return transforms;}
+
+    /**
+     * @brief Bounds of drawables with world bounds, refit in pre_render. User data is the index in getDrawables().
+     */
+    const DynamicBVH& getSpatialIndex() const noexcept {return spatial;}
+
+    /**
+     * @brief Find drawables intersecting a frustum. Drawables without bounds are always visible.
+     * 
+     * @param frustum 
+     * @param visible set to 1 for visible drawables and 0 for others, getDrawables().size() entries
+     * @return uint32_t number of visible drawables
+     */
+    uint32_t cull(const Frustum& frustum, uint8_t* visible);
+
+    /**
+     * @brief Find drawables intersecting a sphere. Drawables without bounds are always visible.
+     * 
+     * @param sphere 
+     * @param visible set to 1 for visible drawables and 0 for others, getDrawables().size() entries
+     * @return uint32_t number of visible drawables
+     */
+    uint32_t cull(const BoundingSphere& sphere, uint8_t* visible);
+
+    /**
+     * @brief Drawables that moved or were added since the last pre_render, indices in getDrawables()
+     */
+    const std::vector<uint32_t>& getChangedDrawables() const noexcept {return changedDrawables;}
+
+    /**
+     * @brief Incremented when drawables are removed and indices in getDrawables() change
+     */
+    uint32_t getDrawablesVersion() const noexcept {return drawablesVersion;}
+
 protected:
+    // declared before nodes, nodes are released first
+    TransformHierarchy transforms;
+
     std::unordered_map<std::string, std::shared_ptr<Node>> nodes;
     std::shared_ptr<Node> rootNode;
     std::weak_ptr<Camera> camera;
 
     std::shared_ptr<SkySphere> sky;
 
-    bool addNodeToList(const std::shared_ptr<Node>& node);
+    // render queues, nodes are owned by the node map
+    std::vector<Drawable*> drawables;
+    std::vector<PointLight*> lights;
+
+    static constexpr uint32_t NoDrawable = std::numeric_limits<uint32_t>::max();
+
+    // spatial index proxy of each drawable, DynamicBVH::Null if the drawable has no bounds
+    DynamicBVH spatial;
+    std::vector<int32_t> drawableProxies;
+    // drawable index of each transform entry or NoDrawable
+    std::vector<uint32_t> transformDrawables;
+    std::vector<uint32_t> queryResult;
+
+    // drawables changed in the last pre_render, added drawables are reported by the next pre_render
+    std::vector<uint32_t> changedDrawables;
+    std::vector<uint32_t> addedDrawables;
+    uint32_t drawablesVersion = 0;
+
+    /**
+     * @brief insert, move or remove the spatial index proxy of a drawable
+     */
+    void updateBounds(uint32_t drawable);
+
+    bool addNodeToList(const std::shared_ptr<Node>& node, uint32_t parentIndex);
+
+    /**
+     * @brief Copy a node's transform out of the scene storage
+     */
+    void detachNode(Node* node);
 };
 
 }
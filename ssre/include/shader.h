@@ -16,6 +16,7 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <cstring>
 
 #include <ssre.h>
 #include <ssre_gl.h>
@@ -39,6 +40,15 @@ constexpr GLenum BiNormalAttributeType = GL_FLOAT_VEC3;
 constexpr const char* TangentAttributeName = "Tangent";
 constexpr GLenum TangentAttributeType = GL_FLOAT_VEC3;
 
+/**
+ * @brief per instance inputs. Programs with an InstanceM input are drawn instanced, M is not used.
+ */
+constexpr const char* InstanceModelAttributeName = "InstanceM";
+constexpr GLenum InstanceModelAttributeType = GL_FLOAT_MAT4;
+constexpr const char* InstanceMaterialAttributeName = "InstanceMaterial";
+constexpr GLenum InstanceMaterialAttributeType = GL_UNSIGNED_INT;
+constexpr GLuint InstanceBufferBinding = 15; // vertex buffer binding index of the instance buffer
+
 
 constexpr const char* ModelMatrixUniformName = "M";
 constexpr const char* NormalMatrixUniformName = "G";
@@ -62,6 +72,45 @@ constexpr uint32_t GUBSize = 464;
 constexpr uint32_t ShaderUniformBlockBindingLocation = 1; // each shader binds its block UBO to location 1 before drawing
 constexpr const char* ShaderUniformBlockName = "ShaderData";
 
+/**
+ * @brief material parameters. Programs with a MaterialData block read the parameters of the current material from it,
+ * every material has a range of one buffer per program and applying a material binds its range.
+ */
+constexpr uint32_t MaterialUniformBlockBindingLocation = 2;
+constexpr const char* MaterialUniformBlockName = "MaterialData";
+
+/**
+ * @brief point light shadows. Cube faces of all lights are tiles of one depth atlas.
+ * Depth programs get the face matrices of one light in ShaderData and write faces in the face mask to gl_ViewportIndex = face.
+ * Color programs read the ShadowRecord of light i from the shadow buffer.
+ */
+constexpr const char* ShadowFaceMatricesName = "SM[0]";
+constexpr const char* ShadowFaceMaskName = "shadowFaces";   // uint, bit i set if face i is drawn
+constexpr const char* ShadowMapSamplerName = "lightShadowAtlas"; // sampler2D of color programs
+constexpr uint32_t ShadowMapTextureUnit = 10;
+constexpr uint32_t ShadowBufferBinding = 2; // shader storage binding of the ShadowRecord array
+
+/**
+ * @brief clustered lights. Color programs look up the light list of their cluster and shade every light in it,
+ * see ClusterHeader for the lookup. Light i of the light buffer has ShadowRecord i.
+ */
+constexpr uint32_t ClusterBufferBinding = 3;    // shader storage binding of the ClusterHeader followed by uvec2 clusters[]
+constexpr uint32_t ClusterLightIndexBinding = 4; // shader storage binding of uint lightIndices[]
+constexpr uint32_t LightBufferBinding = 5;      // shader storage binding of the ClusterLight array
+
+/**
+ * @brief material table. Color programs with a MaterialBuffer storage block sample material textures from texture arrays,
+ * see MaterialRecord for the lookup, and get no per material texture binds. The material index is the MaterialIndex uniform,
+ * or the InstanceMaterial input of instanced programs. Sampler arrays may only be indexed with dynamically uniform
+ * expressions, programs select the array with a switch.
+ */
+constexpr const char* MaterialBufferName = "MaterialBuffer";
+constexpr uint32_t MaterialBufferBinding = 6;   // shader storage binding of the MaterialRecord array
+constexpr const char* MaterialIndexUniformName = "MaterialIndex";
+constexpr const char* MaterialArraySamplerName = "materialArrays[0]";   // sampler2DArray materialArrays[MaterialArrayCount]
+constexpr uint32_t MaterialArrayFirstUnit = 16;
+constexpr uint32_t MaterialArrayCount = 16;
+
 } // mat_spec
 
 /**
@@ -112,10 +161,44 @@ private:
     bool compiled = false;
 };
 
-class Buffer;
+class StreamBuffer;
 struct MaterialInfo;
 class Material;
 
+/**
+ * @brief Interned uniform name. Names are registered once and get a small id, programs resolve every registered
+ * handle to a uniform location and ShaderData layout when they are built, so draw code looks up ids instead of hashing strings.
+ * Create handles once, e.g. as static constants, not per draw.
+ */
+class UniformHandle {
+public:
+    explicit UniformHandle(const std::string& name);
+
+    uint32_t id() const noexcept {return index;}
+    std::string name() const;
+
+    /**
+     * @brief number of registered names
+     */
+    static uint32_t count();
+
+    /**
+     * @brief name registered with id
+     */
+    static std::string nameOf(uint32_t id);
+
+private:
+    uint32_t index;
+};
+
+namespace mat_spec {
+
+// handles of the standard uniforms
+extern const UniformHandle ModelMatrixUniform;
+extern const UniformHandle NormalMatrixUniform;
+
+} // mat_spec
+
 struct ProgramUniformDescription {
     GLint Location = -1;
     GLenum Type = 0;
@@ -135,17 +218,18 @@ struct ProgramUniformBlockDescription {
         GLint Offset = 0;       // offset in bytes from beginning of buffer
         GLint ArraySize = 0;    // number of array elements
         GLint ArrayStride = 0;  // stride in bytes between array elements
+        GLenum Type = 0;        // uniform type
     };
     std::unordered_map<std::string, Layout> layouts;
 
-    Layout getLayout(const std::string& name) {
+    Layout getLayout(const std::string& name) const {
         auto itr = layouts.find(name);
         if(itr != layouts.end())
             return itr->second;
         return {-1, -1, -1};
     }
 
-    GLint getOffset(const std::string& name) {
+    GLint getOffset(const std::string& name) const {
         auto itr = layouts.find(name);
         if(itr != layouts.end())
             return itr->second.Offset;
@@ -228,6 +312,19 @@ public:
         return {-1, 0};
     }
 
+    /**
+     * @brief Get the location of a uniform without a string lookup. Handles registered after the program was
+     * built are resolved on first use.
+     * 
+     * @param handle 
+     * @return GLint -1 if the uniform does not exist
+     */
+    GLint getUniformLocation(UniformHandle handle) const {
+        if(handle.id() >= handleLocations.size())
+            resolveHandles();
+        return handleLocations[handle.id()];
+    }
+
     /**
      * @brief Get the Input description for given name
      * 
@@ -254,6 +351,14 @@ public:
         return {};
     }
 
+    /**
+     * @brief Get the description of a material parameter, a member of the MaterialData block or a uniform
+     * 
+     * @param paramName 
+     * @return ProgramUniformDescription Location is -1 for block members, zero initialized if it does not exist
+     */
+    ProgramUniformDescription getMaterialParameterInfo(const std::string& paramName) const;
+
     GLuint getHandle() const noexcept {return gl_reference;}
 
     /**
@@ -280,7 +385,8 @@ public:
     bool setUniformBlockBinding(const std::string& uniformName, uint32_t location);
 
     /**
-     * @brief Set the Shader Parameter. Value stored in this shader's data buffer
+     * @brief Set the Shader Parameter. Value stored in this shader's data block, which is copied to the
+     * shader's stream buffer on the next call to use
      * 
      * @return true parameter was updated
      * @return false parameter does not exist
@@ -291,11 +397,35 @@ public:
     template<typename T>
     bool setShaderParameter(const std::string& paramName, const std::vector<T>& data);
 
+    template<typename T>
+    bool setShaderParameter(UniformHandle param, const T& data);
+
+    template<typename T>
+    bool setShaderParameter(UniformHandle param, const std::vector<T>& data);
+
     GLint getVertexInputLocation() const noexcept {return vertexInputLocation;}
     GLint getTangentInputLocation() const noexcept {return tangentInputLocation;}
     GLint getBitangentInputLocation() const noexcept {return bitangentInputLocation;}
     GLint getTexChoordInputLocation() const noexcept {return texChoordInputLocation;}
 
+    GLint getInstanceModelInputLocation() const noexcept {return instanceModelInputLocation;}
+    GLint getInstanceMaterialInputLocation() const noexcept {return instanceMaterialInputLocation;}
+
+    /**
+     * @brief true if the program reads model matrices from the instance buffer
+     */
+    bool isInstanced() const noexcept {return instanceModelInputLocation != -1;}
+
+    /**
+     * @brief true if the program reads material textures through the material table
+     */
+    bool usesMaterialTable() const noexcept {return materialBufferIndex != GL_INVALID_INDEX;}
+
+    /**
+     * @brief true if the program reads material parameters from the MaterialData block
+     */
+    bool usesMaterialBlock() const noexcept {return materialDataDescription.Location != -1;}
+
 protected:
 
     std::unordered_map<gl::GLSLShaderType, std::string> attachedShaders;
@@ -303,15 +433,40 @@ protected:
     std::unordered_map<std::string, ProgramInputDescription> inputs;
     std::unordered_map<std::string, ProgramUniformBlockDescription> uniformBlocks;
 
-    // shader ubo, contains shader parameters
+    // shader ubo, contains shader parameters. Parameters are set in shaderData and copied to a new range of shaderUBO when the program is used after a change
     ProgramUniformBlockDescription shaderDataDescription;
-    std::unique_ptr<Buffer> shaderUBO;
+    std::unique_ptr<StreamBuffer> shaderUBO;
+    std::vector<uint8_t> shaderData;
+    mutable bool shaderDataChanged = false;
+    mutable std::size_t shaderDataOffset = 0;
 
     // inputs
     GLint vertexInputLocation = -1;
     GLint bitangentInputLocation = -1;
     GLint tangentInputLocation = -1;
     GLint texChoordInputLocation = -1;
+    GLint instanceModelInputLocation = -1;
+    GLint instanceMaterialInputLocation = -1;
+
+    // material table
+    GLuint materialBufferIndex = GL_INVALID_INDEX;
+    GLint materialIndexLocation = -1;
+
+    // material parameter blocks. Each material applied to the program gets a slot of materialStride bytes in materialUBO,
+    // packed when the material is first applied and again when its parameter revision changes
+    struct MaterialSlot {
+        uint32_t index;
+        uint32_t revision;
+    };
+    ProgramUniformBlockDescription materialDataDescription;
+    std::unique_ptr<Buffer> materialUBO;
+    mutable std::vector<uint8_t> materialData;
+    mutable std::unordered_map<uint32_t, MaterialSlot> materialSlots;  // material id to slot
+    std::size_t materialStride = 0;
+
+    // uniform locations and ShaderData layouts indexed by UniformHandle id, rebuilt whenever modifiedCount changes
+    mutable std::vector<GLint> handleLocations;
+    mutable std::vector<ProgramUniformBlockDescription::Layout> handleLayouts;
 
     /**
      * @brief unique program id counter
@@ -331,6 +486,18 @@ protected:
 
     void updateProgramUniformBlockInfo();
 
+    // offset of the material's parameter block in materialUBO, packed and uploaded if it changed
+    std::size_t materialBlockOffset(const Material& material) const;
+
+    // resolve handles registered since the tables were filled
+    void resolveHandles() const;
+
+    const ProgramUniformBlockDescription::Layout& getShaderParameterLayout(UniformHandle param) const {
+        if(param.id() >= handleLayouts.size())
+            resolveHandles();
+        return handleLayouts[param.id()];
+    }
+
     /**
      * @brief Allows base classes to configure additional shader options after program builds
      * 
@@ -346,8 +513,9 @@ template<typename T>
 bool Program::setShaderParameter(const std::string& paramName, const T& data) {
     if(shaderDataDescription.Location != -1) {
         GLint uoff = shaderDataDescription.getOffset(paramName);
-        if(uoff != -1) {
-            shaderUBO->SubData(data, uoff);
+        if(uoff != -1 && uoff + sizeof(T) <= shaderData.size()) {
+            std::memcpy(shaderData.data() + uoff, &data, sizeof(T));
+            shaderDataChanged = true;
             return true;
         }
     }
@@ -361,8 +529,10 @@ bool Program::setShaderParameter(const std::string& paramName, const std::vector
         ProgramUniformBlockDescription::Layout layout = shaderDataDescription.getLayout(paramName);
         GLint uoff = layout.Offset;
         GLint stride = layout.ArrayStride;
-        if(uoff != -1 && layout.ArraySize >= data.size()) {
-            shaderUBO->SubData(data, uoff, stride);
+        if(uoff != -1 && layout.ArraySize >= 0 && static_cast<size_t>(layout.ArraySize) >= data.size() && (data.empty() || uoff + (data.size() - 1) * stride + sizeof(T) <= shaderData.size())) {
+            for(size_t i = 0; i < data.size(); i++)
+                std::memcpy(shaderData.data() + uoff + i * stride, &data[i], sizeof(T));
+            shaderDataChanged = true;
             return true;
         }
     }
@@ -370,6 +540,37 @@ bool Program::setShaderParameter(const std::string& paramName, const std::vector
     return false;
 }
 
+template<typename T>
+bool Program::setShaderParameter(UniformHandle param, const T& data) {
+    if(shaderDataDescription.Location != -1) {
+        GLint uoff = getShaderParameterLayout(param).Offset;
+        if(uoff != -1 && uoff + sizeof(T) <= shaderData.size()) {
+            std::memcpy(shaderData.data() + uoff, &data, sizeof(T));
+            shaderDataChanged = true;
+            return true;
+        }
+    }
+    std::cerr << "Failed to set shader parameter " << param.name() << " for " << ProgramName << std::endl;
+    return false;
+}
+
+template<typename T>
+bool Program::setShaderParameter(UniformHandle param, const std::vector<T>& data) {
+    if(shaderDataDescription.Location != -1) {
+        const ProgramUniformBlockDescription::Layout& layout = getShaderParameterLayout(param);
+        GLint uoff = layout.Offset;
+        GLint stride = layout.ArrayStride;
+        if(uoff != -1 && layout.ArraySize >= 0 && static_cast<size_t>(layout.ArraySize) >= data.size() && (data.empty() || uoff + (data.size() - 1) * stride + sizeof(T) <= shaderData.size())) {
+            for(size_t i = 0; i < data.size(); i++)
+                std::memcpy(shaderData.data() + uoff + i * stride, &data[i], sizeof(T));
+            shaderDataChanged = true;
+            return true;
+        }
+    }
+    std::cerr << "Failed to set shader parameter " << param.name() << " for " << ProgramName << std::endl;
+    return false;
+}
+
 } // ssre
 
 #endif // SSRE_SHADER_H
\ No newline at end of file
@@ -0,0 +1,246 @@
+/**
+ * @file shadow.h
+ * @brief cached point light shadow maps
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_SHADOW_H
+#define SSRE_SHADOW_H
+
+#include <memory>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include <ssre_gl.h>
+#include <frustum.h>
+
+namespace ssre {
+
+class Scene;
+class PointLight;
+class Texture2D;
+
+/**
+ * @brief Square power of two tiles in a square atlas. Larger tiles are split in four to make smaller ones,
+ * and four free quarters are merged back into their parent.
+ */
+class AtlasAllocator {
+public:
+    struct Tile {
+        uint32_t x = 0, y = 0;
+        uint32_t size = 0;  // 0 if allocation failed
+
+        bool valid() const noexcept {return size != 0;}
+    };
+
+    /**
+     * @brief Create an allocator with the whole atlas free
+     *
+     * @param size atlas width and height, power of two
+     * @param minTile smallest tile, power of two
+     */
+    AtlasAllocator(uint32_t size, uint32_t minTile);
+
+    /**
+     * @brief Allocate a tile. Tiles are taken from the lowest free position so the atlas fills from one corner.
+     *
+     * @param tileSize rounded up to a power of two of at least minTile
+     * @return Tile invalid if there is no free tile of the size
+     */
+    Tile allocate(uint32_t tileSize);
+
+    /**
+     * @brief Release a tile returned by allocate
+     *
+     * @param tile
+     */
+    void free(const Tile& tile);
+
+    uint32_t getSize() const noexcept {return size;}
+
+    /**
+     * @brief texels in allocated tiles
+     */
+    uint64_t getUsed() const noexcept {return used;}
+
+private:
+    uint32_t level(uint32_t tileSize) const noexcept;
+
+    static uint64_t key(uint32_t x, uint32_t y) noexcept {return (uint64_t)y << 32 | x;}
+
+    const uint32_t size;
+    const uint32_t minTile;
+    uint64_t used = 0;
+    // free tiles of each level, level l has tiles of size >> l
+    std::vector<std::set<uint64_t>> freeTiles;
+};
+
+/**
+ * @brief Shadow data of a light read by color programs, std430 layout
+ */
+struct ShadowRecord {
+    glm::mat4 faceMatrices[6];
+    glm::vec4 faceTiles[6]; // xy offset and zw scale of the face in atlas texture coordinates, zw 0 if the light has no shadow
+};
+static_assert(sizeof(ShadowRecord) == 480, "ShadowRecord must match the shadow buffer layout");
+
+/**
+ * @brief Shadow map work of a frame. Caster counts are per drawable and light.
+ */
+struct ShadowStats {
+    uint32_t lights = 0;
+    uint32_t lightsDrawn = 0;       // lights with at least one face drawn
+    uint32_t lightsWithoutTiles = 0; // lights outside the view or without atlas space
+    uint32_t facesDrawn = 0;
+    uint32_t casterDraws = 0;       // drawables drawn into the dirty faces of a light
+    uint64_t atlasUsed = 0;         // texels in tiles
+};
+
+/**
+ * @brief Omnidirectional shadow maps of point lights. Every cube face is a tile of one depth atlas, tile size follows
+ * the screen size of the light's range and faces are drawn through viewport arrays.
+ * Casters are culled per light against the light range and per cube face. Faces keep their contents between frames
+ * and are drawn again only when the light moves, its tiles change or a caster seen by the face moves, is added or is removed.
+ */
+class ShadowMaps {
+public:
+    static constexpr uint8_t AllFaces = 0x3f;
+
+    /**
+     * @brief Create the atlas and its framebuffer
+     *
+     * @param atlasSize width and height of the atlas, power of two
+     * @param maxTile largest face
+     * @param minTile smallest face
+     * @param nearPlane
+     * @param farPlane light range, casters outside of it are culled
+     */
+    ShadowMaps(uint32_t atlasSize, uint32_t maxTile, uint32_t minTile, float nearPlane, float farPlane);
+    ~ShadowMaps();
+
+    ShadowMaps(const ShadowMaps&) = delete;
+    ShadowMaps& operator=(const ShadowMaps&) = delete;
+
+    /**
+     * @brief Pick tile sizes, cull casters of each scene light and find the faces to draw. Call after Scene::pre_render.
+     *
+     * @param scene
+     * @param view camera frustum, lights whose range is outside get no tiles
+     * @param viewPosition
+     * @param pixelScale projected size in pixels of a unit length at unit distance, projection[1][1] * viewport height / 2
+     */
+    void update(Scene& scene, const Frustum& view, const glm::vec3& viewPosition, float pixelScale);
+
+    /**
+     * @brief Faces of a light to draw this frame, bit i is cube face i. 0 if the cached faces are valid or the light has no tiles.
+     */
+    uint8_t getDirtyFaces(uint32_t light) const noexcept {return lights[light]->dirtyFaces;}
+
+    /**
+     * @brief Drawables to draw into the dirty faces of a light, one entry per drawable in Scene::getDrawables() order
+     */
+    const uint8_t* getCasters(uint32_t light) const noexcept {return lights[light]->casters.data();}
+
+    /**
+     * @brief view projection matrices of the cube faces of a light
+     */
+    const std::vector<glm::mat4>& getFaceMatrices(uint32_t light) const noexcept {return lights[light]->faceMatrices;}
+
+    const glm::vec3& getLightPosition(uint32_t light) const noexcept {return lights[light]->position;}
+
+    /**
+     * @brief number of scene lights at the last update, lights are indexed as Scene::getLights()
+     */
+    uint32_t getLightCount() const noexcept {return static_cast<uint32_t>(lights.size());}
+
+    /**
+     * @brief shadow data of each light for color programs
+     */
+    const std::vector<ShadowRecord>& getRecords() const noexcept {return records;}
+
+    /**
+     * @brief Bind the atlas framebuffer and clear the dirty faces
+     */
+    void beginRender();
+
+    /**
+     * @brief Set viewports and scissors 0 to 5 to the face tiles of a light. Depth programs select the face with gl_ViewportIndex.
+     *
+     * @param light
+     */
+    void setViewports(uint32_t light) const;
+
+    /**
+     * @brief Bind the framebuffer of the following passes
+     *
+     * @param target
+     */
+    void endRender(GLuint target = 0);
+
+    /**
+     * @brief Draw every face of every light on the next update
+     */
+    void invalidate() noexcept;
+
+    const Texture2D& getAtlas() const noexcept {return *atlas;}
+
+    const ShadowStats& getStats() const noexcept {return stats;}
+
+    const float nearPlane, farPlane;
+
+    /**
+     * @brief view projection matrices of the 6 cube map faces of a point light
+     */
+    static void cubeFaceMatrices(const glm::vec3& lpos, float nearPlane, float farPlane, std::vector<glm::mat4>& out);
+
+private:
+    struct LightState {
+        glm::vec3 position{};
+        bool cached = false;        // tiles hold the depth of position
+        uint8_t dirtyFaces = 0;
+        uint32_t tileSize = 0;      // 0 if the light has no tiles
+        uint32_t wantedSize = 0;
+        AtlasAllocator::Tile tiles[6];
+        uint64_t frame = 0;         // last update the light was in the scene
+        std::vector<uint8_t> faces; // faces seen by each drawable
+        std::vector<uint8_t> casters;
+        std::vector<glm::mat4> faceMatrices;
+        std::vector<Frustum> faceFrusta;
+    };
+
+    /**
+     * @brief faces of a light intersected by a drawable, AllFaces for drawables without bounds
+     */
+    uint8_t faceMask(Scene& scene, uint32_t drawable, const LightState& state) const;
+
+    bool allocateTiles(LightState& state, uint32_t tileSize);
+    void freeTiles(LightState& state);
+
+    const uint32_t maxTile, minTile;
+
+    std::unique_ptr<Texture2D> atlas;
+    GLuint framebuffer = 0;
+    AtlasAllocator allocator;
+
+    // state of each light by node, lights holds the states in scene order
+    std::unordered_map<const PointLight*, LightState> states;
+    std::vector<LightState*> lights;
+    std::vector<ShadowRecord> records;
+    std::vector<uint32_t> allocationOrder;
+
+    uint64_t frame = 0;
+    uint32_t drawablesVersion = 0;
+    std::vector<uint8_t> inRange;   // scratch for range culling
+
+    ShadowStats stats;
+};
+
+}
+
+#endif // SSRE_SHADOW_H
@@ -41,8 +41,9 @@ private:
 
     glm::mat4 mm{1.f};
 
+    // arena vao, owned by the geometry arena
     GLuint vaoid;
-    GLuint nElements;
+    gl::DrawElementsIndirectCommand drawCommand;
 };
 
 }
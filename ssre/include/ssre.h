@@ -34,6 +34,11 @@ public:
     virtual ~ssre_shader_error() = default;
 };
 
-void SSRE_init();
+/**
+ * @brief initialize the library, call before creating the Window
+ * 
+ * @param headless skip window system initialization, for WindowMode::Headless
+ */
+void SSRE_init(bool headless = false);
 
 } // ssre
\ No newline at end of file
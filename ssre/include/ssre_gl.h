@@ -208,6 +208,17 @@ namespace ssre {
 
     constexpr uint32_t NumTextureUnits = sizeof(TextureUnit) / sizeof(GLenum);
 
+    /**
+     * @brief command layout read by glMultiDrawElementsIndirect
+     */
+    struct DrawElementsIndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint  baseVertex;
+        GLuint baseInstance;
+    };
+
     namespace {
 
     void glUniform(const GLint& value, GLint location)      {glUniform1i(location, value);}
@@ -248,6 +259,38 @@ namespace ssre {
     template<>
     constexpr DataType getGlEnumForType<double>() {return DataType::DOUBLE;}
 
+    // uniform type reported by program introspection for values written with glUniform
+    template<typename T>
+    constexpr GLenum getGlUniformType() {return GL_FALSE;}
+    template<>
+    constexpr GLenum getGlUniformType<GLint>() {return GL_INT;}
+    template<>
+    constexpr GLenum getGlUniformType<GLuint>() {return GL_UNSIGNED_INT;}
+    template<>
+    constexpr GLenum getGlUniformType<GLfloat>() {return GL_FLOAT;}
+    template<>
+    constexpr GLenum getGlUniformType<glm::ivec2>() {return GL_INT_VEC2;}
+    template<>
+    constexpr GLenum getGlUniformType<glm::uvec2>() {return GL_UNSIGNED_INT_VEC2;}
+    template<>
+    constexpr GLenum getGlUniformType<glm::vec2>() {return GL_FLOAT_VEC2;}
+    template<>
+    constexpr GLenum getGlUniformType<glm::ivec3>() {return GL_INT_VEC3;}
+    template<>
+    constexpr GLenum getGlUniformType<glm::uvec3>() {return GL_UNSIGNED_INT_VEC3;}
+    template<>
+    constexpr GLenum getGlUniformType<glm::vec3>() {return GL_FLOAT_VEC3;}
+    template<>
+    constexpr GLenum getGlUniformType<glm::ivec4>() {return GL_INT_VEC4;}
+    template<>
+    constexpr GLenum getGlUniformType<glm::uvec4>() {return GL_UNSIGNED_INT_VEC4;}
+    template<>
+    constexpr GLenum getGlUniformType<glm::vec4>() {return GL_FLOAT_VEC4;}
+    template<>
+    constexpr GLenum getGlUniformType<glm::mat3>() {return GL_FLOAT_MAT3;}
+    template<>
+    constexpr GLenum getGlUniformType<glm::mat4>() {return GL_FLOAT_MAT4;}
+
     }
     
     }
@@ -18,6 +18,23 @@
 
 namespace ssre {
 
+/**
+ * @brief Block compression of loaded 2D textures, see Resource::setTextureCompression
+ */
+enum class TextureCompression {
+    None,   // uncompressed 8 bit data
+    BC,     // BC1 opaque color, BC3 color with alpha, BC5 normal maps
+    BC7     // BC7 color, BC5 normal maps
+};
+
+/**
+ * @brief What a texture holds, selects its compressed format
+ */
+enum class TextureUsage {
+    Color,
+    Normal  // tangent space normals, compressed textures keep only xy. Programs rebuild z = sqrt(1 - dot(xy, xy))
+};
+
 class Texture {
 public:
     Texture(gl::TextureTarget target, std::string name);
@@ -57,10 +74,18 @@ public:
 
     const std::string& getName() const noexcept {return name;}
 
+    /**
+     * @brief incremented when the data of level 0 or the mip chain is replaced
+     * 
+     * @return uint32_t 
+     */
+    uint32_t getRevision() const noexcept {return revision;}
+
 protected:
     const gl::TextureTarget target;
     const std::string name;
     GLuint handle = 0;
+    uint32_t revision = 0;
 };
 
 class Texture2D : public Texture {
@@ -74,8 +99,18 @@ public:
      * @brief Set the 2D Data for this texture, this uploads direct to GPU.
      * 
      * @param data 
+     * @param level mip level, data may be an offset into a bound pixel unpack buffer
+     */
+    void setData(const unsigned char* data, gl::PixelFormat dataFormat, gl::PixelType dataType, gl::TextureInternalFormat internalFormat, uint32_t width, uint32_t height, uint32_t level = 0);
+
+    /**
+     * @brief Set block compressed data of a mip level
+     * 
+     * @param data may be an offset into a bound pixel unpack buffer
+     * @param internalFormat compressed format
+     * @param size bytes of data
      */
-    void setData(const unsigned char* data, gl::PixelFormat dataFormat, gl::PixelType dataType, gl::TextureInternalFormat internalFormat, uint32_t width, uint32_t height);
+    void setCompressedData(const unsigned char* data, GLenum internalFormat, uint32_t width, uint32_t height, size_t size, uint32_t level = 0);
 };
 
 class Texture3D : public Texture {
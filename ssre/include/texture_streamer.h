@@ -0,0 +1,155 @@
+/**
+ * @file texture_streamer.h
+ * @brief asynchronous texture loading
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_TEXTURE_STREAMER_H
+#define SSRE_TEXTURE_STREAMER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+#include <ssre_gl.h>
+#include <texture.h>
+
+namespace ssre {
+
+namespace util {
+class ThreadPool;
+}
+
+/**
+ * @brief Upload work of the streamer
+ */
+struct TextureStreamStats {
+    uint32_t queued = 0;        // waiting for a decode slot
+    uint32_t decoding = 0;      // being decoded or waiting for upload
+    uint64_t uploaded = 0;      // textures completed
+    uint64_t failed = 0;        // files that could not be decoded, they show the error texture
+    uint64_t uploadedBytes = 0;
+    double lastUpdateTime = 0.; // seconds spent in the last update
+};
+
+/**
+ * @brief Loads 2D textures without blocking the GL thread. Worker threads decode files and build the mip chain,
+ * update() uploads finished images through pixel unpack buffers within a time budget.
+ * Requested textures show a 1x1 placeholder until their data is uploaded into the same texture object.
+ * At most maxInFlight images are decoded or waiting for upload at a time, which bounds memory use.
+ * All functions must be called on the GL thread.
+ */
+class TextureStreamer {
+public:
+    /**
+     * @brief Create a streamer
+     *
+     * @param workers decode threads, not blocked by the streamer
+     * @param maxInFlight images decoded ahead of upload
+     */
+    TextureStreamer(util::ThreadPool& workers, uint32_t maxInFlight = 8);
+
+    /**
+     * @brief Waits for running decodes
+     */
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    /**
+     * @brief Queue a file for loading into a texture. The texture gets the placeholder immediately.
+     * Compressed textures are read from their cache file, or baked on the worker and cached.
+     *
+     * @param texture
+     * @param file
+     * @param compression
+     * @param usage selects the compressed format
+     */
+    void load(const std::shared_ptr<Texture2D>& texture, const std::string& file,
+        TextureCompression compression = TextureCompression::None, TextureUsage usage = TextureUsage::Color);
+
+    /**
+     * @brief Upload decoded images until the budget is spent and start new decodes. At least one image is uploaded if one is ready.
+     *
+     * @param budget seconds
+     */
+    void update(double budget);
+
+    /**
+     * @brief Load every queued texture, blocks until done
+     */
+    void finish();
+
+    bool idle() const noexcept {return pending.empty() && inFlight == 0;}
+
+    const TextureStreamStats& getStats() const noexcept {return stats;}
+
+    static constexpr uint8_t PlaceholderColor[4] = {128, 128, 128, 255};
+
+    /**
+     * @brief Decoded image with its mip chain, levels are tightly packed one after another
+     */
+    struct Image {
+        std::shared_ptr<Texture2D> texture;
+        std::string file;
+        uint32_t width = 0, height = 0, channels = 0;
+        GLenum compressedFormat = 0;    // 0 for 8 bit texels
+        std::vector<uint8_t> data;
+        std::vector<size_t> levelOffsets;
+    };
+
+    /**
+     * @brief Append the box filtered mip levels of level 0 to an image
+     *
+     * @param image with level 0 in data
+     */
+    static void buildMipChain(Image& image);
+
+private:
+    // staging buffers used in turn, a buffer is written again after its fence signaled
+    struct Staging {
+        GLuint buffer = 0;
+        size_t size = 0;
+        GLsync fence = nullptr;
+    };
+    static constexpr uint32_t StagingCount = 3;
+
+    void startDecodes();
+    // false if the next staging buffer is still in use and wait is false
+    bool upload(Image& image, bool wait);
+    void uploadError(Texture2D& texture);
+
+    util::ThreadPool& workers;
+    const uint32_t maxInFlight;
+
+    struct Request {
+        std::shared_ptr<Texture2D> texture;
+        std::string file;
+        TextureCompression compression;
+        TextureUsage usage;
+    };
+    std::deque<Request> pending;
+    uint32_t inFlight = 0;  // decoding or in ready, changed on the GL thread only
+
+    // decoded images, filled by workers
+    std::mutex readyMutex;
+    std::condition_variable readyCondition;
+    std::deque<Image> ready;
+    uint32_t decoding = 0;
+
+    Staging staging[StagingCount];
+    uint32_t nextStaging = 0;
+
+    TextureStreamStats stats;
+};
+
+}
+
+#endif // SSRE_TEXTURE_STREAMER_H
@@ -0,0 +1,118 @@
+/**
+ * @file thread_pool.h
+ * @brief fixed size worker thread pool
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_THREAD_POOL_H
+#define SSRE_THREAD_POOL_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <algorithm>
+#include <exception>
+
+namespace ssre::util {
+
+class ThreadPool {
+public:
+    /**
+     * @brief Construct a new Thread Pool
+     *
+     * @param nThreads number of worker threads, 0 uses the hardware concurrency
+     */
+    explicit ThreadPool(std::size_t nThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queue a task for execution on a worker thread
+     *
+     * @tparam F callable with no arguments
+     * @param task
+     * @return std::future holding the task result
+     */
+    template<typename F>
+    auto submit(F&& task) -> std::future<std::invoke_result_t<F>>;
+
+    /**
+     * @brief Call fn(i) for each i in [0, count), split into contiguous ranges over the workers.
+     * Blocks until all calls have completed. Must not be called from a worker thread of this pool.
+     *
+     * @param count
+     * @param fn
+     */
+    template<typename F>
+    void parallel_for(std::size_t count, F&& fn);
+
+    std::size_t size() const noexcept {return workers.size();}
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    bool stopping = false;
+
+    void workerLoop();
+};
+
+template<typename F>
+auto ThreadPool::submit(F&& task) -> std::future<std::invoke_result_t<F>> {
+    using R = std::invoke_result_t<F>;
+    // std::function requires a copyable callable, so the packaged task is shared
+    auto packaged = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+    std::future<R> result = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock{queueMutex};
+        tasks.emplace([packaged]() {(*packaged)();});
+    }
+    queueCondition.notify_one();
+    return result;
+}
+
+template<typename F>
+void ThreadPool::parallel_for(std::size_t count, F&& fn) {
+    if(count == 0)
+        return;
+    const std::size_t nRanges = std::min(count, workers.size());
+    const std::size_t rangeSize = (count + nRanges - 1) / nRanges;
+
+    std::vector<std::future<void>> pending;
+    pending.reserve(nRanges);
+    for(std::size_t begin = 0; begin < count; begin += rangeSize) {
+        const std::size_t end = std::min(count, begin + rangeSize);
+        pending.push_back(submit([&fn, begin, end]() {
+            for(std::size_t i = begin; i < end; ++i)
+                fn(i);
+        }));
+    }
+    // tasks refer to fn, wait for all of them before rethrowing the first exception raised in a worker
+    std::exception_ptr error;
+    for(auto& p : pending) {
+        try {
+            p.get();
+        } catch(...) {
+            if(!error)
+                error = std::current_exception();
+        }
+    }
+    if(error)
+        std::rethrow_exception(error);
+}
+
+} // ssre::util
+
+#endif // SSRE_THREAD_POOL_H
@@ -0,0 +1,128 @@
+/**
+ * @file transform_hierarchy.h
+ * @brief flat storage for scene node transforms
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_TRANSFORM_HIERARCHY_H
+#define SSRE_TRANSFORM_HIERARCHY_H
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+namespace ssre {
+
+class Node;
+
+/**
+ * @brief Node transform in parent local space
+ */
+struct LocalTransform {
+    glm::vec3 position{};
+    glm::vec3 offset{};     // applied before rotation
+    glm::vec3 scale{1.f};   // not inherited by children
+    glm::mat4 rotation{1.f};
+};
+
+/**
+ * @brief Transforms of all nodes in a Scene, stored in parallel arrays. Entries are kept in topological order,
+ * a parent always has a lower index than its children, so world matrices are computed in a single pass.
+ * Only entries edited since the last update, and their descendants, are recomputed.
+ */
+class TransformHierarchy {
+public:
+    static constexpr uint32_t NoParent = std::numeric_limits<uint32_t>::max();
+
+    TransformHierarchy() = default;
+
+    TransformHierarchy(const TransformHierarchy&) = delete;
+    TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+    /**
+     * @brief Append a transform. parent must already be in the hierarchy.
+     *
+     * @param owner node using the new entry
+     * @param parent index of parent entry or NoParent
+     * @param local
+     * @return uint32_t index of the new entry
+     */
+    uint32_t add(Node* owner, uint32_t parent, const LocalTransform& local);
+
+    /**
+     * @brief Indices of the entry root and all its descendants, in increasing order
+     * 
+     * @param root 
+     * @return std::vector<uint32_t> 
+     */
+    std::vector<uint32_t> subtree(uint32_t root) const;
+
+    /**
+     * @brief Remove entries, remaining entries keep their relative order. Indices above a removed entry change,
+     * owners must be updated with the new indices.
+     * 
+     * @param sortedIndices entries to remove in increasing order, must include all descendants of removed entries
+     */
+    void remove(const std::vector<uint32_t>& sortedIndices);
+
+    /**
+     * @brief compute world and normal matrices of dirty entries and their descendants
+     */
+    void update();
+
+    /**
+     * @brief entries recomputed by the last update, in increasing order. Cleared by update and remove.
+     */
+    const std::vector<uint32_t>& getUpdated() const noexcept {return updated;}
+
+    /**
+     * @brief Local transform for modification, marks the entry dirty
+     */
+    LocalTransform& edit(uint32_t i) noexcept {
+        dirty[i] = 1;
+        firstDirty = std::min(firstDirty, i);
+        return locals[i];
+    }
+    const LocalTransform& local(uint32_t i) const noexcept {return locals[i];}
+
+    const glm::mat4& world(uint32_t i) const noexcept {return worlds[i];}
+
+    /**
+     * @brief transpose of the inverse of the upper 3x3 of world(i)
+     */
+    const glm::mat3& normal(uint32_t i) const noexcept {return normals[i];}
+
+    uint32_t parent(uint32_t i) const noexcept {return parents[i];}
+
+    Node* owner(uint32_t i) const noexcept {return owners[i];}
+
+    size_t size() const noexcept {return locals.size();}
+
+private:
+    std::vector<LocalTransform> locals;
+    std::vector<uint32_t> parents;
+
+    // world transform without scale, inherited by children
+    std::vector<glm::mat4> frames;
+    // model matrices
+    std::vector<glm::mat4> worlds;
+    std::vector<glm::mat3> normals;
+
+    // set when the local transform changed or, during update, when the parent changed
+    std::vector<uint8_t> dirty;
+    // lowest dirty index, entries before it are up to date
+    uint32_t firstDirty = NoParent;
+
+    std::vector<uint32_t> updated;
+
+    std::vector<Node*> owners;
+};
+
+}
+
+#endif // SSRE_TRANSFORM_HIERARCHY_H
@@ -14,6 +14,7 @@
 
 #include <string>
 #include <memory>
+#include <cstring>
 
 #include <ssre_gl.h>
 #include <renderer.h>
@@ -40,8 +41,21 @@ public:
 
     virtual void apply() = 0;
 
+    /**
+     * @brief Write the value to a std140 uniform block
+     * 
+     * @param block start of the block
+     * @param offset byte offset of the value in the block
+     */
+    virtual void write(uint8_t* block, GLint offset) const = 0;
+
     GLuint getLocation() const noexcept {return uniformDescription.Location;}
 
+    /**
+     * @brief true if the value is a member of a uniform block, written with write() instead of apply()
+     */
+    bool isBlockMember() const noexcept {return uniformDescription.Location == -1;}
+
 protected:
     virtual UniformBase* cloneImpl() const = 0;
 
@@ -56,7 +70,7 @@ class Uniform : public UniformBase {
 public:
     Uniform(std::string name, T value, ProgramUniformDescription location) :
         UniformBase{std::move(name), location}, value{std::move(value)} {
-            SSRE_CHECK_THROW((GLenum)gl::getGlEnumForType<T>() == location.Type, "Uniform type is invalid for " + name + " at " + std::to_string(location.Location));
+            SSRE_CHECK_THROW(gl::getGlUniformType<T>() == location.Type, "Uniform type is invalid for " + name + " at " + std::to_string(location.Location));
         }
     Uniform(std::string name, ProgramUniformDescription location) :
         Uniform{std::move(name), T{}, location} {
@@ -72,6 +86,8 @@ public:
 
     void apply() override;
 
+    void write(uint8_t* block, GLint offset) const override;
+
 protected:
     /**
      * @brief Clone Implementation
@@ -93,6 +109,18 @@ void Uniform<T>::apply() {
     gl::glUniform(value, getLocation());
 }
 
+template<typename T>
+void Uniform<T>::write(uint8_t* block, GLint offset) const {
+    std::memcpy(block + offset, &value, sizeof(T));
+}
+
+// std140 matrix columns are 16 bytes apart
+template<>
+inline void Uniform<glm::mat3>::write(uint8_t* block, GLint offset) const {
+    for(int c = 0; c < 3; ++c)
+        std::memcpy(block + offset + c * 16, &value[c], sizeof(glm::vec3));
+}
+
 }
 
 
@@ -12,6 +12,7 @@
 #define SSRE_WINDOW_H
 
 #include <string>
+#include <memory>
 #include <cstdint>
 
 #include <ssre_gl.h>
@@ -21,6 +22,13 @@
 namespace ssre {
 
 class Renderer;
+class HeadlessContext;
+
+enum class WindowMode {
+    Windowed,   // visible GLFW window
+    Headless    // surfaceless EGL context, frames are drawn to an offscreen framebuffer
+};
+
 class Window : public util::Singleton<Window> {
 public:
 
@@ -33,26 +41,78 @@ public:
      * @param width 
      * @param height 
      * @param name Window title
+     * @param mode Headless needs no display and runs on software rasterizers, input callbacks are never called
      * 
      */
-    Window(uint32_t width, uint32_t height, std::string name);
+    Window(uint32_t width, uint32_t height, std::string name, WindowMode mode = WindowMode::Windowed);
     virtual ~Window();
 
     Window(const Window&) = delete;
     Window& operator=(const Window&) = delete;
 
     /**
-     * @brief enter run loop, will execute until window close request
+     * @brief enter run loop, will execute until window close request, close() or the frame limit
      * 
      */
     void Run();
 
     /**
-     * @brief Set the Renderer
+     * @brief Set the Renderer. It draws to the window's framebuffer.
      * 
      * @param 
      */
-    void SetRenderer(const std::shared_ptr<Renderer>& renderer) {this->renderer = renderer;}
+    void SetRenderer(const std::shared_ptr<Renderer>& renderer);
+
+    bool isHeadless() const noexcept {return mode == WindowMode::Headless;}
+
+    /**
+     * @brief framebuffer frames are drawn to, 0 for a visible window
+     */
+    GLuint getFramebuffer() const noexcept {return framebuffer;}
+
+    uint32_t getWidth() const noexcept {return width;}
+    uint32_t getHeight() const noexcept {return height;}
+
+    /**
+     * @brief Make Run return after the current frame
+     */
+    void close() noexcept {closeRequested = true;}
+
+    /**
+     * @brief Make Run return after a number of frames, 0 runs until the window is closed.
+     * A headless window runs until close() without a limit.
+     * 
+     * @param frames 
+     */
+    void setFrameLimit(uint64_t frames) noexcept {frameLimit = frames;}
+
+    /**
+     * @brief Pass a fixed delta time to the renderer for reproducible frames, 0 uses elapsed time
+     * 
+     * @param delta seconds
+     */
+    void setFixedDelta(float delta) noexcept {fixedDelta = delta;}
+
+    /**
+     * @brief frames rendered by Run
+     */
+    uint64_t getFrameCount() const noexcept {return frameCount;}
+
+    /**
+     * @brief Write frames rendered by Run to png files
+     * 
+     * @param pattern printf pattern with one unsigned integer for the frame number, e.g. "frame_%05u.png". Empty disables capture
+     * @param interval capture every interval-th frame, starting with the first
+     */
+    void setFrameCapture(std::string pattern, uint32_t interval = 1) {capturePattern = std::move(pattern); captureInterval = interval ? interval : 1;}
+
+    /**
+     * @brief Write the current frame to a png file. Call before the frame is presented, from a renderer or in a headless window.
+     * 
+     * @param path 
+     * @return true if the file was written
+     */
+    bool captureFrame(const std::string& path) const;
 
 
     using FramebufferResizeCallback = util::delegate<void(uint32_t, uint32_t)>;
@@ -79,9 +139,25 @@ public:
     glm::dvec2 getMouseVel() const noexcept {return mouseVelocity;}
 
 protected:
-    GLFWwindow* window_ptr;
+    GLFWwindow* window_ptr = nullptr;
+
+    const WindowMode mode;
+    uint32_t width, height;
+
+    // offscreen target of a headless window
+    std::unique_ptr<HeadlessContext> headless;
+    GLuint framebuffer = 0;
+    GLuint colorBuffer = 0;
+    GLuint depthBuffer = 0;
 
     float deltaTime = 0;
+    float fixedDelta = 0;
+    uint64_t frameCount = 0;
+    uint64_t frameLimit = 0;
+    bool closeRequested = false;
+
+    std::string capturePattern;
+    uint32_t captureInterval = 1;
 
     std::shared_ptr<Renderer> renderer;
 
@@ -96,6 +172,14 @@ protected:
 
     void updateMouseVel();
 
+    void createWindow(const std::string& name);
+    void createHeadless();
+
+    /**
+     * @brief load gl functions and enable debug output for the current context
+     */
+    void initGL();
+
     static void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
 
     static void mouse_cursor_position_callback(GLFWwindow* window, double xpos, double ypos);
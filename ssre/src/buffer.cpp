@@ -10,6 +10,10 @@
  */
 
 #include <buffer.h>
+#include <ssre.h>
+
+#include <cstring>
+#include <algorithm>
 
 using namespace ssre;
 using namespace ssre::gl;
@@ -27,4 +31,115 @@ void Buffer::Allocate(std::size_t bytes) {
     GL_CHECKED_CALL(glBufferData((GLenum)target, bytes, NULL, (GLenum)usage));
     glBindBuffer((GLenum)target, 0);
     buf_size = bytes;
+}
+
+void Buffer::Storage(std::size_t bytes, GLbitfield flags) {
+    glBindBuffer((GLenum)target, gl_reference);
+    GL_CHECKED_CALL(glBufferStorage((GLenum)target, bytes, NULL, flags));
+    glBindBuffer((GLenum)target, 0);
+    buf_size = bytes;
+}
+
+void Buffer::SubData(const void* source, std::size_t bytes, std::size_t offset) {
+    glBindBuffer((GLenum)target, gl_reference);
+    GL_CHECKED_CALL(glBufferSubData((GLenum)target, offset, bytes, source));
+    glBindBuffer((GLenum)target, 0);
+}
+
+void Buffer::CopyData(const void* source, std::size_t bytes) {
+    if(bytes > 0) {
+        glBindBuffer((GLenum)target, gl_reference);
+        GL_CHECKED_CALL(glBufferData((GLenum)target, bytes, source, (GLenum)usage));
+        glBindBuffer((GLenum)target, 0);
+        buf_size = bytes;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+uint64_t StreamBuffer::frame_counter = 0;
+GLsync StreamBuffer::frame_fences[StreamBuffer::FramesInFlight] = {};
+
+StreamBuffer::StreamBuffer(BindingTarget target, std::size_t frameBytes) : target{target} {
+    reallocate(frameBytes);
+}
+
+StreamBuffer::~StreamBuffer() {
+    buffer->Bind();
+    glUnmapBuffer((GLenum)target);
+    buffer->Unbind();
+}
+
+void StreamBuffer::reallocate(std::size_t frameBytes) {
+    if(buffer) {
+        // commands already issued keep the old storage alive until they complete
+        buffer->Bind();
+        glUnmapBuffer((GLenum)target);
+        buffer->Unbind();
+    }
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    regionSize = std::max<std::size_t>(frameBytes, 256);
+    buffer = std::make_unique<Buffer>(target, Usage::STREAM_DRAW);
+    buffer->Storage(regionSize * FramesInFlight, flags);
+    buffer->Bind();
+    mapped = static_cast<uint8_t*>(glMapBufferRange((GLenum)target, 0, regionSize * FramesInFlight, flags));
+    buffer->Unbind();
+    SSRE_CHECK_THROW(mapped != nullptr, "Failed to map stream buffer");
+    head = 0;
+    frame = frame_counter;
+}
+
+std::size_t StreamBuffer::allocate(std::size_t bytes, std::size_t alignment) {
+    if(frame != frame_counter) {
+        frame = frame_counter;
+        head = 0;
+    }
+    std::size_t base = (frame % FramesInFlight) * regionSize;
+    std::size_t offset = (base + head + alignment - 1) / alignment * alignment;
+    if(offset + bytes > base + regionSize) {
+        // the new buffer is not used by any frame yet, start again at its first region
+        reallocate(std::max(2 * regionSize, bytes + alignment));
+        base = (frame % FramesInFlight) * regionSize;
+        offset = (base + alignment - 1) / alignment * alignment;
+    }
+    head = offset + bytes - base;
+    return offset;
+}
+
+std::size_t StreamBuffer::write(const void* source, std::size_t bytes, std::size_t alignment) {
+    const std::size_t offset = allocate(bytes, alignment);
+    std::memcpy(mapped + offset, source, bytes);
+    return offset;
+}
+
+void StreamBuffer::EndFrame() {
+    GLsync& fence = frame_fences[frame_counter % FramesInFlight];
+    if(fence)
+        glDeleteSync(fence);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frame_counter++;
+
+    // wait until the GPU is done reading the regions of the frame that is written next
+    GLsync& next = frame_fences[frame_counter % FramesInFlight];
+    if(next) {
+        GLenum result = glClientWaitSync(next, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        while(result == GL_TIMEOUT_EXPIRED)
+            result = glClientWaitSync(next, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        glDeleteSync(next);
+        next = nullptr;
+    }
+}
+
+std::size_t StreamBuffer::UniformOffsetAlignment() {
+    static GLint alignment = 0;
+    if(alignment == 0)
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    return static_cast<std::size_t>(alignment);
+}
+
+std::size_t StreamBuffer::StorageOffsetAlignment() {
+    static GLint alignment = 0;
+    if(alignment == 0)
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    return static_cast<std::size_t>(alignment);
 }
\ No newline at end of file
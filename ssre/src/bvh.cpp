@@ -0,0 +1,376 @@
+/**
+ * @file bvh.cpp
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <bvh.h>
+
+#include <algorithm>
+#include <utility>
+
+#include <ssre.h>
+#include <frustum.h>
+
+using namespace ssre;
+
+namespace {
+
+// leaves are enlarged by a fraction of their size plus a constant
+constexpr float FatMarginScale = 0.1f;
+constexpr float FatMarginMin = 0.05f;
+
+AABB fatten(const AABB& box) {
+    const glm::vec3 d = box.max - box.min;
+    const glm::vec3 margin{FatMarginMin + FatMarginScale * std::max(d.x, std::max(d.y, d.z))};
+    return AABB{box.min - margin, box.max + margin};
+}
+
+constexpr uint32_t AllPlanes = 0x3f;
+
+} // namespace
+
+int32_t DynamicBVH::allocateNode() {
+    if(freeList == Null) {
+        nodes.emplace_back();
+        return static_cast<int32_t>(nodes.size() - 1);
+    }
+    const int32_t node = freeList;
+    freeList = nodes[node].parent;
+    nodes[node] = TreeNode{};
+    return node;
+}
+
+void DynamicBVH::freeNode(int32_t node) {
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+int32_t DynamicBVH::insert(const AABB& box, uint32_t userData) {
+    const int32_t proxy = allocateNode();
+    nodes[proxy].box = fatten(box);
+    nodes[proxy].userData = userData;
+    insertLeaf(proxy);
+    proxyCount++;
+    return proxy;
+}
+
+void DynamicBVH::remove(int32_t proxy) {
+    SSRE_CHECK_THROW(proxy >= 0 && proxy < (int32_t)nodes.size() && nodes[proxy].isLeaf() && nodes[proxy].height == 0, "Invalid BVH proxy");
+    removeLeaf(proxy);
+    freeNode(proxy);
+    proxyCount--;
+}
+
+bool DynamicBVH::move(int32_t proxy, const AABB& box) {
+    if(nodes[proxy].box.contains(box))
+        return false;
+    removeLeaf(proxy);
+    nodes[proxy].box = fatten(box);
+    insertLeaf(proxy);
+    return true;
+}
+
+void DynamicBVH::insertLeaf(int32_t leaf) {
+    if(root == Null) {
+        root = leaf;
+        nodes[root].parent = Null;
+        return;
+    }
+
+    // descend to the sibling with the lowest cost
+    const AABB leafBox = nodes[leaf].box;
+    int32_t index = root;
+    while(!nodes[index].isLeaf()) {
+        const TreeNode& n = nodes[index];
+        const float area = n.box.surfaceArea();
+        const float combinedArea = AABB::merge(n.box, leafBox).surfaceArea();
+
+        // cost of a new parent for this node and the leaf
+        const float cost = 2.f * combinedArea;
+        // cost of pushing the leaf further down the tree
+        const float inheritanceCost = 2.f * (combinedArea - area);
+
+        auto descendCost = [&](int32_t child) {
+            const TreeNode& c = nodes[child];
+            const float merged = AABB::merge(leafBox, c.box).surfaceArea();
+            return (c.isLeaf() ? merged : merged - c.box.surfaceArea()) + inheritanceCost;
+        };
+        const float cost1 = descendCost(n.child1);
+        const float cost2 = descendCost(n.child2);
+
+        if(cost < cost1 && cost < cost2)
+            break;
+        index = cost1 < cost2 ? n.child1 : n.child2;
+    }
+
+    const int32_t sibling = index;
+    const int32_t oldParent = nodes[sibling].parent;
+    const int32_t newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].box = AABB::merge(leafBox, nodes[sibling].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if(oldParent != Null) {
+        if(nodes[oldParent].child1 == sibling)
+            nodes[oldParent].child1 = newParent;
+        else
+            nodes[oldParent].child2 = newParent;
+    } else {
+        root = newParent;
+    }
+
+    refitAncestors(nodes[leaf].parent);
+}
+
+void DynamicBVH::removeLeaf(int32_t leaf) {
+    if(leaf == root) {
+        root = Null;
+        return;
+    }
+
+    const int32_t parent = nodes[leaf].parent;
+    const int32_t grandParent = nodes[parent].parent;
+    const int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if(grandParent != Null) {
+        if(nodes[grandParent].child1 == parent)
+            nodes[grandParent].child1 = sibling;
+        else
+            nodes[grandParent].child2 = sibling;
+        nodes[sibling].parent = grandParent;
+        freeNode(parent);
+        refitAncestors(grandParent);
+    } else {
+        root = sibling;
+        nodes[sibling].parent = Null;
+        freeNode(parent);
+    }
+}
+
+void DynamicBVH::refitAncestors(int32_t index) {
+    while(index != Null) {
+        index = balance(index);
+
+        TreeNode& n = nodes[index];
+        n.height = 1 + std::max(nodes[n.child1].height, nodes[n.child2].height);
+        n.box = AABB::merge(nodes[n.child1].box, nodes[n.child2].box);
+
+        index = n.parent;
+    }
+}
+
+int32_t DynamicBVH::balance(int32_t iA) {
+    TreeNode& A = nodes[iA];
+    if(A.isLeaf() || A.height < 2)
+        return iA;
+
+    const int32_t iB = A.child1;
+    const int32_t iC = A.child2;
+    TreeNode& B = nodes[iB];
+    TreeNode& C = nodes[iC];
+
+    const int32_t diff = C.height - B.height;
+
+    // rotate C up
+    if(diff > 1) {
+        const int32_t iF = C.child1;
+        const int32_t iG = C.child2;
+        TreeNode& F = nodes[iF];
+        TreeNode& G = nodes[iG];
+
+        C.child1 = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+
+        if(C.parent != Null) {
+            if(nodes[C.parent].child1 == iA)
+                nodes[C.parent].child1 = iC;
+            else
+                nodes[C.parent].child2 = iC;
+        } else {
+            root = iC;
+        }
+
+        // keep the taller grandchild under C
+        if(F.height > G.height) {
+            C.child2 = iF;
+            A.child2 = iG;
+            G.parent = iA;
+            A.box = AABB::merge(B.box, G.box);
+            C.box = AABB::merge(A.box, F.box);
+            A.height = 1 + std::max(B.height, G.height);
+            C.height = 1 + std::max(A.height, F.height);
+        } else {
+            C.child2 = iG;
+            A.child2 = iF;
+            F.parent = iA;
+            A.box = AABB::merge(B.box, F.box);
+            C.box = AABB::merge(A.box, G.box);
+            A.height = 1 + std::max(B.height, F.height);
+            C.height = 1 + std::max(A.height, G.height);
+        }
+        return iC;
+    }
+
+    // rotate B up
+    if(diff < -1) {
+        const int32_t iD = B.child1;
+        const int32_t iE = B.child2;
+        TreeNode& D = nodes[iD];
+        TreeNode& E = nodes[iE];
+
+        B.child1 = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+
+        if(B.parent != Null) {
+            if(nodes[B.parent].child1 == iA)
+                nodes[B.parent].child1 = iB;
+            else
+                nodes[B.parent].child2 = iB;
+        } else {
+            root = iB;
+        }
+
+        if(D.height > E.height) {
+            B.child2 = iD;
+            A.child1 = iE;
+            E.parent = iA;
+            A.box = AABB::merge(C.box, E.box);
+            B.box = AABB::merge(A.box, D.box);
+            A.height = 1 + std::max(C.height, E.height);
+            B.height = 1 + std::max(A.height, D.height);
+        } else {
+            B.child2 = iE;
+            A.child1 = iD;
+            D.parent = iA;
+            A.box = AABB::merge(C.box, D.box);
+            B.box = AABB::merge(A.box, E.box);
+            A.height = 1 + std::max(C.height, D.height);
+            B.height = 1 + std::max(A.height, E.height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
+
+void DynamicBVH::collectLeaves(int32_t node, std::vector<uint32_t>& out) const {
+    std::vector<int32_t> pending{node};
+    while(!pending.empty()) {
+        const TreeNode& n = nodes[pending.back()];
+        pending.pop_back();
+        if(n.isLeaf()) {
+            out.push_back(n.userData);
+        } else {
+            pending.push_back(n.child1);
+            pending.push_back(n.child2);
+        }
+    }
+}
+
+void DynamicBVH::query(const Frustum& frustum, std::vector<uint32_t>& out) const {
+    if(root == Null)
+        return;
+
+    // node and the planes it still intersects, children of a node inside a plane skip that plane
+    std::vector<std::pair<int32_t, uint32_t>> pending;
+    pending.reserve(64);
+    pending.emplace_back(root, AllPlanes);
+    while(!pending.empty()) {
+        const auto [index, parentMask] = pending.back();
+        pending.pop_back();
+        const TreeNode& n = nodes[index];
+
+        const glm::vec3 c = n.box.center();
+        const glm::vec3 e = n.box.extent();
+        uint32_t mask = parentMask;
+        bool outside = false;
+        for(int p = 0; p < 6; ++p) {
+            if(!(mask & (1u << p)))
+                continue;
+            const glm::vec4& plane = frustum.getPlane(p);
+            const glm::vec3 normal{plane};
+            const float d = glm::dot(normal, c) + plane.w;
+            const float r = glm::dot(glm::abs(normal), e);
+            if(d < -r) {
+                outside = true;
+                break;
+            }
+            if(d >= r)
+                mask &= ~(1u << p);
+        }
+        if(outside)
+            continue;
+
+        if(mask == 0)
+            collectLeaves(index, out);
+        else if(n.isLeaf())
+            out.push_back(n.userData);
+        else {
+            pending.emplace_back(n.child1, mask);
+            pending.emplace_back(n.child2, mask);
+        }
+    }
+}
+
+void DynamicBVH::query(const BoundingSphere& sphere, std::vector<uint32_t>& out) const {
+    if(root == Null)
+        return;
+
+    const float r2 = sphere.radius * sphere.radius;
+    std::vector<int32_t> pending{root};
+    while(!pending.empty()) {
+        const TreeNode& n = nodes[pending.back()];
+        pending.pop_back();
+
+        // squared distance from the sphere center to the box
+        const glm::vec3 closest = glm::clamp(sphere.center, n.box.min, n.box.max);
+        const glm::vec3 d = closest - sphere.center;
+        if(glm::dot(d, d) > r2)
+            continue;
+
+        if(n.isLeaf()) {
+            out.push_back(n.userData);
+        } else {
+            pending.push_back(n.child1);
+            pending.push_back(n.child2);
+        }
+    }
+}
+
+void DynamicBVH::query(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<uint32_t>& out) const {
+    if(root == Null)
+        return;
+
+    const glm::vec3 invDir = 1.f / direction;
+    std::vector<int32_t> pending{root};
+    while(!pending.empty()) {
+        const TreeNode& n = nodes[pending.back()];
+        pending.pop_back();
+
+        // slab test
+        const glm::vec3 t0 = (n.box.min - origin) * invDir;
+        const glm::vec3 t1 = (n.box.max - origin) * invDir;
+        const glm::vec3 tmin = glm::min(t0, t1);
+        const glm::vec3 tmax = glm::max(t0, t1);
+        const float enter = std::max(std::max(tmin.x, tmin.y), std::max(tmin.z, 0.f));
+        const float exit = std::min(std::min(tmax.x, tmax.y), std::min(tmax.z, maxDistance));
+        if(enter > exit)
+            continue;
+
+        if(n.isLeaf()) {
+            out.push_back(n.userData);
+        } else {
+            pending.push_back(n.child1);
+            pending.push_back(n.child2);
+        }
+    }
+}
@@ -27,8 +27,8 @@ void Camera::update(float delta) {
     x_angle = glm::clamp(x_angle, -glm::pi<float>(), glm::pi<float>());
     y_angle = y_angle - (2.f*glm::pi<float>()*(int)(y_angle / (2.f*glm::pi<float>())));
 
-    rotation = glm::rotate(glm::mat4{1.f}, y_angle, glm::vec3{0, 1, 0});
-    rotation = glm::rotate(rotation, x_angle, glm::vec3{1, 0, 0});
+    glm::mat4 rotation = glm::rotate(glm::mat4{1.f}, y_angle, glm::vec3{0, 1, 0});
+    setRotation(glm::rotate(rotation, x_angle, glm::vec3{1, 0, 0}));
 
     glm::vec3 deltaP{0, 0, 0};
 
@@ -48,7 +48,7 @@ void Camera::update(float delta) {
 }
 
 void Camera::Move(const glm::vec3& dir) {
-    position += glm::vec3{rotation*glm::vec4{dir, 1}};
+    setPosition(getPosition() + glm::vec3{getRotation()*glm::vec4{dir, 1}});
 }
 
 glm::mat4 Camera::getViewMatrix() {
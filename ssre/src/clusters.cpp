@@ -0,0 +1,219 @@
+/**
+ * @file clusters.cpp
+ * @brief clustered forward light lists
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <clusters.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <thread_pool.h>
+
+using namespace ssre;
+
+LightClusters::LightClusters(uint32_t tilesX, uint32_t tilesY, uint32_t slices) :
+    tilesX{tilesX},
+    tilesY{tilesY},
+    slices{slices},
+    sliceLists(slices) {
+
+}
+
+void LightClusters::setProjection(const glm::mat4& proj, uint32_t w, uint32_t h) {
+    if(proj == projection && w == width && h == height)
+        return;
+    projection = proj;
+    width = std::max(w, 1u);
+    height = std::max(h, 1u);
+
+    // near and far of an OpenGL perspective matrix
+    nearPlane = projection[3][2] / (projection[2][2] - 1.f);
+    farPlane = projection[3][2] / (projection[2][2] + 1.f);
+
+    const uint32_t tileWidth = (width + tilesX - 1) / tilesX;
+    const uint32_t tileHeight = (height + tilesY - 1) / tilesY;
+    const float logDepthRange = std::log(farPlane / nearPlane);
+    header.gridSize = glm::uvec4{tilesX, tilesY, slices, 0};
+    header.depthParams = glm::vec4{slices / logDepthRange, -(float)slices * std::log(nearPlane) / logDepthRange, nearPlane, farPlane};
+    header.tileSize = glm::vec4((float)tileWidth, (float)tileHeight, 0.f, 0.f);
+
+    // view space rays through the tile corners, scaled to the slice depths
+    const glm::mat4 inverseProjection = glm::inverse(projection);
+    auto cornerRay = [&](uint32_t px, uint32_t py) {
+        const glm::vec2 ndc{2.f * std::min(px, width) / width - 1.f, 2.f * std::min(py, height) / height - 1.f};
+        const glm::vec4 p = inverseProjection * glm::vec4(ndc.x, ndc.y, -1.f, 1.f);
+        const glm::vec3 v = glm::vec3{p} / p.w;
+        return v / -v.z;
+    };
+
+    bounds.resize(getClusterCount());
+    for(uint32_t z = 0; z < slices; ++z) {
+        const float near = nearPlane * std::pow(farPlane / nearPlane, (float)z / slices);
+        const float far = nearPlane * std::pow(farPlane / nearPlane, (float)(z + 1) / slices);
+        for(uint32_t y = 0; y < tilesY; ++y) {
+            for(uint32_t x = 0; x < tilesX; ++x) {
+                const glm::vec3 rays[4] = {
+                    cornerRay(x * tileWidth, y * tileHeight),
+                    cornerRay((x + 1) * tileWidth, y * tileHeight),
+                    cornerRay(x * tileWidth, (y + 1) * tileHeight),
+                    cornerRay((x + 1) * tileWidth, (y + 1) * tileHeight)
+                };
+                AABB& box = bounds[getClusterIndex(x, y, z)];
+                box = AABB{};
+                for(const glm::vec3& ray : rays) {
+                    box.expand(ray * near);
+                    box.expand(ray * far);
+                }
+            }
+        }
+    }
+
+    columnBounds.assign(slices * tilesX, glm::vec2{std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()});
+    rowBounds.assign(slices * tilesY, glm::vec2{std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()});
+    for(uint32_t z = 0; z < slices; ++z) {
+        for(uint32_t y = 0; y < tilesY; ++y) {
+            for(uint32_t x = 0; x < tilesX; ++x) {
+                const AABB& box = bounds[getClusterIndex(x, y, z)];
+                glm::vec2& column = columnBounds[z * tilesX + x];
+                glm::vec2& row = rowBounds[z * tilesY + y];
+                column = glm::vec2{std::min(column.x, box.min.x), std::max(column.y, box.max.x)};
+                row = glm::vec2{std::min(row.x, box.min.y), std::max(row.y, box.max.y)};
+            }
+        }
+    }
+}
+
+int32_t LightClusters::getSlice(float depth) const noexcept {
+    if(depth <= 0.f)
+        return -1;
+    return static_cast<int32_t>(std::floor(std::log(depth) * header.depthParams.x + header.depthParams.y));
+}
+
+namespace {
+
+// range of clusters along one axis whose extent is within radius of center, uses the same arithmetic as the sphere test
+// so it never rejects a cluster the sphere test accepts. first > last if there is none.
+glm::ivec2 overlapRange(const glm::vec2* extents, uint32_t count, float center, float radius) {
+    glm::ivec2 range{(int32_t)count, -1};
+    for(uint32_t i = 0; i < count; ++i) {
+        const float d = glm::clamp(center, extents[i].x, extents[i].y) - center;
+        if(d * d <= radius * radius) {
+            range.x = std::min(range.x, (int32_t)i);
+            range.y = (int32_t)i;
+        }
+    }
+    return range;
+}
+
+}
+
+bool LightClusters::intersects(const AABB& box, const glm::vec3& center, float radius) noexcept {
+    const glm::vec3 d = glm::clamp(center, box.min, box.max) - center;
+    return glm::dot(d, d) <= radius * radius;
+}
+
+void LightClusters::computeLightBounds(const glm::mat4& view, const std::vector<glm::vec4>& lights) {
+    lightBounds.resize(lights.size());
+    for(size_t i = 0; i < lights.size(); ++i) {
+        LightBounds& b = lightBounds[i];
+        b.center = glm::vec3{view * glm::vec4{glm::vec3{lights[i]}, 1.f}};
+        b.radius = lights[i].w;
+
+        const float minDepth = -b.center.z - b.radius;
+        const float maxDepth = -b.center.z + b.radius;
+        if(maxDepth < nearPlane || minDepth > farPlane) {
+            b.minZ = 1;
+            b.maxZ = 0;
+            continue;
+        }
+        // widened by one slice so rounding never drops a slice the sphere test accepts
+        b.minZ = std::max(getSlice(std::max(minDepth, nearPlane)) - 1, 0);
+        b.maxZ = std::min(getSlice(std::min(maxDepth, farPlane)) + 1, (int32_t)slices - 1);
+    }
+}
+
+void LightClusters::binSlice(uint32_t z) {
+    SliceLists& out = sliceLists[z];
+    out.clusters.resize(tilesX * tilesY);
+    out.indices.clear();
+
+    // lights whose depth range covers the slice and the columns and rows they overlap
+    std::vector<uint32_t>& candidates = out.candidates;
+    candidates.clear();
+    out.candidateTiles.clear();
+    for(uint32_t l = 0; l < lightBounds.size(); ++l) {
+        const LightBounds& b = lightBounds[l];
+        if(b.minZ > (int32_t)z || (int32_t)z > b.maxZ)
+            continue;
+        const glm::ivec2 columns = overlapRange(&columnBounds[z * tilesX], tilesX, b.center.x, b.radius);
+        const glm::ivec2 rows = overlapRange(&rowBounds[z * tilesY], tilesY, b.center.y, b.radius);
+        if(columns.x > columns.y || rows.x > rows.y)
+            continue;
+        candidates.push_back(l);
+        out.candidateTiles.push_back(glm::ivec4{columns.x, columns.y, rows.x, rows.y});
+    }
+
+    for(uint32_t y = 0; y < tilesY; ++y) {
+        for(uint32_t x = 0; x < tilesX; ++x) {
+            const AABB& box = bounds[getClusterIndex(x, y, z)];
+            const uint32_t offset = static_cast<uint32_t>(out.indices.size());
+            for(size_t i = 0; i < candidates.size(); ++i) {
+                const glm::ivec4& tiles = out.candidateTiles[i];
+                const LightBounds& b = lightBounds[candidates[i]];
+                if((int32_t)x >= tiles.x && (int32_t)x <= tiles.y && (int32_t)y >= tiles.z && (int32_t)y <= tiles.w && intersects(box, b.center, b.radius))
+                    out.indices.push_back(candidates[i]);
+            }
+            out.clusters[x + tilesX * y] = glm::uvec2(offset, out.indices.size() - offset);
+        }
+    }
+}
+
+void LightClusters::gatherSlices(uint32_t lightCount) {
+    size_t total = 0;
+    for(const SliceLists& s : sliceLists)
+        total += s.indices.size();
+
+    clusters.resize(getClusterCount());
+    lightIndices.resize(total);
+    uint32_t base = 0;
+    for(uint32_t z = 0; z < slices; ++z) {
+        const SliceLists& s = sliceLists[z];
+        for(uint32_t c = 0; c < tilesX * tilesY; ++c)
+            clusters[z * tilesX * tilesY + c] = glm::uvec2{base + s.clusters[c].x, s.clusters[c].y};
+        std::copy(s.indices.begin(), s.indices.end(), lightIndices.begin() + base);
+        base += static_cast<uint32_t>(s.indices.size());
+    }
+    header.gridSize.w = lightCount;
+}
+
+void LightClusters::build(const glm::mat4& view, const std::vector<glm::vec4>& lights, util::ThreadPool* pool) {
+    computeLightBounds(view, lights);
+
+    // slices write to their own lists
+    if(pool && pool->size() > 1 && lights.size() >= ParallelLightCount) {
+        pool->parallel_for(slices, [this](size_t z) {binSlice(static_cast<uint32_t>(z));});
+    } else {
+        for(uint32_t z = 0; z < slices; ++z)
+            binSlice(z);
+    }
+    gatherSlices(static_cast<uint32_t>(lights.size()));
+}
+
+void LightClusters::buildReference(const glm::mat4& view, const std::vector<glm::vec4>& lights) {
+    clusters.resize(getClusterCount());
+    lightIndices.clear();
+    for(uint32_t c = 0; c < getClusterCount(); ++c) {
+        const uint32_t offset = static_cast<uint32_t>(lightIndices.size());
+        for(uint32_t l = 0; l < lights.size(); ++l) {
+            const glm::vec3 center{view * glm::vec4{glm::vec3{lights[l]}, 1.f}};
+            if(intersects(bounds[c], center, lights[l].w))
+                lightIndices.push_back(l);
+        }
+        clusters[c] = glm::uvec2(offset, lightIndices.size() - offset);
+    }
+    header.gridSize.w = static_cast<uint32_t>(lights.size());
+}
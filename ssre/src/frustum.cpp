@@ -0,0 +1,98 @@
+/**
+ * @file frustum.cpp
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <frustum.h>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SSRE_FRUSTUM_SSE
+#endif
+
+using namespace ssre;
+
+Frustum::Frustum(const glm::mat4& m) {
+    // rows of the column major matrix
+    const glm::vec4 r0{m[0][0], m[1][0], m[2][0], m[3][0]};
+    const glm::vec4 r1{m[0][1], m[1][1], m[2][1], m[3][1]};
+    const glm::vec4 r2{m[0][2], m[1][2], m[2][2], m[3][2]};
+    const glm::vec4 r3{m[0][3], m[1][3], m[2][3], m[3][3]};
+
+    planes[0] = r3 + r0; // left
+    planes[1] = r3 - r0; // right
+    planes[2] = r3 + r1; // bottom
+    planes[3] = r3 - r1; // top
+    planes[4] = r3 + r2; // near
+    planes[5] = r3 - r2; // far
+
+    for(auto& p : planes)
+        p /= glm::length(glm::vec3{p});
+}
+
+bool Frustum::intersects(const BoundingSphere& s) const noexcept {
+    for(const auto& p : planes) {
+        if(glm::dot(glm::vec3{p}, s.center) + p.w < -s.radius)
+            return false;
+    }
+    return true;
+}
+
+bool Frustum::intersects(const AABB& box) const noexcept {
+    const glm::vec3 c = box.center();
+    const glm::vec3 e = box.extent();
+    for(const auto& p : planes) {
+        const glm::vec3 n{p};
+        // projected radius of the box onto the plane normal
+        const float r = glm::dot(glm::abs(n), e);
+        if(glm::dot(n, c) + p.w < -r)
+            return false;
+    }
+    return true;
+}
+
+uint32_t Frustum::intersects(const SphereList& spheres, uint8_t* visible) const noexcept {
+    const size_t n = spheres.size();
+    uint32_t count = 0;
+    size_t i = 0;
+
+#ifdef SSRE_FRUSTUM_SSE
+    __m128 px[6], py[6], pz[6], pw[6];
+    for(int p = 0; p < 6; ++p) {
+        px[p] = _mm_set1_ps(planes[p].x);
+        py[p] = _mm_set1_ps(planes[p].y);
+        pz[p] = _mm_set1_ps(planes[p].z);
+        pw[p] = _mm_set1_ps(planes[p].w);
+    }
+
+    for(; i + 4 <= n; i += 4) {
+        const __m128 x = _mm_loadu_ps(&spheres.x[i]);
+        const __m128 y = _mm_loadu_ps(&spheres.y[i]);
+        const __m128 z = _mm_loadu_ps(&spheres.z[i]);
+        const __m128 negR = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&spheres.radius[i]));
+
+        __m128 inside;
+        for(int p = 0; p < 6; ++p) {
+            __m128 d = _mm_add_ps(_mm_mul_ps(px[p], x), _mm_mul_ps(py[p], y));
+            d = _mm_add_ps(d, _mm_mul_ps(pz[p], z));
+            d = _mm_add_ps(d, pw[p]);
+            const __m128 in = _mm_cmpge_ps(d, negR);
+            inside = p == 0 ? in : _mm_and_ps(inside, in);
+        }
+
+        const int bits = _mm_movemask_ps(inside);
+        for(int k = 0; k < 4; ++k) {
+            visible[i + k] = (bits >> k) & 1;
+            count += visible[i + k];
+        }
+    }
+#endif
+
+    for(; i < n; ++i) {
+        visible[i] = intersects(BoundingSphere{glm::vec3{spheres.x[i], spheres.y[i], spheres.z[i]}, spheres.radius[i]}) ? 1 : 0;
+        count += visible[i];
+    }
+    return count;
+}
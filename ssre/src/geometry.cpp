@@ -11,6 +11,11 @@
 
 #include <cassert>
 #include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstring>
+
+#include <glm/gtc/packing.hpp>
 
 #include <geometry.h>
 #include <material.h>
@@ -21,15 +26,69 @@
 
 using namespace ssre;
 
+uint32_t Geometry::geometry_id_counter = 1;
+
 Geometry::Geometry(std::vector<DrawObject> dobjs, const std::vector<GLfloat>& data) : 
-    buffer{std::make_unique<Buffer>(gl::BindingTarget::ARRAY, gl::Usage::STATIC_DRAW)},
     drawObjects{std::move(dobjs)} {
 
     std::vector<GLfloat> scaledData{data};
+    fitToUnitCube(scaledData);
+    computeBounds(scaledData.data(), scaledData.size() / GeomSizeAndStride);
+
+    upload(scaledData.data(), scaledData.size() / GeomSizeAndStride);
+}
+
+Geometry::Geometry(std::vector<DrawObject> dobjs, const GLfloat* data, size_t nVertices, VertexFormat format) : 
+    drawObjects{std::move(dobjs)},
+    format{format} {
+
+    computeBounds(data, nVertices);
+
+    if(format == VertexFormat::Compact)
+        upload(packCompact(data, nVertices).data(), nVertices);
+    else
+        upload(data, nVertices);
+}
+
+Geometry::~Geometry() {
+    Resource::StaticInst().getGeometryArena().free(range);
+}
+
+void Geometry::upload(const void* vertexData, size_t nVertices) {
+    // indices of all draw objects are stored together
+    std::vector<GLuint> elements;
+    for(auto& dobj : drawObjects) {
+        dobj.firstIndex = static_cast<uint32_t>(elements.size());
+        dobj.numElements = dobj.elements.size();
+        elements.insert(elements.end(), dobj.elements.begin(), dobj.elements.end());
+        dobj.elements = std::vector<GLuint>{};
+    }
+
+    GeometryArena& arena = Resource::StaticInst().getGeometryArena();
+    range = arena.allocate(format, static_cast<uint32_t>(nVertices), static_cast<uint32_t>(elements.size()));
+    arena.upload(range, vertexData, elements.data());
+}
+
+GLuint Geometry::getVAO(const VertexInputs& inputs) const {
+    return Resource::StaticInst().getGeometryArena().getVAO(range.block, inputs);
+}
 
+gl::DrawElementsIndirectCommand Geometry::getDrawCommand(uint32_t shape) const {
+    assert(shape < drawObjects.size());
+    const DrawObject& dobj = drawObjects[shape];
+    return gl::DrawElementsIndirectCommand{
+        static_cast<GLuint>(dobj.numElements),
+        1,
+        range.firstIndex + dobj.firstIndex,
+        static_cast<GLint>(range.baseVertex),
+        0
+    };
+}
+
+void Geometry::fitToUnitCube(std::vector<GLfloat>& data) {
     float max_x, min_x, max_y, min_y, max_z, min_z;
-    max_x = max_y = max_z = std::numeric_limits<float>::min();
-    min_x = min_y = min_x = std::numeric_limits<float>::max();
+    max_x = max_y = max_z = std::numeric_limits<float>::lowest();
+    min_x = min_y = min_z = std::numeric_limits<float>::max();
 
     for(size_t i = 0; i < data.size(); i+=GeomSizeAndStride) {
         max_x = std::max(max_x, data[i]);
@@ -54,41 +113,68 @@ Geometry::Geometry(std::vector<DrawObject> dobjs, const std::vector<GLfloat>& da
     
     // linearly transform all points
     for(size_t i = 0; i < data.size(); i+=GeomSizeAndStride) {
-        scaledData[i] = scale * (data[i] - offset_x);
-        scaledData[i+1] = scale * (data[i+1] - offset_y);
-        scaledData[i+2] = scale * (data[i+2] - offset_z);
+        data[i] = scale * (data[i] - offset_x);
+        data[i+1] = scale * (data[i+1] - offset_y);
+        data[i+2] = scale * (data[i+2] - offset_z);
 
         glm::vec3 tangent{
-            scaledData[i+3],
-            scaledData[i+4],
-            scaledData[i+5]
+            data[i+3],
+            data[i+4],
+            data[i+5]
         };
         tangent = glm::normalize(tangent);
-        scaledData[i+3] = tangent[0];
-        scaledData[i+4] = tangent[1];
-        scaledData[i+5] = tangent[2];
+        data[i+3] = tangent[0];
+        data[i+4] = tangent[1];
+        data[i+5] = tangent[2];
 
         glm::vec3 bitangent{
-            scaledData[i+6],
-            scaledData[i+7],
-            scaledData[i+8]
+            data[i+6],
+            data[i+7],
+            data[i+8]
         };
         bitangent = glm::normalize(bitangent);
-        scaledData[i+6] = bitangent[0];
-        scaledData[i+7] = bitangent[1];
-        scaledData[i+8] = bitangent[2];
+        data[i+6] = bitangent[0];
+        data[i+7] = bitangent[1];
+        data[i+8] = bitangent[2];
 
     }
+}
+
+std::vector<uint8_t> Geometry::packCompact(const GLfloat* data, size_t nVertices) {
+    // degenerate tangent frames (no texture coordinates) are stored as zero
+    auto finite = [](float v) {return std::isfinite(v) ? v : 0.f;};
+
+    std::vector<uint8_t> packed(nVertices * GeomCompactStrideBytes);
+    for(size_t i = 0; i < nVertices; ++i) {
+        const GLfloat* v = data + i * GeomSizeAndStride;
+        uint8_t* out = packed.data() + i * GeomCompactStrideBytes;
+
+        const uint16_t position[4] = {
+            glm::packSnorm1x16(v[0]),
+            glm::packSnorm1x16(v[1]),
+            glm::packSnorm1x16(v[2]),
+            0
+        };
+        const uint32_t tangent = glm::packSnorm3x10_1x2(glm::vec4{finite(v[3]), finite(v[4]), finite(v[5]), 0.f});
+        const uint32_t bitangent = glm::packSnorm3x10_1x2(glm::vec4{finite(v[6]), finite(v[7]), finite(v[8]), 0.f});
+        const uint16_t texcoord[2] = {
+            glm::packHalf1x16(v[9]),
+            glm::packHalf1x16(v[10])
+        };
 
-    buffer->CopyData(scaledData);
+        std::memcpy(out + GeomCompactVertexOffsetBytes, position, sizeof(position));
+        std::memcpy(out + GeomCompactTangentOffsetBytes, &tangent, sizeof(tangent));
+        std::memcpy(out + GeomCompactBitangentOffsetBytes, &bitangent, sizeof(bitangent));
+        std::memcpy(out + GeomCompactTexCoordOffsetBytes, texcoord, sizeof(texcoord));
+    }
+    return packed;
 }
 
-Geometry::Geometry(float uvextent) : 
-    buffer{std::make_unique<Buffer>(gl::BindingTarget::ARRAY, gl::Usage::STATIC_DRAW)} {
+Geometry::Geometry(float uvextent) {
     
     drawObjects.push_back(DrawObject{});
     drawObjects[0].numElements = 6;
-    drawObjects[0].element_buffer->CopyData(std::vector<GLuint>{0, 3, 1, 0, 2, 3});
+    drawObjects[0].elements = {0, 3, 1, 0, 2, 3};
 
     std::vector<float> data;
     // point 1
@@ -155,48 +241,28 @@ Geometry::Geometry(float uvextent) :
     data.push_back(1 * uvextent);
     data.push_back(1 * uvextent);
 
-    buffer->CopyData(data);
-}
+    computeBounds(data.data(), data.size() / GeomSizeAndStride);
 
-void Geometry::configVaoAttribPtrs(uint32_t shape, GLuint vao_id, GLint vert_loc, GLint tan_loc, GLint bitan_loc, GLint texc_loc) {
-    assert(shape < drawObjects.size());
-    glBindVertexArray(vao_id);
-    buffer->Bind();
-
-    // bind element buffer
-    drawObjects[shape].element_buffer->Bind();
-
-    if(vert_loc != -1) {
-        //glEnableVertexAttribArray(vert_loc);
-        // specify stride in bytes
-        //glBindVertexBuffer(0, geometry->getVertexBufferHandle(), 0, sizeof(GLfloat)*3);
-        // specify binding and number of float elements per value
-        //glVertexAttribFormat(0, 3, GL_FLOAT, GL_FALSE, 0);
-        //glVertexAttribBinding(0, vert_loc);
-        glEnableVertexAttribArray(vert_loc);
-        glVertexAttribPointer(vert_loc, 3, GL_FLOAT, GL_FALSE, GeomSizeAndStrideBytes, (void*)GeomVertexOffsetBytes);
-    }
+    upload(data.data(), data.size() / GeomSizeAndStride);
+}
 
-    if(tan_loc != -1) {
-        glEnableVertexAttribArray(tan_loc);
-        glVertexAttribPointer(tan_loc, 3, GL_FLOAT, GL_FALSE, GeomSizeAndStrideBytes, (void*)(GeomTangentOffsetBytes));
-    }
+void Geometry::computeBounds(const GLfloat* data, size_t nVertices) {
+    bounds = AABB{};
+    for(size_t i = 0; i < nVertices; ++i)
+        bounds.expand(glm::vec3{data[i * GeomSizeAndStride], data[i * GeomSizeAndStride + 1], data[i * GeomSizeAndStride + 2]});
 
-    if(bitan_loc != -1) {
-        glEnableVertexAttribArray(bitan_loc);
-        glVertexAttribPointer(bitan_loc, 3, GL_FLOAT, GL_FALSE, GeomSizeAndStrideBytes, (void*)(GeomBitangentOffset));
+    if(!bounds.valid()) {
+        bounds = AABB{glm::vec3{0.f}, glm::vec3{0.f}};
+        boundingSphere = BoundingSphere{};
+        return;
     }
 
-    if(texc_loc != -1) {
-        //glEnableVertexAttribArray(tex_loc);
-        // specify stride in bytes
-        //glBindVertexBuffer(2, geometry->getTexBufferHandle(), 0, sizeof(GLfloat)*2);
-        // specify binding and number of float elements per value
-        /* glVertexAttribFormat(2, 2, GL_FLOAT, GL_FALSE, 0);
-        glVertexAttribBinding(2, tex_loc); */
-        glEnableVertexAttribArray(texc_loc);
-        glVertexAttribPointer(texc_loc, 2, GL_FLOAT, GL_FALSE, GeomSizeAndStrideBytes, (void*)(GeomTexCoordOffsetBytes));
+    // box centered sphere, tighter than the half diagonal
+    float radius2 = 0.f;
+    const glm::vec3 center = bounds.center();
+    for(size_t i = 0; i < nVertices; ++i) {
+        const glm::vec3 d = glm::vec3{data[i * GeomSizeAndStride], data[i * GeomSizeAndStride + 1], data[i * GeomSizeAndStride + 2]} - center;
+        radius2 = std::max(radius2, glm::dot(d, d));
     }
-
-    buffer->Unbind();
+    boundingSphere = BoundingSphere{center, std::sqrt(radius2)};
 }
\ No newline at end of file
@@ -0,0 +1,300 @@
+/**
+ * @file geometry_arena.cpp
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <geometry_arena.h>
+
+#include <algorithm>
+
+#include <ssre.h>
+#include <geometry.h>
+#include <shader.h>
+#include <render_queue.h>
+
+using namespace ssre;
+
+namespace {
+
+// vertex buffer binding index of arena vertex data
+constexpr GLuint VertexBufferBinding = 0;
+
+size_t vertexStride(VertexFormat format) {
+    return format == VertexFormat::Compact ? GeomCompactStrideBytes : GeomSizeAndStrideBytes;
+}
+
+void vertexAttrib(GLint loc, GLint size, GLenum type, GLboolean normalized, size_t offset) {
+    if(loc == -1)
+        return;
+    glEnableVertexAttribArray(loc);
+    glVertexAttribFormat(loc, size, type, normalized, offset);
+    glVertexAttribBinding(loc, VertexBufferBinding);
+}
+
+// larger buffer with the contents of source, commands already issued keep the old storage alive until they complete
+std::unique_ptr<Buffer> reallocate(Buffer& source, gl::BindingTarget target, size_t bytes) {
+    auto buffer = std::make_unique<Buffer>(target, gl::Usage::STATIC_DRAW);
+    buffer->Allocate(bytes);
+    glBindBuffer(GL_COPY_READ_BUFFER, source.Handle());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer->Handle());
+    GL_CHECKED_CALL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, source.size()));
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return buffer;
+}
+
+// doubles the capacity like StreamBuffer, so data is copied a logarithmic number of times
+uint32_t grownCapacity(uint64_t capacity, uint64_t needed, uint64_t max) {
+    if(needed <= capacity)
+        return static_cast<uint32_t>(capacity);
+    return static_cast<uint32_t>(std::min(std::max(needed, 2 * capacity), max));
+}
+
+} // namespace
+
+RangeAllocator::RangeAllocator(uint32_t capacity) : capacity{capacity} {
+    if(capacity > 0)
+        freeRanges.emplace(0, capacity);
+}
+
+uint32_t RangeAllocator::allocate(uint32_t count) {
+    if(count == 0)
+        return 0;
+    for(auto itr = freeRanges.begin(); itr != freeRanges.end(); ++itr) {
+        if(itr->second < count)
+            continue;
+        const uint32_t offset = itr->first;
+        const uint32_t remaining = itr->second - count;
+        freeRanges.erase(itr);
+        if(remaining > 0)
+            freeRanges.emplace(offset + count, remaining);
+        used += count;
+        return offset;
+    }
+    return Invalid;
+}
+
+void RangeAllocator::free(uint32_t offset, uint32_t count) {
+    if(count == 0)
+        return;
+    SSRE_CHECK_THROW(offset + count <= capacity, "Range is outside of the allocator");
+    used -= count;
+
+    auto itr = freeRanges.emplace(offset, count).first;
+    // merge with the following range
+    auto next = std::next(itr);
+    if(next != freeRanges.end() && itr->first + itr->second == next->first) {
+        itr->second += next->second;
+        freeRanges.erase(next);
+    }
+    // merge with the preceding range
+    if(itr != freeRanges.begin()) {
+        auto prev = std::prev(itr);
+        if(prev->first + prev->second == itr->first) {
+            prev->second += itr->second;
+            freeRanges.erase(itr);
+        }
+    }
+}
+
+void RangeAllocator::grow(uint32_t newCapacity) {
+    if(newCapacity <= capacity)
+        return;
+    // merge with a free range ending at the old capacity
+    auto last = freeRanges.empty() ? freeRanges.end() : std::prev(freeRanges.end());
+    if(last != freeRanges.end() && last->first + last->second == capacity)
+        last->second += newCapacity - capacity;
+    else
+        freeRanges.emplace(capacity, newCapacity - capacity);
+    capacity = newCapacity;
+}
+
+uint64_t RangeAllocator::capacityFor(uint32_t count) const noexcept {
+    if(count == 0)
+        return capacity;
+    for(const auto& range : freeRanges) {
+        if(range.second >= count)
+            return capacity;
+    }
+    // the new elements extend the free range at the end
+    uint32_t trailing = 0;
+    if(!freeRanges.empty()) {
+        const auto& last = *freeRanges.rbegin();
+        if(last.first + last.second == capacity)
+            trailing = last.second;
+    }
+    return uint64_t{capacity} - trailing + count;
+}
+
+VertexInputs VertexInputs::fromProgram(const Program& program) {
+    VertexInputs inputs;
+    inputs.vertex = program.getVertexInputLocation();
+    inputs.tangent = program.getTangentInputLocation();
+    inputs.bitangent = program.getBitangentInputLocation();
+    inputs.texCoord = program.getTexChoordInputLocation();
+    inputs.instanceModel = program.getInstanceModelInputLocation();
+    inputs.instanceMaterial = program.getInstanceMaterialInputLocation();
+    return inputs;
+}
+
+GeometryArena::GeometryArena(size_t maxBlockVertexBytes, uint32_t maxBlockIndices) :
+    maxBlockVertexBytes{maxBlockVertexBytes},
+    maxBlockIndices{maxBlockIndices} {
+
+}
+
+GeometryArena::~GeometryArena() {
+    for(auto& block : blocks) {
+        for(auto& vao : block.vaos)
+            glDeleteVertexArrays(1, &vao.second);
+    }
+}
+
+ArenaRange GeometryArena::allocate(VertexFormat format, uint32_t nVertices, uint32_t nIndices) {
+    ArenaRange range;
+    range.vertexCount = nVertices;
+    range.indexCount = nIndices;
+
+    for(uint32_t b = 0; b < blocks.size(); ++b) {
+        if(blocks[b].format == format && allocateIn(b, nVertices, nIndices, range))
+            return range;
+    }
+    // grow a block before adding one
+    for(uint32_t b = 0; b < blocks.size(); ++b) {
+        if(blocks[b].format == format && growBlock(b, nVertices, nIndices) && allocateIn(b, nVertices, nIndices, range))
+            return range;
+    }
+
+    // geometry larger than the maximum block size gets a block of its own size
+    allocateIn(addBlock(format, nVertices, nIndices), nVertices, nIndices, range);
+    return range;
+}
+
+bool GeometryArena::allocateIn(uint32_t b, uint32_t nVertices, uint32_t nIndices, ArenaRange& range) {
+    Block& block = blocks[b];
+    const uint32_t baseVertex = block.vertexRanges.allocate(nVertices);
+    if(baseVertex == RangeAllocator::Invalid)
+        return false;
+    const uint32_t firstIndex = block.indexRanges.allocate(nIndices);
+    if(firstIndex == RangeAllocator::Invalid) {
+        block.vertexRanges.free(baseVertex, nVertices);
+        return false;
+    }
+    range.block = b;
+    range.baseVertex = baseVertex;
+    range.firstIndex = firstIndex;
+    return true;
+}
+
+bool GeometryArena::growBlock(uint32_t b, uint32_t nVertices, uint32_t nIndices) {
+    Block& block = blocks[b];
+    const uint64_t maxVertices = maxBlockVertexBytes / block.stride;
+    const uint64_t neededVertices = block.vertexRanges.capacityFor(nVertices);
+    const uint64_t neededIndices = block.indexRanges.capacityFor(nIndices);
+    if(neededVertices > maxVertices || neededIndices > maxBlockIndices)
+        return false;
+
+    const uint32_t vertices = grownCapacity(block.vertexRanges.getCapacity(), neededVertices, maxVertices);
+    if(vertices != block.vertexRanges.getCapacity()) {
+        block.vertices = reallocate(*block.vertices, gl::BindingTarget::ARRAY, vertices * block.stride);
+        block.vertexRanges.grow(vertices);
+    }
+    const uint32_t indices = grownCapacity(block.indexRanges.getCapacity(), neededIndices, maxBlockIndices);
+    if(indices != block.indexRanges.getCapacity()) {
+        block.indices = reallocate(*block.indices, gl::BindingTarget::COPY_WRITE, indices * sizeof(GLuint));
+        block.indexRanges.grow(indices);
+    }
+
+    // draw objects keep the VAO names, the VAOs read the new buffers
+    for(auto& vao : block.vaos) {
+        glBindVertexArray(vao.second);
+        glBindVertexBuffer(VertexBufferBinding, block.vertices->Handle(), 0, block.stride);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, block.indices->Handle());
+    }
+    glBindVertexArray(0);
+    return true;
+}
+
+void GeometryArena::free(const ArenaRange& range) {
+    if(!range.valid())
+        return;
+    Block& block = blocks[range.block];
+    block.vertexRanges.free(range.baseVertex, range.vertexCount);
+    block.indexRanges.free(range.firstIndex, range.indexCount);
+}
+
+void GeometryArena::upload(const ArenaRange& range, const void* vertexData, const GLuint* indexData) {
+    SSRE_CHECK_THROW(range.valid(), "Cannot upload to an unallocated arena range");
+    Block& block = blocks[range.block];
+    if(range.vertexCount > 0)
+        block.vertices->SubData(vertexData, range.vertexCount * block.stride, range.baseVertex * block.stride);
+    if(range.indexCount > 0)
+        block.indices->SubData(indexData, range.indexCount * sizeof(GLuint), range.firstIndex * sizeof(GLuint));
+}
+
+GLuint GeometryArena::getVAO(uint32_t block, const VertexInputs& inputs) {
+    Block& b = blocks[block];
+    auto itr = std::find_if(b.vaos.begin(), b.vaos.end(), [&inputs](const auto& v) {return v.first == inputs;});
+    if(itr != b.vaos.end())
+        return itr->second;
+
+    GLuint vao;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glBindVertexBuffer(VertexBufferBinding, b.vertices->Handle(), 0, b.stride);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, b.indices->Handle());
+
+    if(b.format == VertexFormat::Compact) {
+        vertexAttrib(inputs.vertex, 3, GL_SHORT, GL_TRUE, GeomCompactVertexOffsetBytes);
+        vertexAttrib(inputs.tangent, 4, GL_INT_2_10_10_10_REV, GL_TRUE, GeomCompactTangentOffsetBytes);
+        vertexAttrib(inputs.bitangent, 4, GL_INT_2_10_10_10_REV, GL_TRUE, GeomCompactBitangentOffsetBytes);
+        vertexAttrib(inputs.texCoord, 2, GL_HALF_FLOAT, GL_FALSE, GeomCompactTexCoordOffsetBytes);
+    } else {
+        vertexAttrib(inputs.vertex, 3, GL_FLOAT, GL_FALSE, GeomVertexOffsetBytes);
+        vertexAttrib(inputs.tangent, 3, GL_FLOAT, GL_FALSE, GeomTangentOffsetBytes);
+        vertexAttrib(inputs.bitangent, 3, GL_FLOAT, GL_FALSE, GeomBitangentOffset);
+        vertexAttrib(inputs.texCoord, 2, GL_FLOAT, GL_FALSE, GeomTexCoordOffsetBytes);
+    }
+
+    // per instance inputs, a mat4 input uses four consecutive locations, one per column
+    if(inputs.instanceModel != -1) {
+        for(GLuint c = 0; c < 4; c++) {
+            glEnableVertexAttribArray(inputs.instanceModel + c);
+            glVertexAttribFormat(inputs.instanceModel + c, 4, GL_FLOAT, GL_FALSE, InstanceModelOffsetBytes + c * sizeof(glm::vec4));
+            glVertexAttribBinding(inputs.instanceModel + c, mat_spec::InstanceBufferBinding);
+        }
+        if(inputs.instanceMaterial != -1) {
+            glEnableVertexAttribArray(inputs.instanceMaterial);
+            glVertexAttribIFormat(inputs.instanceMaterial, 1, GL_UNSIGNED_INT, InstanceMaterialOffsetBytes);
+            glVertexAttribBinding(inputs.instanceMaterial, mat_spec::InstanceBufferBinding);
+        }
+        glVertexBindingDivisor(mat_spec::InstanceBufferBinding, 1);
+    }
+    glBindVertexArray(0);
+
+    b.vaos.emplace_back(inputs, vao);
+    return vao;
+}
+
+uint32_t GeometryArena::addBlock(VertexFormat format, uint32_t minVertices, uint32_t minIndices) {
+    const size_t stride = vertexStride(format);
+    const uint32_t nVertices = std::max<uint32_t>(minVertices, std::min(InitialBlockVertexBytes, maxBlockVertexBytes) / stride);
+    const uint32_t nIndices = std::max(minIndices, std::min(InitialBlockIndices, maxBlockIndices));
+
+    Block block{
+        format,
+        stride,
+        std::make_unique<Buffer>(gl::BindingTarget::ARRAY, gl::Usage::STATIC_DRAW),
+        // uploads through the copy target, binding the element target would change the bound VAO
+        std::make_unique<Buffer>(gl::BindingTarget::COPY_WRITE, gl::Usage::STATIC_DRAW),
+        RangeAllocator{nVertices},
+        RangeAllocator{nIndices},
+        {}
+    };
+    block.vertices->Allocate(nVertices * stride);
+    block.indices->Allocate(nIndices * sizeof(GLuint));
+    blocks.push_back(std::move(block));
+    return static_cast<uint32_t>(blocks.size() - 1);
+}
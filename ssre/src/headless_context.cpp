@@ -0,0 +1,120 @@
+/**
+ * @file headless_context.cpp
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+
+#include <headless_context.h>
+
+#include <cstring>
+
+#include <ssre.h>
+
+#ifdef SSRE_HEADLESS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+using namespace ssre;
+
+#ifdef SSRE_HEADLESS_EGL
+
+namespace {
+
+bool hasExtension(const char* extensions, const char* name) {
+    if(!extensions)
+        return false;
+    const size_t length = std::strlen(name);
+    for(const char* p = std::strstr(extensions, name); p; p = std::strstr(p + length, name)) {
+        if((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0'))
+            return true;
+    }
+    return false;
+}
+
+}
+
+HeadlessContext::HeadlessContext() {
+    // a surfaceless display needs neither X11 nor a render node
+    EGLDisplay dpy = EGL_NO_DISPLAY;
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if(getPlatformDisplay && hasExtension(eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS), "EGL_MESA_platform_surfaceless"))
+        dpy = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if(dpy == EGL_NO_DISPLAY)
+        dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    SSRE_CHECK_THROW(dpy != EGL_NO_DISPLAY, "No EGL display");
+
+    EGLint major = 0, minor = 0;
+    SSRE_CHECK_THROW(eglInitialize(dpy, &major, &minor) == EGL_TRUE, "Cannot initialize EGL");
+    display = dpy;
+
+    const char* extensions = eglQueryString(dpy, EGL_EXTENSIONS);
+    SSRE_CHECK_THROW(hasExtension(extensions, "EGL_KHR_surfaceless_context"), "EGL display does not support surfaceless contexts");
+    SSRE_CHECK_THROW(hasExtension(extensions, "EGL_KHR_create_context"), "EGL display cannot create core profile contexts");
+    SSRE_CHECK_THROW(eglBindAPI(EGL_OPENGL_API) == EGL_TRUE, "EGL cannot bind the OpenGL API");
+
+    // frames are drawn to framebuffer objects, the config only selects the API
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    if(eglChooseConfig(dpy, configAttributes, &config, 1, &configCount) != EGL_TRUE || configCount == 0) {
+        SSRE_CHECK_THROW(hasExtension(extensions, "EGL_KHR_no_config_context"), "No EGL config for OpenGL");
+        config = EGL_NO_CONFIG_KHR;
+    }
+
+    // same version the window requests, software rasterizers may only provide 4.5
+    for(EGLint contextMinor : {6, 5}) {
+        const EGLint contextAttributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION_KHR, 4,
+            EGL_CONTEXT_MINOR_VERSION_KHR, contextMinor,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+            EGL_CONTEXT_FLAGS_KHR, EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR | EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE_BIT_KHR,
+            EGL_NONE
+        };
+        context = eglCreateContext(dpy, config, EGL_NO_CONTEXT, contextAttributes);
+        if(context != EGL_NO_CONTEXT)
+            break;
+    }
+    if(context == EGL_NO_CONTEXT) {
+        eglTerminate(dpy);
+        throw ssre_exception{"Cannot create an OpenGL 4.5 core EGL context"};
+    }
+
+    if(eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, context) != EGL_TRUE) {
+        eglDestroyContext(dpy, context);
+        eglTerminate(dpy);
+        throw ssre_exception{"Cannot make the EGL context current"};
+    }
+}
+
+HeadlessContext::~HeadlessContext() {
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(display, context);
+    eglTerminate(display);
+}
+
+void* HeadlessContext::getProcAddress(const char* name) {
+    return reinterpret_cast<void*>(eglGetProcAddress(name));
+}
+
+#else
+
+HeadlessContext::HeadlessContext() {
+    throw ssre_exception{"ssre was built without headless support"};
+}
+
+HeadlessContext::~HeadlessContext() {
+
+}
+
+void* HeadlessContext::getProcAddress(const char* name) {
+    return nullptr;
+}
+
+#endif
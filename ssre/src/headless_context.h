@@ -0,0 +1,35 @@
+/**
+ * @file headless_context.h
+ * @brief EGL context without a window system for offscreen rendering.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+
+namespace ssre {
+
+/**
+ * @brief OpenGL core context on a surfaceless EGL display, made current on construction.
+ * Works with Mesa's llvmpipe on machines without a GPU or display server.
+ */
+class HeadlessContext {
+public:
+    HeadlessContext();
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    /**
+     * @brief gl function loader for glad
+     */
+    static void* getProcAddress(const char* name);
+
+private:
+    // EGLDisplay and EGLContext, kept opaque so users do not include EGL
+    void* display = nullptr;
+    void* context = nullptr;
+};
+
+}
@@ -0,0 +1,80 @@
+/**
+ * @file mapped_file.cpp
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <mapped_file.h>
+
+#include <filesystem>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace ssre::util;
+
+bool ssre::util::fileStamp(const std::string& path, int64_t& time, uint64_t& size) {
+    std::error_code ec;
+    auto t = std::filesystem::last_write_time(path, ec);
+    if(ec)
+        return false;
+    auto s = std::filesystem::file_size(path, ec);
+    if(ec)
+        return false;
+    time = static_cast<int64_t>(t.time_since_epoch().count());
+    size = static_cast<uint64_t>(s);
+    return true;
+}
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+    std::ifstream in{path, std::ios::binary | std::ios::ate};
+    if(!in.is_open())
+        return;
+    const std::streamsize size = in.tellg();
+    if(size <= 0)
+        return;
+    in.seekg(0);
+    fallback.resize(static_cast<std::size_t>(size));
+    if(in.read(reinterpret_cast<char*>(fallback.data()), size)) {
+        data_ptr = fallback.data();
+        data_size = fallback.size();
+    }
+}
+
+MappedFile::~MappedFile() {
+
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        return;
+    struct stat st;
+    if(fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* mapped = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if(mapped != MAP_FAILED) {
+            data_ptr = static_cast<const unsigned char*>(mapped);
+            data_size = static_cast<std::size_t>(st.st_size);
+        }
+    }
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if(data_ptr)
+        munmap(const_cast<unsigned char*>(data_ptr), data_size);
+}
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ * @file mapped_file.h
+ * @brief read only memory mapped file
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_MAPPED_FILE_H
+#define SSRE_MAPPED_FILE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ssre::util {
+
+/**
+ * @brief Maps a whole file read only. On platforms without mmap the file is read into memory.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const noexcept {return data_ptr != nullptr;}
+
+    const unsigned char* data() const noexcept {return data_ptr;}
+    std::size_t size() const noexcept {return data_size;}
+
+private:
+    const unsigned char* data_ptr = nullptr;
+    std::size_t data_size = 0;
+
+    // storage when mmap is not available
+    std::vector<unsigned char> fallback;
+};
+
+/**
+ * @brief Modification time and size identifying a revision of a file, for keying caches built from it
+ *
+ * @param path
+ * @param time modification time, file clock ticks
+ * @param size bytes
+ * @return false if the file does not exist
+ */
+bool fileStamp(const std::string& path, int64_t& time, uint64_t& size);
+
+} // ssre::util
+
+#endif // SSRE_MAPPED_FILE_H
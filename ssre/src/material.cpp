@@ -27,18 +27,24 @@ MaterialInfo::MaterialInfo(const tinyobj_wrapper::material_t& other, std::string
     metallic_tex{Resource::StaticInst().load2DTexture(other.mat.metallic_texname.empty() ? "" : baseDir + other.mat.metallic_texname)},
     sheen_tex{Resource::StaticInst().load2DTexture(other.mat.sheen_texname.empty() ? "" : baseDir + other.mat.sheen_texname)},
     emissive_tex{Resource::StaticInst().load2DTexture(other.mat.emissive_texname.empty() ? "" : baseDir + other.mat.emissive_texname)},
-    normal_tex{Resource::StaticInst().load2DTexture(other.mat.normal_texname.empty() ? "" : baseDir + other.mat.normal_texname)} {
+    normal_tex{Resource::StaticInst().load2DTexture(other.mat.normal_texname.empty() ? "" : baseDir + other.mat.normal_texname, TextureUsage::Normal)},
+    diffuse{other.mat.diffuse[0], other.mat.diffuse[1], other.mat.diffuse[2]},
+    emission{other.mat.emission[0], other.mat.emission[1], other.mat.emission[2]},
+    roughness{static_cast<float>(other.mat.roughness)},
+    metallic{static_cast<float>(other.mat.metallic)} {
 
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
 
+uint32_t Material::material_id_counter = 1;
+
 Material::Material(uint32_t pid, UniformInputs inputs, std::vector<TextureInput> tex) : 
-    parameters{std::move(inputs)}, textures{std::move(tex)}, program_id{pid} {
+    parameters{std::move(inputs)}, textures{std::move(tex)}, program_id{pid}, material_id{material_id_counter++} {
 
 }
 
-Material::Material(const Material& other) : textures{other.textures}, program_id{other.program_id} {
+Material::Material(const Material& other) : textures{other.textures}, program_id{other.program_id}, material_id{material_id_counter++} {
     for(const auto& param : other.parameters) {
         parameters.insert(std::make_pair(param.first, param.second->cloneUniform()));
     }
@@ -0,0 +1,254 @@
+/**
+ * @file material_table.cpp
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <material_table.h>
+
+#include <algorithm>
+#include <iostream>
+
+#include <buffer.h>
+#include <material.h>
+#include <shader.h>
+#include <texture.h>
+
+using namespace ssre;
+
+namespace {
+
+// texture storage needs sized formats, textures loaded with unsized formats report them
+GLenum sizedFormat(GLenum format) {
+    switch(format) {
+    case GL_RED:
+        return GL_R8;
+    case GL_RG:
+        return GL_RG8;
+    case GL_RGB:
+        return GL_RGB8;
+    case GL_RGBA:
+        return GL_RGBA8;
+    default:
+        return format;
+    }
+}
+
+// unsized formats store 8 bit normalized channels
+bool isUnsized(GLenum format) {
+    return format == GL_RED || format == GL_RG || format == GL_RGB || format == GL_RGBA;
+}
+
+uint32_t arrayOf(uint32_t map) {return map >> 16;}
+uint32_t layerOf(uint32_t map) {return map & 0xffffu;}
+
+}
+
+MaterialTable::MaterialTable() {
+
+}
+
+MaterialTable::~MaterialTable() {
+    for(TextureArray& a : arrays)
+        glDeleteTextures(1, &a.handle);
+    if(stagingBuffer)
+        glDeleteBuffers(1, &stagingBuffer);
+}
+
+uint32_t MaterialTable::add(Material& material) {
+    auto found = materialIndices.find(material.getMaterialId());
+    if(found != materialIndices.end())
+        return found->second;
+
+    const uint32_t index = static_cast<uint32_t>(records.size());
+    MaterialRecord record;
+    for(glm::uvec4& maps : record.maps)
+        maps = glm::uvec4{MaterialRecord::NoTexture};
+
+    // textures are copied on update, records are filled in then
+    const auto& inputs = material.getTextureInputs();
+    for(uint32_t slot = 0; slot < std::min<size_t>(inputs.size(), MaterialRecord::MaxMaps); ++slot) {
+        const std::shared_ptr<Texture>& texture = inputs[slot].texture;
+        if(!texture || texture->type() != gl::TextureTarget::TEXTURE_2D)
+            continue;
+        Resident& resident = residents[texture.get()];
+        if(!resident.texture) {
+            resident.texture = texture;
+            resident.revision = texture->getRevision() - 1;
+        }
+        resident.users.push_back((index << 3) | slot);
+        record.maps[slot / 4][slot % 4] = resident.map;
+    }
+
+    records.push_back(record);
+    materialIndices.emplace(material.getMaterialId(), index);
+    material.table_index = index;
+    recordsChanged = true;
+    return index;
+}
+
+void MaterialTable::update() {
+    if(!recordBuffer)
+        recordBuffer = std::make_unique<Buffer>(gl::BindingTarget::SHADER_STORAGE, gl::Usage::DYNAMIC_DRAW);
+
+    for(auto& entry : residents) {
+        Resident& resident = entry.second;
+        if(resident.revision == resident.texture->getRevision())
+            continue;
+        resident.revision = resident.texture->getRevision();
+        if(resident.map != MaterialRecord::NoTexture)
+            release(resident.map);
+        resident.map = makeResident(resident);
+        for(uint32_t user : resident.users) {
+            const uint32_t slot = user & 7;
+            records[user >> 3].maps[slot / 4][slot % 4] = resident.map;
+        }
+        recordsChanged = true;
+    }
+
+    if(recordsChanged && !records.empty()) {
+        recordBuffer->CopyData(records);
+        recordsChanged = false;
+    }
+}
+
+void MaterialTable::bind() const {
+    for(uint32_t i = 0; i < arrays.size(); ++i) {
+        glActiveTexture(gl::TextureUnit[mat_spec::MaterialArrayFirstUnit + i]);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, arrays[i].handle);
+    }
+    glActiveTexture(GL_TEXTURE0);
+    if(recordBuffer && !records.empty())
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, mat_spec::MaterialBufferBinding, recordBuffer->Handle());
+}
+
+uint32_t MaterialTable::makeResident(Resident& resident) {
+    const Texture& texture = *resident.texture;
+    texture.bind();
+    GLint width = 0, height = 0, format = 0, maxLevel = 0;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &format);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &maxLevel);
+
+    // levels of a consistent mip chain, textures without mips are copied with one level
+    uint32_t levels = 0;
+    if(width > 0 && height > 0) {
+        for(levels = 1; levels <= static_cast<uint32_t>(maxLevel); ++levels) {
+            const GLint w = std::max(width >> levels, 1), h = std::max(height >> levels, 1);
+            GLint lw = 0, lh = 0;
+            glGetTexLevelParameteriv(GL_TEXTURE_2D, levels, GL_TEXTURE_WIDTH, &lw);
+            glGetTexLevelParameteriv(GL_TEXTURE_2D, levels, GL_TEXTURE_HEIGHT, &lh);
+            if(lw != w || lh != h)
+                break;
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    if(levels == 0)
+        return MaterialRecord::NoTexture;
+
+    const uint32_t map = allocateLayer(sizedFormat(format), width, height, levels);
+    if(map == MaterialRecord::NoTexture)
+        return map;
+    const TextureArray& a = arrays[arrayOf(map)];
+    if(!isUnsized(format)) {
+        for(uint32_t l = 0; l < levels; ++l) {
+            glCopyImageSubData(texture.getHandle(), GL_TEXTURE_2D, l, 0, 0, 0, a.handle, GL_TEXTURE_2D_ARRAY, l, 0, 0, layerOf(map),
+                std::max(width >> l, 1), std::max(height >> l, 1), 1);
+        }
+    } else {
+        // copy image data rejects unsized formats on some drivers, read the levels back through a buffer instead
+        if(!stagingBuffer)
+            glGenBuffers(1, &stagingBuffer);
+        const GLint channels = format == GL_RED ? 1 : format == GL_RG ? 2 : format == GL_RGB ? 3 : 4;
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        texture.bind();
+        glBindTexture(GL_TEXTURE_2D_ARRAY, a.handle);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, stagingBuffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+        for(uint32_t l = 0; l < levels; ++l) {
+            const GLint w = std::max(width >> l, 1), h = std::max(height >> l, 1);
+            glBufferData(GL_PIXEL_PACK_BUFFER, GLsizeiptr(w) * h * channels, nullptr, GL_STREAM_COPY);
+            glGetTexImage(GL_TEXTURE_2D, l, format, GL_UNSIGNED_BYTE, nullptr);
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, l, 0, 0, layerOf(map), w, h, 1, format, GL_UNSIGNED_BYTE, nullptr);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+    ++textureCopies;
+    return map;
+}
+
+void MaterialTable::release(uint32_t map) {
+    arrays[arrayOf(map)].freeLayers.push_back(layerOf(map));
+}
+
+uint32_t MaterialTable::allocateLayer(GLenum internalFormat, uint32_t width, uint32_t height, uint32_t levels) {
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    const uint32_t layerLimit = std::min<uint32_t>(maxLayers, 0x10000);
+
+    for(uint32_t i = 0; i < arrays.size(); ++i) {
+        TextureArray& a = arrays[i];
+        if(a.internalFormat != internalFormat || a.width != width || a.height != height || a.levels != levels)
+            continue;
+        if(!a.freeLayers.empty()) {
+            const uint32_t layer = a.freeLayers.back();
+            a.freeLayers.pop_back();
+            return (i << 16) | layer;
+        }
+        if(a.used == a.capacity) {
+            if(a.capacity >= layerLimit)
+                continue;
+            grow(a);
+        }
+        return (i << 16) | a.used++;
+    }
+
+    if(arrays.size() == mat_spec::MaterialArrayCount) {
+        if(!arraysFull)
+            std::cerr << "MaterialTable: all " << mat_spec::MaterialArrayCount << " texture arrays are in use, textures of other formats are not resident" << std::endl;
+        arraysFull = true;
+        return MaterialRecord::NoTexture;
+    }
+    TextureArray a;
+    a.internalFormat = internalFormat;
+    a.width = width;
+    a.height = height;
+    a.levels = levels;
+    grow(a);
+    arrays.push_back(std::move(a));
+    return static_cast<uint32_t>((arrays.size() - 1) << 16) | arrays.back().used++;
+}
+
+void MaterialTable::grow(TextureArray& a) {
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    const uint32_t capacity = std::min<uint32_t>(std::max<uint32_t>(a.capacity * 2, 4), std::min<uint32_t>(maxLayers, 0x10000));
+
+    GLuint handle;
+    glGenTextures(1, &handle);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, handle);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, a.levels, a.internalFormat, a.width, a.height, capacity);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, a.levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    if(a.handle) {
+        for(uint32_t l = 0; l < a.levels; ++l) {
+            glCopyImageSubData(a.handle, GL_TEXTURE_2D_ARRAY, l, 0, 0, 0, handle, GL_TEXTURE_2D_ARRAY, l, 0, 0, 0,
+                std::max(a.width >> l, 1u), std::max(a.height >> l, 1u), a.used);
+        }
+        glDeleteTextures(1, &a.handle);
+    }
+    a.handle = handle;
+    a.capacity = capacity;
+}
@@ -14,6 +14,8 @@
 #include <material.h>
 #include <geometry.h>
 #include <shader.h>
+#include <resource.h>
+#include <material_table.h>
 
 using namespace ssre;
 
@@ -29,10 +31,15 @@ Mesh::Mesh(std::string name, std::shared_ptr<Geometry> geom, std::shared_ptr<Pro
 }
 
 Mesh::~Mesh() {
-    for(auto& obj : objects) {
-        glDeleteVertexArrays(1, &obj.color_vao_id);
-        glDeleteVertexArrays(1, &obj.depth_vao_id);
-    }
+
+}
+
+namespace {
+
+void drawElements(const gl::DrawElementsIndirectCommand& cmd) {
+    GL_CHECKED_CALL(glDrawElementsBaseVertex(GL_TRIANGLES, cmd.count, GL_UNSIGNED_INT, (void*)(cmd.firstIndex * sizeof(GLuint)), cmd.baseVertex));
+}
+
 }
 
 void Mesh::drawColor() {
@@ -43,15 +50,15 @@ void Mesh::drawColor() {
     }
 
     // upload mesh specific uniform
-    GLint mloc = color_program->getUniformInfo(mat_spec::ModelMatrixUniformName).Location;
+    GLint mloc = color_program->getUniformLocation(mat_spec::ModelMatrixUniform);
     if(mloc != -1) {
         GL_CHECKED_CALL(gl::glUniform(getModelMatrix(), mloc));
     }
 
-    mloc = color_program->getUniformInfo(mat_spec::NormalMatrixUniformName).Location;
+    mloc = color_program->getUniformLocation(mat_spec::NormalMatrixUniform);
     if(mloc != -1) {
         // normal transform
-        GL_CHECKED_CALL(gl::glUniform(glm::mat3{glm::transpose(glm::inverse(getModelMatrix()))}, mloc));
+        GL_CHECKED_CALL(gl::glUniform(getNormalMatrix(), mloc));
     }
 
     int32_t lastMaterialID = materials.size();
@@ -63,7 +70,7 @@ void Mesh::drawColor() {
             lastMaterialID = dro.mat_id;
         }
         
-        GL_CHECKED_CALL(glDrawElements(GL_TRIANGLES, dro.elementCount, GL_UNSIGNED_INT, (void*)0));
+        drawElements(dro.command);
     }
     glBindVertexArray(0);
 }
@@ -76,25 +83,166 @@ void Mesh::drawDepth() {
     }
 
     // upload mesh specific uniform
-    GLint mloc = color_program->getUniformInfo(mat_spec::ModelMatrixUniformName).Location;
+    GLint mloc = depth_program->getUniformLocation(mat_spec::ModelMatrixUniform);
     if(mloc != -1) {
         GL_CHECKED_CALL(gl::glUniform(getModelMatrix(), mloc));
     }
 
-    mloc = color_program->getUniformInfo(mat_spec::NormalMatrixUniformName).Location;
+    mloc = depth_program->getUniformLocation(mat_spec::NormalMatrixUniform);
     if(mloc != -1) {
         // normal transform
-        GL_CHECKED_CALL(gl::glUniform(glm::mat3{glm::transpose(glm::inverse(getModelMatrix()))}, mloc));
+        GL_CHECKED_CALL(gl::glUniform(getNormalMatrix(), mloc));
     }
 
     for(auto& dro : objects) {
-        glBindVertexArray(dro.color_vao_id);
+        glBindVertexArray(dro.depth_vao_id);
         
-        GL_CHECKED_CALL(glDrawElements(GL_TRIANGLES, dro.elementCount, GL_UNSIGNED_INT, (void*)0));
+        drawElements(dro.command);
     }
     glBindVertexArray(0);
 }
 
+void Mesh::enqueue(RenderQueue& queue, RenderPass pass, const glm::mat4& viewMatrix) {
+    updateVAOs();
+
+    const auto& program = pass == RenderPass::Color ? color_program : depth_program;
+    if(pass == RenderPass::Color && program->usesMaterialTable()) {
+        MaterialTable& table = Resource::StaticInst().getMaterialTable();
+        for(const auto& dro : objects)
+            table.add(*materials[dro.mat_id]);
+    }
+    if(program->isInstanced()) {
+        // meshes sharing the geometry get equal keys and are merged into one instanced draw. Programs using the
+        // material table read the material per instance and leave the material field 0, so their indirect draws
+        // merge across materials. The others apply the material of the first mesh in a run, so their key holds
+        // the material of this mesh and meshes with their own materials are not merged
+        const uint32_t geometryId = geometry->getGeometryId();
+        for(uint32_t i = 0; i < objects.size(); i++) {
+            uint32_t material = 0;
+            if(pass == RenderPass::Color && !program->usesMaterialTable())
+                material = materials[objects[i].mat_id]->getMaterialId();
+            const uint64_t batch = (uint64_t{geometryId} << 32) | i;
+            const GLuint vao = pass == RenderPass::Color ? objects[i].color_vao_id : objects[i].depth_vao_id;
+            queue.push(pass, program->program_id, material, vao, 0.f, this, i, batch);
+        }
+        return;
+    }
+
+    const float depth = -(viewMatrix * getModelMatrix()[3]).z;
+    for(uint32_t i = 0; i < objects.size(); i++) {
+        const auto& dro = objects[i];
+        if(pass == RenderPass::Color)
+            queue.push(pass, color_program->program_id, materials[dro.mat_id]->getMaterialId(), dro.color_vao_id, depth, this, i);
+        else
+            queue.push(pass, depth_program->program_id, 0, dro.depth_vao_id, depth, this, i);
+    }
+}
+
+void Mesh::draw(RenderPass pass, uint32_t object, DrawState& state) {
+    const auto& program = pass == RenderPass::Color ? color_program : depth_program;
+    const VAODrawObject& dro = objects[object];
+
+    // upload mesh specific uniforms once per program activation
+    if(state.drawable != this) {
+        GLint mloc = program->getUniformLocation(mat_spec::ModelMatrixUniform);
+        if(mloc != -1) {
+            GL_CHECKED_CALL(gl::glUniform(getModelMatrix(), mloc));
+        }
+
+        mloc = program->getUniformLocation(mat_spec::NormalMatrixUniform);
+        if(mloc != -1) {
+            GL_CHECKED_CALL(gl::glUniform(getNormalMatrix(), mloc));
+        }
+        state.drawable = this;
+    }
+
+    if(pass == RenderPass::Color) {
+        const std::unique_ptr<Material>& material = materials[dro.mat_id];
+        if(state.material != material.get()) {
+            color_program->applyMaterial(material);
+            state.material = material.get();
+        }
+    }
+
+    const GLuint vao = pass == RenderPass::Color ? dro.color_vao_id : dro.depth_vao_id;
+    if(state.vao != vao) {
+        glBindVertexArray(vao);
+        state.vao = vao;
+    }
+
+    drawElements(dro.command);
+}
+
+void Mesh::writeInstance(uint32_t object, InstanceData& out) const {
+    out.model = getModelMatrix();
+    // programs using the material table read the material's record, others get the draw object's material
+    const std::unique_ptr<Material>& material = materials[objects[object].mat_id];
+    out.material = color_program->usesMaterialTable() ? material->getTableIndex() : static_cast<GLuint>(objects[object].mat_id);
+}
+
+void Mesh::drawInstanced(RenderPass pass, uint32_t object, uint32_t firstInstance, uint32_t instanceCount, DrawState& state) {
+    const VAODrawObject& dro = objects[object];
+
+    if(pass == RenderPass::Color) {
+        const std::unique_ptr<Material>& material = materials[dro.mat_id];
+        if(state.material != material.get()) {
+            color_program->applyMaterial(material);
+            state.material = material.get();
+        }
+    }
+
+    const GLuint vao = pass == RenderPass::Color ? dro.color_vao_id : dro.depth_vao_id;
+    if(state.vao != vao) {
+        glBindVertexArray(vao);
+        // instance buffer binding is vao state
+        glBindVertexBuffer(mat_spec::InstanceBufferBinding, state.instanceBuffer, state.instanceOffset, sizeof(InstanceData));
+        state.vao = vao;
+    }
+    state.drawable = nullptr;
+
+    GL_CHECKED_CALL(glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, dro.command.count, GL_UNSIGNED_INT,
+        (void*)(dro.command.firstIndex * sizeof(GLuint)), instanceCount, dro.command.baseVertex, firstInstance));
+}
+
+bool Mesh::writeIndirect(uint32_t object, gl::DrawElementsIndirectCommand& out) const {
+    out = objects[object].command;
+    return true;
+}
+
+void Mesh::drawIndirect(RenderPass pass, uint32_t object, uint32_t firstIndirect, uint32_t indirectCount, DrawState& state) {
+    const VAODrawObject& dro = objects[object];
+
+    if(pass == RenderPass::Color) {
+        const std::unique_ptr<Material>& material = materials[dro.mat_id];
+        if(state.material != material.get()) {
+            color_program->applyMaterial(material);
+            state.material = material.get();
+        }
+    }
+
+    const GLuint vao = pass == RenderPass::Color ? dro.color_vao_id : dro.depth_vao_id;
+    if(state.vao != vao) {
+        glBindVertexArray(vao);
+        glBindVertexBuffer(mat_spec::InstanceBufferBinding, state.instanceBuffer, state.instanceOffset, sizeof(InstanceData));
+        state.vao = vao;
+    }
+    state.drawable = nullptr;
+
+    GL_CHECKED_CALL(glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+        (void*)(state.indirectOffset + firstIndirect * sizeof(gl::DrawElementsIndirectCommand)), indirectCount, 0));
+}
+
+bool Mesh::getWorldBounds(BoundingSphere& sphere) const {
+    if(!geometry)
+        return false;
+    sphere = geometry->getBoundingSphere().transformed(getModelMatrix());
+    return true;
+}
+
+AABB Mesh::getWorldAABB() const {
+    return geometry ? geometry->getBounds().transformed(getModelMatrix()) : AABB{};
+}
+
 void Mesh::setMaterial(uint32_t shape, uint32_t mat_id) {
     if(shape < objects.size()) {
         objects[shape].mat_id = mat_id;
@@ -110,34 +258,28 @@ void Mesh::setGeometry(const std::shared_ptr<Geometry>& geom) {
 }
 
 void Mesh::rebuildVAOs() {
-    for(uint32_t i = objects.size(); i < geometry->nObjects(); i++) {
-        GLuint vao0, vao1;
-        glGenVertexArrays(1, &vao0);
-        glGenVertexArrays(1, &vao1);
-        objects.push_back(VAODrawObject{vao0, vao1, 0, 0});
-    }
+    objects.resize(geometry->nObjects());
+
+    // all draw objects read the geometry arena block, vaos only depend on the program inputs
+    const GLuint color_vao = geometry->getVAO(VertexInputs::fromProgram(*color_program));
+    const GLuint depth_vao = geometry->getVAO(VertexInputs::fromProgram(*depth_program));
 
     const auto& geomObj = geometry->getDrawObjects();
     for(size_t i = 0; i < objects.size(); i++) {
         auto& obj = objects[i];
-        const GLint color_vert_loc = color_program->getVertexInputLocation();
-        const GLint color_texc_loc = color_program->getTexChoordInputLocation();
-        const GLint color_tan_loc = color_program->getTangentInputLocation();
-        const GLint color_bitan_loc = color_program->getBitangentInputLocation();
-
-        const GLint depth_vert_loc = depth_program->getVertexInputLocation();
-        const GLint depth_texc_loc = depth_program->getTexChoordInputLocation();
-        const GLint depth_tan_loc = depth_program->getTangentInputLocation();
-        const GLint depth_bitan_loc = depth_program->getBitangentInputLocation();
-
+        obj.color_vao_id = color_vao;
+        obj.depth_vao_id = depth_vao;
         obj.mat_id = geomObj[i].material_id;
-        obj.elementCount = geomObj[i].numElements;
+        obj.command = geometry->getDrawCommand(i);
+    }
+}
 
-        // bind element array and config vertex inputs
-        geometry->configVaoAttribPtrs(i, obj.color_vao_id, color_vert_loc, color_tan_loc, color_bitan_loc, color_texc_loc);
-        geometry->configVaoAttribPtrs(i, obj.depth_vao_id, depth_vert_loc, depth_tan_loc, depth_bitan_loc, depth_texc_loc);
+void Mesh::updateVAOs() {
+    if(color_program->getModifiedCount() != lastColorModifiedCount || depth_program->getModifiedCount() != lastDepthModifiedCount) {
+        rebuildVAOs();
+        lastColorModifiedCount = color_program->getModifiedCount();
+        lastDepthModifiedCount = depth_program->getModifiedCount();
     }
-    glBindVertexArray(0);
 }
 
 void Mesh::rebuildMaterials() {
@@ -0,0 +1,261 @@
+/**
+ * @file mesh_cache.cpp
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <mesh_cache.h>
+
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <iostream>
+
+#include <geometry.h>
+
+using namespace ssre;
+using namespace ssre::meshcache;
+
+namespace {
+
+constexpr char Magic[8] = {'S', 'S', 'M', 'E', 'S', 'H', '\0', '\0'};
+constexpr uint32_t Version = 3;
+constexpr uint64_t DataAlignment = 16;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t vertexStrideBytes;
+    int64_t sourceTime;         // source modification time, file clock ticks
+    uint64_t sourceSize;
+    uint64_t importKey;
+    uint64_t pathLength;        // source path follows the header
+    uint64_t materialCount;
+    uint64_t materialOffset;
+    uint64_t drawRangeCount;
+    uint64_t drawRangeOffset;
+    uint64_t vertexCount;
+    uint64_t vertexOffset;
+    uint64_t indexCount;
+    uint64_t indexOffset;
+};
+
+// texture names saved for each material, in MaterialInfo order
+std::string tinyobj::material_t::* const MaterialStrings[] = {
+    &tinyobj::material_t::name,
+    &tinyobj::material_t::ambient_texname,
+    &tinyobj::material_t::diffuse_texname,
+    &tinyobj::material_t::specular_texname,
+    &tinyobj::material_t::roughness_texname,
+    &tinyobj::material_t::metallic_texname,
+    &tinyobj::material_t::sheen_texname,
+    &tinyobj::material_t::emissive_texname,
+    &tinyobj::material_t::normal_texname
+};
+
+// factors saved for each material after its strings, stored as floats whatever real_t is
+struct MaterialFactors {
+    float diffuse[3];
+    float emission[3];
+    float roughness;
+    float metallic;
+};
+
+MaterialFactors getFactors(const tinyobj::material_t& mat) {
+    MaterialFactors f;
+    for(int i = 0; i < 3; ++i) {
+        f.diffuse[i] = static_cast<float>(mat.diffuse[i]);
+        f.emission[i] = static_cast<float>(mat.emission[i]);
+    }
+    f.roughness = static_cast<float>(mat.roughness);
+    f.metallic = static_cast<float>(mat.metallic);
+    return f;
+}
+
+void setFactors(tinyobj::material_t& mat, const MaterialFactors& f) {
+    for(int i = 0; i < 3; ++i) {
+        mat.diffuse[i] = f.diffuse[i];
+        mat.emission[i] = f.emission[i];
+    }
+    mat.roughness = f.roughness;
+    mat.metallic = f.metallic;
+}
+
+uint64_t align(uint64_t offset) {
+    return (offset + DataAlignment - 1) & ~(DataAlignment - 1);
+}
+
+/**
+ * @brief bounds checked reads from the mapped file
+ */
+class Reader {
+public:
+    Reader(const unsigned char* data, std::size_t size, uint64_t offset) : data{data}, size{size}, offset{offset} {}
+
+    bool read(void* out, uint64_t bytes) {
+        if(offset > size || bytes > size - offset)
+            return false;
+        std::memcpy(out, data + offset, bytes);
+        offset += bytes;
+        return true;
+    }
+
+    bool readString(std::string& out) {
+        uint32_t len;
+        if(!read(&len, sizeof(len)) || offset > size || len > size - offset)
+            return false;
+        out.assign(reinterpret_cast<const char*>(data + offset), len);
+        offset += len;
+        return true;
+    }
+
+private:
+    const unsigned char* data;
+    std::size_t size;
+    uint64_t offset;
+};
+
+void writeString(std::ostream& out, const std::string& s) {
+    uint32_t len = static_cast<uint32_t>(s.size());
+    out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+    out.write(s.data(), len);
+}
+
+void pad(std::ostream& out, uint64_t to) {
+    static const char zeros[DataAlignment] = {};
+    uint64_t at = static_cast<uint64_t>(out.tellp());
+    out.write(zeros, to - at);
+}
+
+bool fits(const util::MappedFile& file, uint64_t offset, uint64_t count, uint64_t elementSize) {
+    return offset <= file.size() && count <= (file.size() - offset) / elementSize;
+}
+
+} // namespace
+
+std::unique_ptr<util::MappedFile> meshcache::openCache(const std::string& cachePath, const std::string& sourcePath, uint64_t importKey, MeshView& view) {
+    int64_t sourceTime;
+    uint64_t sourceSize;
+    if(!util::fileStamp(sourcePath, sourceTime, sourceSize))
+        return {};
+
+    auto file = std::make_unique<util::MappedFile>(cachePath);
+    if(!file->isOpen() || file->size() < sizeof(Header))
+        return {};
+
+    Header header;
+    std::memcpy(&header, file->data(), sizeof(Header));
+    if(std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 ||
+        header.version != Version ||
+        header.vertexStrideBytes != GeomSizeAndStrideBytes ||
+        header.sourceTime != sourceTime ||
+        header.sourceSize != sourceSize ||
+        header.importKey != importKey)
+        return {};
+
+    if(header.pathLength != sourcePath.size() || !fits(*file, sizeof(Header), header.pathLength, 1) ||
+        std::memcmp(file->data() + sizeof(Header), sourcePath.data(), sourcePath.size()) != 0)
+        return {};
+
+    if(!fits(*file, header.vertexOffset, header.vertexCount, header.vertexStrideBytes) ||
+        !fits(*file, header.indexOffset, header.indexCount, sizeof(GLuint)) ||
+        !fits(*file, header.drawRangeOffset, header.drawRangeCount, sizeof(DrawRange)) ||
+        header.vertexOffset % DataAlignment != 0 || header.indexOffset % sizeof(GLuint) != 0) {
+        std::cerr << "Mesh cache " << cachePath << " is corrupt" << std::endl;
+        return {};
+    }
+
+    MeshView out{};
+    Reader materialReader{file->data(), file->size(), header.materialOffset};
+    out.materials.resize(header.materialCount);
+    for(auto& mat : out.materials) {
+        for(auto member : MaterialStrings) {
+            if(!materialReader.readString(mat.*member)) {
+                std::cerr << "Mesh cache " << cachePath << " is corrupt" << std::endl;
+                return {};
+            }
+        }
+        MaterialFactors factors;
+        if(!materialReader.read(&factors, sizeof(factors))) {
+            std::cerr << "Mesh cache " << cachePath << " is corrupt" << std::endl;
+            return {};
+        }
+        setFactors(mat, factors);
+    }
+
+    out.drawRanges.resize(header.drawRangeCount);
+    std::memcpy(out.drawRanges.data(), file->data() + header.drawRangeOffset, header.drawRangeCount * sizeof(DrawRange));
+    for(const auto& range : out.drawRanges) {
+        if(range.firstIndex > header.indexCount || range.indexCount > header.indexCount - range.firstIndex)
+            return {};
+    }
+
+    out.vertexData = reinterpret_cast<const GLfloat*>(file->data() + header.vertexOffset);
+    out.vertexCount = header.vertexCount;
+    out.indexData = reinterpret_cast<const GLuint*>(file->data() + header.indexOffset);
+    out.indexCount = header.indexCount;
+
+    view = std::move(out);
+    return file;
+}
+
+bool meshcache::writeCache(const std::string& cachePath, const std::string& sourcePath, uint64_t importKey, const MeshView& view) {
+    Header header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.vertexStrideBytes = GeomSizeAndStrideBytes;
+    if(!util::fileStamp(sourcePath, header.sourceTime, header.sourceSize))
+        return false;
+    header.importKey = importKey;
+    header.pathLength = sourcePath.size();
+    header.materialCount = view.materials.size();
+    header.drawRangeCount = view.drawRanges.size();
+    header.vertexCount = view.vertexCount;
+    header.indexCount = view.indexCount;
+
+    // write to a temporary file and rename, so a partially written cache is never read
+    const std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream out{tempPath, std::ios::binary | std::ios::trunc};
+        if(!out.is_open())
+            return false;
+
+        // header is rewritten once offsets are known
+        out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        out.write(sourcePath.data(), sourcePath.size());
+
+        header.materialOffset = static_cast<uint64_t>(out.tellp());
+        for(const auto& mat : view.materials) {
+            for(auto member : MaterialStrings)
+                writeString(out, mat.*member);
+            const MaterialFactors factors = getFactors(mat);
+            out.write(reinterpret_cast<const char*>(&factors), sizeof(factors));
+        }
+
+        header.drawRangeOffset = align(static_cast<uint64_t>(out.tellp()));
+        pad(out, header.drawRangeOffset);
+        out.write(reinterpret_cast<const char*>(view.drawRanges.data()), view.drawRanges.size() * sizeof(DrawRange));
+
+        header.vertexOffset = align(static_cast<uint64_t>(out.tellp()));
+        pad(out, header.vertexOffset);
+        out.write(reinterpret_cast<const char*>(view.vertexData), view.vertexCount * GeomSizeAndStrideBytes);
+
+        header.indexOffset = align(static_cast<uint64_t>(out.tellp()));
+        pad(out, header.indexOffset);
+        out.write(reinterpret_cast<const char*>(view.indexData), view.indexCount * sizeof(GLuint));
+
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        if(!out.good())
+            return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if(ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
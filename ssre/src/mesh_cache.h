@@ -0,0 +1,75 @@
+/**
+ * @file mesh_cache.h
+ * @brief precooked binary geometry cache (.ssmesh)
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_MESH_CACHE_H
+#define SSRE_MESH_CACHE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include <ssre_gl.h>
+#include <mapped_file.h>
+#include <tiny_obj_loader.h>
+
+namespace ssre::meshcache {
+
+constexpr const char* FileExtension = ".ssmesh";
+
+/**
+ * @brief index range and material for one DrawObject
+ */
+struct DrawRange {
+    uint64_t firstIndex;
+    uint64_t indexCount;
+    uint64_t materialId;
+};
+
+/**
+ * @brief Final geometry data, ready for upload. After openCache the data pointers reference the mapped file.
+ *
+ *      file layout:
+ *          Header
+ *          source path
+ *          materials   (name and texture names, length prefixed strings, then Kd, Ke, Pr and Pm as floats)
+ *          draw ranges (DrawRange[drawRangeCount])
+ *          vertex data (16 byte aligned, vertexStrideBytes * vertexCount)
+ *          index data  (GLuint[indexCount])
+ */
+struct MeshView {
+    const GLfloat* vertexData = nullptr;
+    std::size_t vertexCount = 0;
+    const GLuint* indexData = nullptr;
+    std::size_t indexCount = 0;
+    std::vector<DrawRange> drawRanges;
+    std::vector<tinyobj::material_t> materials; // only names, texture names and the factors MaterialInfo reads are stored
+};
+
+/**
+ * @brief Map the cache file at cachePath. Fails if the file is missing, has another version,
+ * was built from a different revision of sourcePath (size or modification time changed), or with other import settings.
+ *
+ * @param cachePath
+ * @param sourcePath
+ * @param importKey identifies the import settings used to build the cached data
+ * @param view filled with pointers into the mapping
+ * @return std::unique_ptr<util::MappedFile> mapping backing view, null if the cache is invalid
+ */
+std::unique_ptr<util::MappedFile> openCache(const std::string& cachePath, const std::string& sourcePath, uint64_t importKey, MeshView& view);
+
+/**
+ * @brief Write view to cachePath, keyed by the current size and modification time of sourcePath and importKey.
+ *
+ * @return true cache was written
+ * @return false
+ */
+bool writeCache(const std::string& cachePath, const std::string& sourcePath, uint64_t importKey, const MeshView& view);
+
+} // ssre::meshcache
+
+#endif // SSRE_MESH_CACHE_H
@@ -0,0 +1,212 @@
+/**
+ * @file mesh_optimize.cpp
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <mesh_optimize.h>
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+using namespace ssre;
+using namespace ssre::meshopt;
+
+namespace {
+
+// scoring parameters from Forsyth's "Linear-Speed Vertex Cache Optimisation"
+constexpr int CacheSize = 32;
+constexpr float CacheDecayPower = 1.5f;
+constexpr float LastTriScore = 0.75f;
+constexpr float ValenceBoostScale = 2.0f;
+constexpr float ValenceBoostPower = 0.5f;
+
+constexpr int MaxValenceTable = 32;
+
+struct ScoreTable {
+    float cache[CacheSize];
+    float valence[MaxValenceTable];
+
+    ScoreTable() {
+        for(int i = 0; i < CacheSize; ++i) {
+            if(i < 3) {
+                // vertices of the last triangle, fixed score so the next triangle does not reuse them all
+                cache[i] = LastTriScore;
+            } else {
+                const float scaler = 1.f / (CacheSize - 3);
+                cache[i] = std::pow(1.f - (i - 3) * scaler, CacheDecayPower);
+            }
+        }
+        for(int i = 0; i < MaxValenceTable; ++i)
+            valence[i] = i == 0 ? 0.f : ValenceBoostScale * std::pow(float(i), -ValenceBoostPower);
+    }
+
+    float score(int cachePosition, uint32_t remainingValence) const {
+        if(remainingValence == 0)
+            return -1.f; // no triangles left that use this vertex
+        float s = cachePosition >= 0 ? cache[cachePosition] : 0.f;
+        s += remainingValence < MaxValenceTable ?
+            valence[remainingValence] :
+            ValenceBoostScale * std::pow(float(remainingValence), -ValenceBoostPower);
+        return s;
+    }
+};
+
+} // namespace
+
+VertexCacheStats meshopt::analyzeVertexCache(const std::vector<GLuint>& indices, std::size_t nVertices, std::size_t cacheSize) {
+    VertexCacheStats stats{};
+    stats.triangles = indices.size() / 3;
+
+    // vertex is in the fifo while fewer than cacheSize vertices were added after it
+    std::vector<std::size_t> addedAt(nVertices, 0);
+    std::vector<bool> referenced(nVertices, false);
+    std::size_t time = cacheSize + 1;
+
+    for(GLuint v : indices) {
+        if(time - addedAt[v] > cacheSize) {
+            addedAt[v] = time++;
+            stats.transformed++;
+        }
+        if(!referenced[v]) {
+            referenced[v] = true;
+            stats.vertices++;
+        }
+    }
+    return stats;
+}
+
+void meshopt::optimizeVertexCache(std::vector<GLuint>& indices, std::size_t nVertices) {
+    static const ScoreTable scores;
+
+    const std::size_t nTriangles = indices.size() / 3;
+    if(nTriangles == 0)
+        return;
+
+    // triangles using each vertex, packed per vertex
+    std::vector<uint32_t> valence(nVertices, 0);
+    for(GLuint v : indices)
+        valence[v]++;
+
+    std::vector<uint32_t> adjacencyOffset(nVertices + 1, 0);
+    for(std::size_t v = 0; v < nVertices; ++v)
+        adjacencyOffset[v + 1] = adjacencyOffset[v] + valence[v];
+
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+        for(std::size_t t = 0; t < nTriangles; ++t)
+            for(std::size_t k = 0; k < 3; ++k)
+                adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+    }
+
+    std::vector<int> cachePosition(nVertices, -1);
+    std::vector<float> vertexScore(nVertices);
+    for(std::size_t v = 0; v < nVertices; ++v)
+        vertexScore[v] = scores.score(-1, valence[v]);
+
+    std::vector<float> triangleScore(nTriangles);
+    std::vector<bool> emitted(nTriangles, false);
+    for(std::size_t t = 0; t < nTriangles; ++t)
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+    std::vector<GLuint> out;
+    out.reserve(indices.size());
+
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> newCache;
+    cache.reserve(CacheSize + 3);
+    newCache.reserve(CacheSize + 3);
+
+    std::size_t nextUnemitted = 0; // fallback cursor when nothing in the cache has triangles left
+    std::size_t best = 0;
+    float bestScore = triangleScore[0];
+    for(std::size_t t = 1; t < nTriangles; ++t) {
+        if(triangleScore[t] > bestScore) {
+            bestScore = triangleScore[t];
+            best = t;
+        }
+    }
+
+    for(std::size_t emittedCount = 0; emittedCount < nTriangles; ++emittedCount) {
+        emitted[best] = true;
+        const GLuint* tri = &indices[best * 3];
+        out.insert(out.end(), tri, tri + 3);
+
+        // remove the triangle from its vertices' adjacency
+        for(std::size_t k = 0; k < 3; ++k) {
+            const GLuint v = tri[k];
+            uint32_t* begin = &adjacency[adjacencyOffset[v]];
+            uint32_t* end = begin + valence[v];
+            uint32_t* found = std::find(begin, end, static_cast<uint32_t>(best));
+            std::swap(*found, *(end - 1));
+            valence[v]--;
+        }
+
+        // triangle vertices move to the front of the lru cache
+        newCache.clear();
+        newCache.insert(newCache.end(), tri, tri + 3);
+        for(uint32_t v : cache) {
+            if(v != tri[0] && v != tri[1] && v != tri[2])
+                newCache.push_back(v);
+        }
+        for(std::size_t i = CacheSize; i < newCache.size(); ++i)
+            cachePosition[newCache[i]] = -1;
+        for(std::size_t i = 0; i < newCache.size(); ++i) {
+            const uint32_t v = newCache[i];
+            if(i < static_cast<std::size_t>(CacheSize))
+                cachePosition[v] = static_cast<int>(i);
+            // vertices that dropped out of the cache are rescored too
+            const float s = scores.score(cachePosition[v], valence[v]);
+            const float delta = s - vertexScore[v];
+            vertexScore[v] = s;
+            for(uint32_t a = adjacencyOffset[v]; a < adjacencyOffset[v] + valence[v]; ++a)
+                triangleScore[adjacency[a]] += delta;
+        }
+        if(newCache.size() > static_cast<std::size_t>(CacheSize))
+            newCache.resize(CacheSize);
+        cache.swap(newCache);
+
+        // next triangle is the best one using a cached vertex
+        bestScore = -std::numeric_limits<float>::max();
+        bool found = false;
+        for(uint32_t v : cache) {
+            for(uint32_t a = adjacencyOffset[v]; a < adjacencyOffset[v] + valence[v]; ++a) {
+                const uint32_t t = adjacency[a];
+                if(triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = t;
+                    found = true;
+                }
+            }
+        }
+        if(!found) {
+            while(nextUnemitted < nTriangles && emitted[nextUnemitted])
+                nextUnemitted++;
+            best = nextUnemitted;
+        }
+    }
+
+    indices.swap(out);
+}
+
+void meshopt::optimizeVertexFetch(std::vector<GLfloat>& vertexData, std::size_t stride, std::vector<GLuint>& indices) {
+    constexpr GLuint Unassigned = std::numeric_limits<GLuint>::max();
+    const std::size_t nVertices = vertexData.size() / stride;
+
+    std::vector<GLuint> remap(nVertices, Unassigned);
+    std::vector<GLfloat> reordered;
+    reordered.reserve(vertexData.size());
+
+    for(auto& v : indices) {
+        if(remap[v] == Unassigned) {
+            remap[v] = static_cast<GLuint>(reordered.size() / stride);
+            reordered.insert(reordered.end(), vertexData.begin() + v * stride, vertexData.begin() + (v + 1) * stride);
+        }
+        v = remap[v];
+    }
+
+    vertexData.swap(reordered);
+}
@@ -0,0 +1,75 @@
+/**
+ * @file mesh_optimize.h
+ * @brief index and vertex order optimization for indexed triangle lists
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_MESH_OPTIMIZE_H
+#define SSRE_MESH_OPTIMIZE_H
+
+#include <vector>
+#include <cstddef>
+
+#include <ssre_gl.h>
+
+namespace ssre::meshopt {
+
+/**
+ * @brief Result of simulating a fifo post transform vertex cache
+ */
+struct VertexCacheStats {
+    std::size_t triangles = 0;
+    std::size_t vertices = 0;       // unique vertices referenced by the indices
+    std::size_t transformed = 0;    // cache misses
+
+    /**
+     * @brief average cache miss ratio, transformed vertices per triangle. 0.5 is the best case for large meshes, 3 the worst
+     */
+    float acmr() const noexcept {return triangles ? float(transformed) / triangles : 0.f;}
+
+    /**
+     * @brief average transform to vertex ratio, 1 is optimal
+     */
+    float atvr() const noexcept {return vertices ? float(transformed) / vertices : 0.f;}
+
+    VertexCacheStats& operator+=(const VertexCacheStats& o) noexcept {
+        triangles += o.triangles;
+        vertices += o.vertices;
+        transformed += o.transformed;
+        return *this;
+    }
+};
+
+/**
+ * @brief simulate a fifo vertex cache of cacheSize entries
+ *
+ * @param indices triangle list
+ * @param nVertices number of vertices indexed
+ * @param cacheSize
+ * @return VertexCacheStats
+ */
+VertexCacheStats analyzeVertexCache(const std::vector<GLuint>& indices, std::size_t nVertices, std::size_t cacheSize = 16);
+
+/**
+ * @brief Reorder triangles for post transform cache locality (Forsyth, linear speed vertex cache optimisation).
+ *
+ * @param indices triangle list, reordered in place
+ * @param nVertices number of vertices indexed
+ */
+void optimizeVertexCache(std::vector<GLuint>& indices, std::size_t nVertices);
+
+/**
+ * @brief Reorder interleaved vertices in the order they are first referenced by indices, indices are remapped.
+ * Vertices that are not referenced are removed.
+ *
+ * @param vertexData interleaved vertex data
+ * @param stride floats per vertex
+ * @param indices
+ */
+void optimizeVertexFetch(std::vector<GLfloat>& vertexData, std::size_t stride, std::vector<GLuint>& indices);
+
+} // ssre::meshopt
+
+#endif // SSRE_MESH_OPTIMIZE_H
@@ -0,0 +1,579 @@
+/**
+ * @file obj_loader.cpp
+ * @brief multithreaded wavefront obj importer
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <obj_loader.h>
+
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <unordered_map>
+
+#include <geometry.h>
+
+using namespace ssre;
+using namespace ssre::obj;
+
+namespace {
+
+// files smaller than this are not split any further
+constexpr std::size_t MinChunkBytes = 256 * 1024;
+
+// bits in Chunk::relative, set when the index is relative to the start of the chunk
+constexpr uint8_t RelativeVertex = 1 << 0;
+constexpr uint8_t RelativeNormal = 1 << 1;
+constexpr uint8_t RelativeTexcoord = 1 << 2;
+
+/**
+ * @brief parse state for a line aligned range of the file
+ */
+struct Chunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+
+    std::vector<tinyobj::real_t> vertices;
+    std::vector<tinyobj::real_t> normals;
+    std::vector<tinyobj::real_t> texcoords;
+
+    // triangle corners, 3 per triangle
+    std::vector<tinyobj::index_t> corners;
+    std::vector<uint8_t> relative;
+
+    struct Event {
+        enum class Type {Object, Group, UseMtl, MtlLib};
+        Type type;
+        std::size_t triangle;   // number of triangles in this chunk before the event
+        std::string name;
+    };
+    std::vector<Event> events;
+
+    // first attribute of this chunk in the merged attrib arrays
+    std::size_t vertexBase = 0;
+    std::size_t normalBase = 0;
+    std::size_t texcoordBase = 0;
+};
+
+inline bool isSpace(char c) {return c == ' ' || c == '\t' || c == '\r';}
+
+inline const char* skipSpace(const char* p, const char* end) {
+    while(p < end && isSpace(*p))
+        ++p;
+    return p;
+}
+
+// strtof skips newlines, so check the line has another value first
+inline bool parseReal(const char*& p, const char* end, tinyobj::real_t& value) {
+    p = skipSpace(p, end);
+    if(p >= end)
+        return false;
+    char* next;
+    value = static_cast<tinyobj::real_t>(std::strtod(p, &next));
+    if(next == p)
+        return false;
+    p = next;
+    return true;
+}
+
+inline bool parseInt(const char*& p, const char* end, int& value) {
+    if(p >= end || isSpace(*p))
+        return false;
+    char* next;
+    value = static_cast<int>(std::strtol(p, &next, 10));
+    if(next == p)
+        return false;
+    p = next;
+    return true;
+}
+
+inline bool startsWith(const char* p, const char* end, const char* token, std::size_t len) {
+    return static_cast<std::size_t>(end - p) > len && std::strncmp(p, token, len) == 0 && isSpace(p[len]);
+}
+
+std::string parseName(const char* p, const char* end) {
+    p = skipSpace(p, end);
+    while(end > p && isSpace(*(end - 1)))
+        --end;
+    return std::string{p, end};
+}
+
+/**
+ * @brief convert a raw obj index into a zero based index. Negative indices count back from the
+ * number of elements parsed so far in the chunk and are corrected once the chunk base is known.
+ */
+inline int resolveIndex(int raw, std::size_t localCount, uint8_t relativeBit, uint8_t& relative) {
+    if(raw > 0)
+        return raw - 1;
+    if(raw < 0) {
+        relative |= relativeBit;
+        return static_cast<int>(localCount) + raw;
+    }
+    return -1;
+}
+
+void parseChunk(Chunk& chunk) {
+    std::vector<tinyobj::index_t> polygon;
+    std::vector<uint8_t> polygonRelative;
+
+    const char* p = chunk.begin;
+    while(p < chunk.end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+        if(!lineEnd)
+            lineEnd = chunk.end;
+
+        const char* token = skipSpace(p, lineEnd);
+        if(token < lineEnd) {
+            if(startsWith(token, lineEnd, "v", 1)) {
+                const char* c = token + 2;
+                tinyobj::real_t x = 0, y = 0, z = 0;
+                parseReal(c, lineEnd, x);
+                parseReal(c, lineEnd, y);
+                parseReal(c, lineEnd, z);
+                chunk.vertices.push_back(x);
+                chunk.vertices.push_back(y);
+                chunk.vertices.push_back(z);
+            } else if(startsWith(token, lineEnd, "vn", 2)) {
+                const char* c = token + 3;
+                tinyobj::real_t x = 0, y = 0, z = 0;
+                parseReal(c, lineEnd, x);
+                parseReal(c, lineEnd, y);
+                parseReal(c, lineEnd, z);
+                chunk.normals.push_back(x);
+                chunk.normals.push_back(y);
+                chunk.normals.push_back(z);
+            } else if(startsWith(token, lineEnd, "vt", 2)) {
+                const char* c = token + 3;
+                tinyobj::real_t u = 0, v = 0;
+                parseReal(c, lineEnd, u);
+                parseReal(c, lineEnd, v);
+                chunk.texcoords.push_back(u);
+                chunk.texcoords.push_back(v);
+            } else if(startsWith(token, lineEnd, "f", 1)) {
+                polygon.clear();
+                polygonRelative.clear();
+                const std::size_t nv = chunk.vertices.size() / 3;
+                const std::size_t nn = chunk.normals.size() / 3;
+                const std::size_t nt = chunk.texcoords.size() / 2;
+
+                const char* c = skipSpace(token + 2, lineEnd);
+                while(c < lineEnd) {
+                    // v, v/vt, v//vn or v/vt/vn
+                    int v = 0, vt = 0, vn = 0;
+                    if(!parseInt(c, lineEnd, v))
+                        break;
+                    if(c < lineEnd && *c == '/') {
+                        ++c;
+                        if(c < lineEnd && *c != '/')
+                            parseInt(c, lineEnd, vt);
+                        if(c < lineEnd && *c == '/') {
+                            ++c;
+                            parseInt(c, lineEnd, vn);
+                        }
+                    }
+                    uint8_t rel = 0;
+                    tinyobj::index_t idx;
+                    idx.vertex_index = resolveIndex(v, nv, RelativeVertex, rel);
+                    idx.normal_index = resolveIndex(vn, nn, RelativeNormal, rel);
+                    idx.texcoord_index = resolveIndex(vt, nt, RelativeTexcoord, rel);
+                    polygon.push_back(idx);
+                    polygonRelative.push_back(rel);
+
+                    // skip to next vertex
+                    while(c < lineEnd && !isSpace(*c))
+                        ++c;
+                    c = skipSpace(c, lineEnd);
+                }
+
+                // fan triangulation
+                for(std::size_t k = 1; k + 1 < polygon.size(); ++k) {
+                    chunk.corners.push_back(polygon[0]);
+                    chunk.corners.push_back(polygon[k]);
+                    chunk.corners.push_back(polygon[k + 1]);
+                    chunk.relative.push_back(polygonRelative[0]);
+                    chunk.relative.push_back(polygonRelative[k]);
+                    chunk.relative.push_back(polygonRelative[k + 1]);
+                }
+            } else if(startsWith(token, lineEnd, "o", 1)) {
+                chunk.events.push_back({Chunk::Event::Type::Object, chunk.corners.size() / 3, parseName(token + 2, lineEnd)});
+            } else if(startsWith(token, lineEnd, "g", 1)) {
+                chunk.events.push_back({Chunk::Event::Type::Group, chunk.corners.size() / 3, parseName(token + 2, lineEnd)});
+            } else if(startsWith(token, lineEnd, "usemtl", 6)) {
+                chunk.events.push_back({Chunk::Event::Type::UseMtl, chunk.corners.size() / 3, parseName(token + 7, lineEnd)});
+            } else if(startsWith(token, lineEnd, "mtllib", 6)) {
+                chunk.events.push_back({Chunk::Event::Type::MtlLib, chunk.corners.size() / 3, parseName(token + 7, lineEnd)});
+            }
+            // comments, smoothing groups, lines and points are ignored
+        }
+        p = lineEnd + 1;
+    }
+}
+
+void loadMaterialLibrary(const std::string& names, const std::string& mtlBaseDir, ObjFile& out,
+        std::map<std::string, int>& materialMap, std::string& warn, std::string& err) {
+    std::istringstream ss{names};
+    std::string file;
+    while(ss >> file) {
+        std::ifstream mtlStream{mtlBaseDir + file};
+        if(mtlStream.is_open()) {
+            tinyobj::LoadMtl(&materialMap, &out.materials, &mtlStream, &warn, &err);
+            return;
+        }
+    }
+    warn += "Failed to load material file(s) " + names + ". Use default material.\n";
+}
+
+} // namespace
+
+bool obj::loadObj(ObjFile& out, const std::string& path, const std::string& mtlBaseDir, util::ThreadPool& pool, std::string& warn, std::string& err) {
+    std::ifstream in{path, std::ios::binary | std::ios::ate};
+    if(!in.is_open()) {
+        err += "Cannot open file " + path + "\n";
+        return false;
+    }
+    const std::streamsize fileSize = in.tellg();
+    in.seekg(0);
+    std::string content(static_cast<std::size_t>(fileSize), '\0');
+    if(!in.read(&content[0], fileSize)) {
+        err += "Failed to read file " + path + "\n";
+        return false;
+    }
+    in.close();
+
+    // split into line aligned chunks
+    const char* data = content.data();
+    const char* dataEnd = data + content.size();
+    const std::size_t nChunks = std::max<std::size_t>(1, std::min(pool.size() * 4, content.size() / MinChunkBytes));
+    const std::size_t chunkBytes = content.size() / nChunks + 1;
+
+    std::vector<Chunk> chunks;
+    const char* begin = data;
+    while(begin < dataEnd) {
+        const char* end = std::min(dataEnd, begin + chunkBytes);
+        const char* newline = static_cast<const char*>(std::memchr(end, '\n', dataEnd - end));
+        end = newline ? newline + 1 : dataEnd;
+        Chunk c{};
+        c.begin = begin;
+        c.end = end;
+        chunks.push_back(std::move(c));
+        begin = end;
+    }
+
+    pool.parallel_for(chunks.size(), [&chunks](std::size_t i) {
+        parseChunk(chunks[i]);
+    });
+
+    // attribute offsets for each chunk
+    std::size_t nVertices = 0, nNormals = 0, nTexcoords = 0;
+    for(auto& c : chunks) {
+        c.vertexBase = nVertices;
+        c.normalBase = nNormals;
+        c.texcoordBase = nTexcoords;
+        nVertices += c.vertices.size() / 3;
+        nNormals += c.normals.size() / 3;
+        nTexcoords += c.texcoords.size() / 2;
+    }
+
+    out.attrib = tinyobj::attrib_t{};
+    out.attrib.vertices.resize(nVertices * 3);
+    out.attrib.normals.resize(nNormals * 3);
+    out.attrib.texcoords.resize(nTexcoords * 2);
+
+    // merge attributes and fix relative indices
+    pool.parallel_for(chunks.size(), [&chunks, &out](std::size_t i) {
+        Chunk& c = chunks[i];
+        std::copy(c.vertices.begin(), c.vertices.end(), out.attrib.vertices.begin() + c.vertexBase * 3);
+        std::copy(c.normals.begin(), c.normals.end(), out.attrib.normals.begin() + c.normalBase * 3);
+        std::copy(c.texcoords.begin(), c.texcoords.end(), out.attrib.texcoords.begin() + c.texcoordBase * 2);
+
+        for(std::size_t k = 0; k < c.corners.size(); ++k) {
+            const uint8_t rel = c.relative[k];
+            if(rel & RelativeVertex)
+                c.corners[k].vertex_index += static_cast<int>(c.vertexBase);
+            if(rel & RelativeNormal)
+                c.corners[k].normal_index += static_cast<int>(c.normalBase);
+            if(rel & RelativeTexcoord)
+                c.corners[k].texcoord_index += static_cast<int>(c.texcoordBase);
+        }
+    });
+
+    // assemble shapes in file order
+    out.shapes.clear();
+    out.materials.clear();
+    std::map<std::string, int> materialMap;
+    int material = -1;
+    tinyobj::shape_t shape{};
+
+    auto appendTriangles = [&shape, &material](const Chunk& c, std::size_t first, std::size_t last) {
+        if(last <= first)
+            return;
+        shape.mesh.indices.insert(shape.mesh.indices.end(), c.corners.begin() + first * 3, c.corners.begin() + last * 3);
+        shape.mesh.num_face_vertices.insert(shape.mesh.num_face_vertices.end(), last - first, 3);
+        shape.mesh.material_ids.insert(shape.mesh.material_ids.end(), last - first, material);
+        shape.mesh.smoothing_group_ids.insert(shape.mesh.smoothing_group_ids.end(), last - first, 0);
+    };
+
+    for(const auto& c : chunks) {
+        std::size_t cursor = 0;
+        for(const auto& e : c.events) {
+            appendTriangles(c, cursor, e.triangle);
+            cursor = e.triangle;
+            switch(e.type) {
+            case Chunk::Event::Type::Object:
+            case Chunk::Event::Type::Group:
+                if(!shape.mesh.indices.empty())
+                    out.shapes.push_back(std::move(shape));
+                shape = tinyobj::shape_t{};
+                shape.name = e.name;
+                break;
+            case Chunk::Event::Type::UseMtl: {
+                auto itr = materialMap.find(e.name);
+                material = itr != materialMap.end() ? itr->second : -1;
+                break;
+            }
+            case Chunk::Event::Type::MtlLib:
+                loadMaterialLibrary(e.name, mtlBaseDir, out, materialMap, warn, err);
+                break;
+            }
+        }
+        appendTriangles(c, cursor, c.corners.size() / 3);
+    }
+    if(!shape.mesh.indices.empty())
+        out.shapes.push_back(std::move(shape));
+
+    return true;
+}
+
+ShapeBuffer obj::buildShapeBuffer(const tinyobj::attrib_t& attrib, const tinyobj::shape_t& shape) {
+    struct Vertex {
+        glm::vec3 position{};
+        glm::vec3 tangent{};
+        glm::vec3 bitangent{};
+        glm::vec3 normal{};
+        glm::vec2 texpos{-1, -1};
+    };
+
+    ShapeBuffer out{};
+    out.material_id = shape.mesh.material_ids.empty() ? -1 : shape.mesh.material_ids[0];
+
+    // vertices used by this shape, indexed through vertexSlot
+    std::vector<Vertex> vertices;
+    std::unordered_map<int, uint32_t> vertexSlot;
+    vertexSlot.reserve(shape.mesh.indices.size() / 2);
+
+    std::vector<GLuint> element_data;
+    element_data.reserve(shape.mesh.indices.size());
+
+    const std::size_t num_faces = shape.mesh.num_face_vertices.size();
+    size_t index_offset = 0;
+    for (size_t f = 0; f < num_faces; f++) {
+        // get all face info
+        glm::vec3 verts[3] = {};
+        glm::vec3 normals[3] = {};
+        bool coordsValid = false;
+        glm::vec2 coords[3] = {};
+        glm::vec3 tans[3] = {};
+        glm::vec3 bitans[3] = {};
+        tinyobj::index_t indices[3] = {};
+        uint32_t slots[3] = {};
+        for (size_t v = 0; v < 3; v++) {
+            indices[v] = shape.mesh.indices[index_offset + v];
+
+            assert(indices[v].vertex_index >= 0);
+            uint32_t vertex_index = 3*indices[v].vertex_index;
+
+            verts[v] = {
+                attrib.vertices[vertex_index+0],
+                attrib.vertices[vertex_index+1],
+                attrib.vertices[vertex_index+2]
+            };
+
+            if(attrib.normals.size() > 0 && indices[v].normal_index >= 0) {
+                uint32_t normal_index = 3*indices[v].normal_index;
+                normals[v] = {
+                    attrib.normals[normal_index+0],
+                    attrib.normals[normal_index+1],
+                    attrib.normals[normal_index+2]
+                };
+                normals[v] = glm::normalize(normals[v]);
+            } else {
+                out.missingNormals = true;
+            }
+
+            if(attrib.texcoords.size() > 0 && indices[v].texcoord_index >= 0) {
+                uint32_t tex_index = 2*indices[v].texcoord_index;
+                coords[v] = {
+                    attrib.texcoords[tex_index+0],
+                    - attrib.texcoords[tex_index+1]
+                };
+                coordsValid = true;
+            } else {
+                out.missingTexcoords = true;
+            }
+
+            auto slot = vertexSlot.find(indices[v].vertex_index);
+            if(slot == vertexSlot.end()) {
+                slot = vertexSlot.emplace(indices[v].vertex_index, static_cast<uint32_t>(vertices.size())).first;
+                vertices.push_back({});
+            }
+            slots[v] = slot->second;
+        }
+
+        bool forceNewVert[3] = {};
+        if(coordsValid) {
+            glm::vec3 dp0 = verts[1] - verts[0];
+            glm::vec3 dp1 = verts[2] - verts[0];
+
+            glm::vec2 duv1 = coords[1] - coords[0];
+            glm::vec2 duv0 = coords[2] - coords[0];
+
+            float r = 1.f / (duv0.x*duv1.y - duv0.y*duv1.x);
+            glm::vec3 ftangent = glm::normalize((dp0*duv1.y - dp1*duv0.y)*r);
+            glm::vec3 fbitangent = glm::normalize((dp1*duv0.x - dp0*duv1.x)*r);
+
+            // create normal corrected tangents and bitangents
+            for (uint32_t v = 0; v < 3; v++) {
+                float ndp = glm::dot(ftangent, normals[v]);
+                tans[v] = glm::normalize(ftangent - ndp * normals[v]);
+                bitans[v] = glm::normalize(glm::cross(normals[v], tans[v]));
+            }
+
+            glm::vec3 avgN = normals[0] + normals[1] + normals[2];
+            avgN = glm::normalize(avgN);
+            float avdp = glm::dot(glm::normalize(glm::cross(ftangent, fbitangent)), avgN);
+            if(avdp < 0) {
+                std::swap(tans[0], bitans[0]);
+                std::swap(tans[1], bitans[1]);
+                std::swap(tans[2], bitans[2]);
+            }
+
+            for (uint32_t v = 0; v < 3; v++){
+                const Vertex& existing = vertices[slots[v]];
+                // mesh normal
+                glm::vec3 n = glm::normalize(normals[v]);
+                // existing normal
+                if(existing.normal != glm::vec3{0, 0, 0}) {
+                    // check if faces are different
+                    if(glm::dot(existing.normal, n) < 0.8) {
+                        forceNewVert[v] = true;
+                        continue;
+                    }
+                }
+
+                // check existing against texture coordinates
+                if(existing.texpos != glm::vec2{-1, -1}) {
+                    // check if vertex texture coords differ from those at assigned index
+                    if(glm::length(existing.texpos - coords[v]) > 0.001) {
+                        forceNewVert[v] = true;
+                        continue;
+                    }
+                }
+            }
+        }
+
+        // save data
+        for(uint32_t v = 0; v < 3; ++v) {
+            uint32_t elem_ind = slots[v];
+
+            if(forceNewVert[v]) {
+                elem_ind = vertices.size();
+                vertices.push_back({
+                    verts[v],
+                    tans[v],
+                    bitans[v],
+                    normals[v],
+                    coords[v]
+                });
+            } else {
+                vertices[elem_ind] = {
+                    verts[v],
+                    vertices[elem_ind].tangent + tans[v],
+                    vertices[elem_ind].bitangent + bitans[v],
+                    normals[v],
+                    coords[v]
+                };
+            }
+
+            element_data.push_back(elem_ind);
+        }
+        index_offset += 3;
+    }
+
+    // create buffer data
+    out.buffer_data.reserve(element_data.size() * GeomSizeAndStride);
+    out.elements.reserve(element_data.size());
+    for(GLuint ind : element_data) {
+        out.elements.push_back(out.buffer_data.size() / GeomSizeAndStride);
+
+        out.buffer_data.push_back(vertices[ind].position[0]);
+        out.buffer_data.push_back(vertices[ind].position[1]);
+        out.buffer_data.push_back(vertices[ind].position[2]);
+
+        out.buffer_data.push_back(vertices[ind].tangent[0]);
+        out.buffer_data.push_back(vertices[ind].tangent[1]);
+        out.buffer_data.push_back(vertices[ind].tangent[2]);
+
+        out.buffer_data.push_back(vertices[ind].bitangent[0]);
+        out.buffer_data.push_back(vertices[ind].bitangent[1]);
+        out.buffer_data.push_back(vertices[ind].bitangent[2]);
+
+        out.buffer_data.push_back(vertices[ind].texpos[0]);
+        out.buffer_data.push_back(vertices[ind].texpos[1]);
+    }
+    return out;
+}
+
+void obj::weldVertices(ShapeBuffer& shape, float epsilon) {
+    using Key = std::array<int64_t, GeomSizeAndStride>;
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const noexcept {
+            // FNV-1a over the quantized attributes
+            uint64_t h = 14695981039346656037ull;
+            for(int64_t k : key) {
+                h ^= static_cast<uint64_t>(k);
+                h *= 1099511628211ull;
+            }
+            return static_cast<std::size_t>(h ^ (h >> 32));
+        }
+    };
+
+    const std::size_t nVertices = shape.buffer_data.size() / GeomSizeAndStride;
+    const float invEpsilon = epsilon > 0.f ? 1.f / epsilon : 0.f;
+
+    std::unordered_map<Key, GLuint, KeyHash> unique;
+    unique.reserve(nVertices);
+    std::vector<GLuint> remap(nVertices);
+    std::vector<GLfloat> welded;
+    welded.reserve(shape.buffer_data.size());
+
+    for(std::size_t v = 0; v < nVertices; ++v) {
+        const GLfloat* attribs = &shape.buffer_data[v * GeomSizeAndStride];
+        Key key;
+        for(std::size_t i = 0; i < GeomSizeAndStride; ++i) {
+            float x = attribs[i];
+            if(epsilon > 0.f && std::isfinite(x)) {
+                key[i] = std::llround(x * invEpsilon);
+            } else {
+                uint32_t bits;
+                x = (x == 0.f ? 0.f : x); // -0 and 0 are the same vertex
+                std::memcpy(&bits, &x, sizeof(bits));
+                key[i] = bits;
+            }
+        }
+
+        auto inserted = unique.emplace(key, static_cast<GLuint>(welded.size() / GeomSizeAndStride));
+        if(inserted.second)
+            welded.insert(welded.end(), attribs, attribs + GeomSizeAndStride);
+        remap[v] = inserted.first->second;
+    }
+
+    for(auto& e : shape.elements)
+        e = remap[e];
+    shape.buffer_data.swap(welded);
+}
+
@@ -0,0 +1,78 @@
+/**
+ * @file obj_loader.h
+ * @brief multithreaded wavefront obj importer. Produces tinyobj data structures.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_OBJ_LOADER_H
+#define SSRE_OBJ_LOADER_H
+
+#include <string>
+#include <vector>
+
+#include <ssre_gl.h>
+#include <thread_pool.h>
+#include <tiny_obj_loader.h>
+
+namespace ssre::obj {
+
+/**
+ * @brief Parsed obj file contents
+ */
+struct ObjFile {
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+};
+
+/**
+ * @brief Load and parse an obj file. The file is read into memory and split into line aligned chunks
+ * which are parsed concurrently on pool. Polygons are triangulated as fans, so each face in the output has
+ * 3 vertices. Shapes are split on 'o' and 'g', materials are read with tinyobj::LoadMtl relative to mtlBaseDir.
+ *
+ * @param out parsed data
+ * @param path obj file path
+ * @param mtlBaseDir directory containing mtl files, terminated in /
+ * @param pool workers to use for parsing
+ * @param warn
+ * @param err
+ * @return true file was loaded
+ * @return false file could not be read, err has details
+ */
+bool loadObj(ObjFile& out, const std::string& path, const std::string& mtlBaseDir, util::ThreadPool& pool, std::string& warn, std::string& err);
+
+/**
+ * @brief Interleaved vertex data for a single shape, GeomSizeAndStride floats per vertex.
+ */
+struct ShapeBuffer {
+    std::vector<GLfloat> buffer_data;
+    std::vector<GLuint> elements;   // indices into buffer_data, counted from the first vertex of this shape
+    int material_id = -1;           // obj material id of the first face
+    bool missingNormals = false;
+    bool missingTexcoords = false;
+};
+
+/**
+ * @brief Build per vertex tangent frames and the interleaved vertex buffer for one shape. Only reads
+ * from attrib and shape, so shapes can be processed concurrently.
+ *
+ * @param attrib
+ * @param shape triangulated shape
+ * @return ShapeBuffer
+ */
+ShapeBuffer buildShapeBuffer(const tinyobj::attrib_t& attrib, const tinyobj::shape_t& shape);
+
+/**
+ * @brief Merge vertices of shape with identical position, tangent, bitangent and texture coordinate and
+ * rewrite the elements to index the remaining vertices.
+ *
+ * @param shape
+ * @param epsilon when > 0, attributes are quantized to a grid of this size before comparing. 0 welds exact matches only
+ */
+void weldVertices(ShapeBuffer& shape, float epsilon = 0.f);
+
+} // ssre::obj
+
+#endif // SSRE_OBJ_LOADER_H
@@ -0,0 +1,235 @@
+/**
+ * @file profiler.cpp
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+
+#include <profiler.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <cstdint>
+
+#include <ssre.h>
+
+using namespace ssre;
+
+namespace {
+
+void writeJsonString(std::ostream& out, const char* s) {
+    out << '"';
+    for(; *s; ++s) {
+        if(*s == '"' || *s == '\\')
+            out << '\\';
+        out << *s;
+    }
+    out << '"';
+}
+
+void writeTraceEvent(std::ostream& out, bool& first, const char* name, const char* category, uint32_t thread, double start, double duration) {
+    out << (first ? "\n" : ",\n") << "{\"name\":";
+    writeJsonString(out, name);
+    out << ",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread
+        << ",\"ts\":" << start * 1e6 << ",\"dur\":" << duration * 1e6 << "}";
+    first = false;
+}
+
+}
+
+Profiler::Profiler(size_t historySize) :
+    epoch{std::chrono::steady_clock::now()},
+    history(std::max<size_t>(historySize, 1)) {
+
+}
+
+Profiler::~Profiler() {
+    for(QueryFrame& q : queryFrames) {
+        if(!q.queries.empty())
+            glDeleteQueries(static_cast<GLsizei>(q.queries.size()), q.queries.data());
+    }
+}
+
+void Profiler::beginFrame() {
+    if(!enabled || inFrame)
+        return;
+    inFrame = true;
+
+    FrameProfile& f = history[frameIndex % history.size()];
+    f.frame = frameIndex;
+    f.start = now();
+    f.duration = 0.;
+    f.cpu.clear();
+    f.gpu.clear();
+    f.gpuReady = false;
+    openScopes.clear();
+
+    // results of the frame that last used this slot, QueryLatency frames ago
+    QueryFrame& q = queryFrames[frameIndex % (QueryLatency + 1)];
+    if(q.used > 0)
+        readQueries(q);
+    q.frame = frameIndex;
+    q.used = 0;
+}
+
+void Profiler::endFrame() {
+    if(!inFrame)
+        return;
+    while(!openScopes.empty())
+        endScope();
+    if(gpuOpen)
+        endGpuScope();
+
+    FrameProfile& f = history[frameIndex % history.size()];
+    f.duration = now() - f.start;
+    if(queryFrames[frameIndex % (QueryLatency + 1)].used == 0)
+        f.gpuReady = true;
+    inFrame = false;
+    ++frameIndex;
+}
+
+void Profiler::beginScope(const char* name) {
+    if(!enabled || !inFrame)
+        return;
+    FrameProfile& f = history[frameIndex % history.size()];
+    openScopes.push_back(f.cpu.size());
+    f.cpu.push_back(ProfileEvent{name, now(), 0., static_cast<uint32_t>(openScopes.size() - 1)});
+}
+
+void Profiler::endScope() {
+    if(openScopes.empty())
+        return;
+    ProfileEvent& e = history[frameIndex % history.size()].cpu[openScopes.back()];
+    e.duration = now() - e.start;
+    openScopes.pop_back();
+}
+
+void Profiler::beginGpuScope(const char* name) {
+    if(!enabled || !inFrame)
+        return;
+    SSRE_CHECK_THROW(!gpuOpen, "Gpu profile scopes cannot nest");
+
+    QueryFrame& q = queryFrames[frameIndex % (QueryLatency + 1)];
+    if(q.used == q.queries.size()) {
+        q.queries.push_back(0);
+        glGenQueries(1, &q.queries.back());
+    }
+    glBeginQuery(GL_TIME_ELAPSED, q.queries[q.used++]);
+    gpuOpen = true;
+
+    history[frameIndex % history.size()].gpu.push_back(ProfileEvent{name, now(), 0., 0});
+}
+
+void Profiler::endGpuScope() {
+    if(!gpuOpen)
+        return;
+    glEndQuery(GL_TIME_ELAPSED);
+    gpuOpen = false;
+}
+
+void Profiler::readQueries(QueryFrame& q) {
+    // blocks only if the gpu is more than QueryLatency frames behind
+    FrameProfile& f = history[q.frame % history.size()];
+    const bool inHistory = f.frame == q.frame && f.gpu.size() == q.used;
+    double end = 0.;
+    for(size_t i = 0; i < q.used; ++i) {
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(q.queries[i], GL_QUERY_RESULT, &elapsed);
+        if(!inHistory)
+            continue;
+        // elapsed time has no start, passes are placed after their submission and the previous pass
+        ProfileEvent& e = f.gpu[i];
+        e.start = std::max(e.start, end);
+        e.duration = elapsed * 1e-9;
+        end = e.start + e.duration;
+    }
+    if(inHistory)
+        f.gpuReady = true;
+}
+
+void Profiler::resolveQueries() {
+    for(QueryFrame& q : queryFrames) {
+        if(q.used > 0 && q.frame < frameIndex) {
+            readQueries(q);
+            q.used = 0;
+        }
+    }
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) const {
+    std::ofstream out{path};
+    if(!out)
+        return false;
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = false;
+    out << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"cpu\"}}";
+    out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"gpu\"}}";
+    for(size_t i = 0; i < getFrameCount(); ++i) {
+        const FrameProfile& f = getFrame(i);
+        writeTraceEvent(out, first, "frame", "frame", 1, f.start, f.duration);
+        for(const ProfileEvent& e : f.cpu)
+            writeTraceEvent(out, first, e.name, "cpu", 1, e.start, e.duration);
+        if(f.gpuReady) {
+            for(const ProfileEvent& e : f.gpu)
+                writeTraceEvent(out, first, e.name, "gpu", 2, e.start, e.duration);
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+bool Profiler::writeCsv(const std::string& path) const {
+    std::ofstream out{path};
+    if(!out)
+        return false;
+
+    // durations of each scope name per frame, scopes entered several times in a frame are summed
+    std::vector<std::pair<std::string, std::vector<double>>> rows;
+    std::map<std::string, size_t> rowIndex;
+    std::vector<size_t> lastFrames;
+    auto record = [&](const std::string& key, size_t frame, double duration) {
+        auto it = rowIndex.find(key);
+        if(it == rowIndex.end()) {
+            it = rowIndex.emplace(key, rows.size()).first;
+            rows.emplace_back(key, std::vector<double>{});
+            lastFrames.push_back(SIZE_MAX);
+        }
+        std::vector<double>& values = rows[it->second].second;
+        if(lastFrames[it->second] != frame) {
+            values.push_back(0.);
+            lastFrames[it->second] = frame;
+        }
+        values.back() += duration;
+    };
+
+    for(size_t i = 0; i < getFrameCount(); ++i) {
+        const FrameProfile& f = getFrame(i);
+        record("frame", i, f.duration);
+        for(const ProfileEvent& e : f.cpu)
+            record(std::string{"cpu,"} + e.name, i, e.duration);
+        if(f.gpuReady) {
+            for(const ProfileEvent& e : f.gpu)
+                record(std::string{"gpu,"} + e.name, i, e.duration);
+        }
+    }
+
+    out << std::fixed << std::setprecision(4);
+    out << "type,name,count,mean_ms,min_ms,max_ms,p95_ms\n";
+    for(auto& row : rows) {
+        std::vector<double>& values = row.second;
+        std::sort(values.begin(), values.end());
+        double sum = 0.;
+        for(double v : values)
+            sum += v;
+        const size_t p95 = static_cast<size_t>(std::ceil(0.95 * values.size())) - 1;
+        out << (row.first == "frame" ? "frame,frame" : row.first) << ',' << values.size() << ','
+            << sum / values.size() * 1e3 << ',' << values.front() * 1e3 << ',' << values.back() * 1e3 << ',' << values[p95] * 1e3 << '\n';
+    }
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,138 @@
+/**
+ * @file render_queue.cpp
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <render_queue.h>
+
+#include <algorithm>
+
+#include <renderer.h>
+
+using namespace ssre;
+
+namespace {
+
+constexpr uint32_t DepthBits = 16;
+constexpr uint32_t VaoBits = 16;
+constexpr uint32_t MaterialBits = 20;
+constexpr uint32_t ProgramBits = 10;
+
+constexpr uint32_t VaoShift = DepthBits;
+constexpr uint32_t MaterialShift = VaoShift + VaoBits;
+constexpr uint32_t ProgramShift = MaterialShift + MaterialBits;
+constexpr uint32_t PassShift = ProgramShift + ProgramBits;
+
+constexpr uint64_t mask(uint32_t bits) {
+    return (uint64_t{1} << bits) - 1;
+}
+
+uint64_t field(uint64_t key, uint32_t shift, uint32_t bits) {
+    return (key >> shift) & mask(bits);
+}
+
+} // namespace
+
+void RenderQueue::push(RenderPass pass, uint32_t program, uint32_t material, GLuint vao, float depth, Drawable* drawable, uint32_t object, uint64_t batch) {
+    const float d = std::clamp(depth * depthScale, 0.f, 1.f);
+    const uint64_t depthKey = static_cast<uint64_t>(d * mask(DepthBits));
+
+    const uint64_t key =
+        (uint64_t(pass) << PassShift) |
+        ((program & mask(ProgramBits)) << ProgramShift) |
+        ((material & mask(MaterialBits)) << MaterialShift) |
+        ((vao & mask(VaoBits)) << VaoShift) |
+        depthKey;
+    commands.push_back(RenderCommand{key, drawable, object, drawableIndex, batch});
+}
+
+void RenderQueue::sort() {
+    // lsd radix sort on 8 bit digits
+    scratch.resize(commands.size());
+    for(uint32_t shift = 0; shift < 64; shift += 8) {
+        size_t counts[256] = {};
+        for(const auto& c : commands)
+            counts[(c.key >> shift) & 0xff]++;
+
+        // all keys share this digit
+        if(counts[(commands.empty() ? 0 : commands[0].key >> shift) & 0xff] == commands.size())
+            continue;
+
+        size_t offset = 0;
+        for(auto& count : counts) {
+            size_t n = count;
+            count = offset;
+            offset += n;
+        }
+        for(const auto& c : commands)
+            scratch[counts[(c.key >> shift) & 0xff]++] = c;
+        commands.swap(scratch);
+    }
+}
+
+RenderStats RenderQueue::countStateChanges(const uint8_t* visible) const noexcept {
+    RenderStats stats{};
+    bool first = true;
+    uint64_t prev = 0;
+    for(const auto& c : commands) {
+        if(visible && !visible[c.index])
+            continue;
+        const uint64_t key = c.key;
+        const bool programChanged = first || field(key, ProgramShift, ProgramBits + 2) != field(prev, ProgramShift, ProgramBits + 2);
+        if(programChanged)
+            stats.programChanges++;
+        // program changes reset material and vao state
+        if(programChanged || field(key, MaterialShift, MaterialBits) != field(prev, MaterialShift, MaterialBits))
+            stats.materialChanges++;
+        if(programChanged || field(key, VaoShift, VaoBits) != field(prev, VaoShift, VaoBits))
+            stats.vaoChanges++;
+        stats.draws++;
+        first = false;
+        prev = key;
+    }
+    return stats;
+}
+
+void RenderQueue::buildDraws(const uint8_t* visible, std::vector<InstanceData>& instances, std::vector<gl::DrawElementsIndirectCommand>& indirect, std::vector<RenderDraw>& draws) const {
+    // first command of the current instanced run, the run is always in draws.back()
+    const RenderCommand* run = nullptr;
+    bool runIndirect = false;
+    for(const auto& c : commands) {
+        if(visible && !visible[c.index])
+            continue;
+
+        if(c.batch == 0) {
+            draws.push_back(RenderDraw{&c, 0, 0, 0, 0});
+            run = nullptr;
+            continue;
+        }
+
+        // continue the current run or start a new one
+        if(run == nullptr || run->batch != c.batch || run->key != c.key) {
+            run = &c;
+            const uint32_t firstInstance = static_cast<uint32_t>(instances.size());
+            gl::DrawElementsIndirectCommand cmd;
+            runIndirect = c.drawable->writeIndirect(c.object, cmd);
+            if(runIndirect) {
+                cmd.instanceCount = 0;
+                cmd.baseInstance = firstInstance;
+                // a run with the same pass, program, material and vao continues the previous multi draw
+                const bool merge = !draws.empty() && draws.back().indirectCount > 0 &&
+                    field(draws.back().command->key, VaoShift, 64 - VaoShift) == field(c.key, VaoShift, 64 - VaoShift);
+                if(!merge)
+                    draws.push_back(RenderDraw{&c, firstInstance, 0, static_cast<uint32_t>(indirect.size()), 0});
+                draws.back().indirectCount++;
+                indirect.push_back(cmd);
+            } else {
+                draws.push_back(RenderDraw{&c, firstInstance, 0, 0, 0});
+            }
+        }
+        instances.emplace_back();
+        c.drawable->writeInstance(c.object, instances.back());
+        draws.back().instanceCount++;
+        if(runIndirect)
+            indirect.back().instanceCount++;
+    }
+}
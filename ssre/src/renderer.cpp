@@ -11,6 +11,9 @@
 
 #include <renderer.h>
 
+#include <algorithm>
+#include <cstring>
+
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/string_cast.hpp>
 
@@ -21,44 +24,75 @@
 #include <skysphere.h>
 #include <window.h>
 #include <texture.h>
+#include <shadow.h>
+#include <resource.h>
+#include <texture_streamer.h>
+#include <material_table.h>
 
 using namespace ssre;
+
+namespace {
+
+// uniforms and shader parameters set once per program in the depth and color passes
+const UniformHandle ShadowFaceMatrices{mat_spec::ShadowFaceMatricesName};
+const UniformHandle ShadowFaceMask{mat_spec::ShadowFaceMaskName};
+const UniformHandle ShadowMapSampler{mat_spec::ShadowMapSamplerName};
+const UniformHandle LightFarPlane{"lightFarPlane"};
+const UniformHandle LightNearPlane{"lightNearPlane"};
+const UniformHandle LightPosition{"lightPos"};
+const UniformHandle SamplingRadius{"SamplingRadius"};
+
+}
 //////////////////////////////////////////////////////////////////////////
 
-Renderer::Renderer() : 
-    renderInfo{std::make_unique<RenderInfo>()},
-    globalUBO{std::make_unique<Buffer>(gl::BindingTarget::UNIFORM, gl::Usage::DYNAMIC_DRAW)} {
+void Drawable::enqueue(RenderQueue& queue, RenderPass pass, const glm::mat4& /*viewMatrix*/) {
+    const auto& program = pass == RenderPass::Color ? getColorProgram() : getDepthProgram();
+    if(program)
+        queue.push(pass, program->program_id, 0, 0, 0.f, this, 0);
+}
 
-    // create depth cubemaps
-    for(int i = 0; i < mat_spec::GUBMaxNumLights; i++) {
-        depthTexs.push_back(std::make_unique<Texture3D>("depthTex"));
-    }
+void Drawable::draw(RenderPass pass, uint32_t /*object*/, DrawState& state) {
+    if(pass == RenderPass::Color)
+        drawColor();
+    else
+        drawDepth();
+    // unknown bindings after a full draw
+    state = DrawState{};
+    state.drawable = this;
+}
 
-    // config depth textures
-    for(auto& depthTex : depthTexs) {
-        depthTex->setFilterMode(gl::TextureParamFilter::TEXTURE_MIN_FILTER, gl::TextureFilterMode::NEAREST);
-        depthTex->setFilterMode(gl::TextureParamFilter::TEXTURE_MAG_FILTER, gl::TextureFilterMode::NEAREST);
-        depthTex->setWrapMode(gl::TextureParamWrap::TEXTURE_WRAP_S, gl::TextureWrapMode::CLAMP_TO_EDGE);
-        depthTex->setWrapMode(gl::TextureParamWrap::TEXTURE_WRAP_T, gl::TextureWrapMode::CLAMP_TO_EDGE);
-        depthTex->setWrapMode(gl::TextureParamWrap::TEXTURE_WRAP_R, gl::TextureWrapMode::CLAMP_TO_EDGE);
-
-        // allocate depth cube map
-        for(uint32_t i = 0; i < 6; i++)
-            depthTex->setData(nullptr, gl::PixelFormat::DEPTH_COMPONENT, gl::PixelType::FLOAT, gl::TextureInternalFormat::DEPTH_COMPONENT16, DepthMapWidth, DepthMapHeight, i);
-    }
+bool Drawable::getWorldBounds(BoundingSphere& /*sphere*/) const {
+    return false;
+}
 
-    // create depth frame buffers
-    lightDepthFbs.resize(mat_spec::GUBMaxNumLights);
-    glGenFramebuffers(10, lightDepthFbs.data());
-    for(int i = 0; i < mat_spec::GUBMaxNumLights; i++) {
-        glBindFramebuffer(GL_FRAMEBUFFER, lightDepthFbs[i]);
-        glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthTexs[i]->getHandle(), 0);
-        glDrawBuffer(GL_NONE);
-        glReadBuffer(GL_NONE);
+void Drawable::writeInstance(uint32_t /*object*/, InstanceData& out) const {
+    out = InstanceData{glm::mat4{1.f}, 0, {}};
+}
 
-        SSRE_CHECK_THROW(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Light depth framebuffer is not complete!");
-    }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+void Drawable::drawInstanced(RenderPass pass, uint32_t object, uint32_t /*firstInstance*/, uint32_t instanceCount, DrawState& state) {
+    // not an instanced draw, the instance data is not read and every copy uses this drawable's own transform
+    for(uint32_t i = 0; i < instanceCount; ++i)
+        draw(pass, object, state);
+}
+
+bool Drawable::writeIndirect(uint32_t /*object*/, gl::DrawElementsIndirectCommand& /*out*/) const {
+    return false;
+}
+
+void Drawable::drawIndirect(RenderPass /*pass*/, uint32_t /*object*/, uint32_t /*firstIndirect*/, uint32_t /*indirectCount*/, DrawState& /*state*/) {
+    // only called for drawables that write indirect commands
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+Renderer::Renderer() : 
+    renderInfo{std::make_unique<RenderInfo>()},
+    globalUBO{std::make_unique<StreamBuffer>(gl::BindingTarget::UNIFORM, mat_spec::GUBSize + StreamBuffer::UniformOffsetAlignment())},
+    instanceBuffer{std::make_unique<StreamBuffer>(gl::BindingTarget::ARRAY, 4096 * sizeof(InstanceData))},
+    indirectBuffer{std::make_unique<StreamBuffer>(gl::BindingTarget::DRAW_INDIRECT, 4096 * sizeof(gl::DrawElementsIndirectCommand))},
+    shadowBuffer{std::make_unique<StreamBuffer>(gl::BindingTarget::SHADER_STORAGE, 64 * sizeof(ShadowRecord))},
+    shadows{std::make_unique<ShadowMaps>(ShadowAtlasSize, DepthMapWidth, ShadowTileMin, DepthMapNear, DepthMapFar)},
+    clusterBuffer{std::make_unique<StreamBuffer>(gl::BindingTarget::SHADER_STORAGE, sizeof(ClusterHeader) + clusters.getClusterCount() * (sizeof(glm::uvec2) + 8 * sizeof(uint32_t)))} {
     
     // enable z buffer testing
     glEnable(GL_DEPTH_TEST);
@@ -66,24 +100,30 @@ Renderer::Renderer() :
 
     glEnable(GL_CULL_FACE);
     glCullFace(GL_BACK);
-    
-    globalUBO->Allocate(mat_spec::GUBSize);
-    //glBindBufferBase(GL_UNIFORM_BUFFER, mat_spec::GUBBindingLocation, globalUBO->Handle());
-    glBindBufferRange(GL_UNIFORM_BUFFER, mat_spec::GUBBindingLocation, globalUBO->Handle(), 0, mat_spec::GUBSize);
 }
 
 Renderer::~Renderer() {
-    glDeleteFramebuffers(mat_spec::GUBMaxNumLights, lightDepthFbs.data());
+
 }
 
 void Renderer::render(float delta) {
     uint32_t programInUse = 0;
+    profiler.beginFrame();
+
+    // finish streamed textures before they are drawn
+    profiler.beginScope("texture uploads");
+    Resource::StaticInst().getTextureStreamer().update(TextureUploadBudget);
+    profiler.endScope();
 
     // update step
+    profiler.beginScope("update");
     scene->update(delta);
+    profiler.endScope();
 
     // prepare scene
+    profiler.beginScope("pre_render");
     scene->pre_render();
+    profiler.endScope();
 
     glm::vec3 camPos{};
     if(Camera* c = scene->getCamera().get()) {
@@ -91,71 +131,184 @@ void Renderer::render(float delta) {
         camPos = c->getPosition();
     }
 
-    globalUBO->SubData(viewMatrix, mat_spec::GUBViewMatOffset);
-    globalUBO->SubData(projectionMatrix, mat_spec::GUBProjectionMatOffset);
-    globalUBO->SubData(camPos, mat_spec::GUBCameraPosOffset);
-
-    // get lights
-    std::vector<glm::vec3> lpositions;
-    std::vector<glm::vec3> lcolors;
-    for(auto& node : scene->getNodes()) {
-        if(PointLight* p = dynamic_cast<PointLight*>(node.second.get())) {
-            lpositions.push_back({p->getModelMatrix() * glm::vec4{0, 0, 0, 1}});
-            lcolors.push_back(p->getRadiantIntensity());
-        }
+    // camera frustum culling against the scene spatial index
+    profiler.beginScope("culling");
+    const auto& drawables = scene->getDrawables();
+    const uint32_t nDrawables = static_cast<uint32_t>(drawables.size());
+    cullStats = CullStats{};
+    cameraVisible.resize(nDrawables);
+    cullStats.cameraVisible = scene->cull(Frustum{projectionMatrix * viewMatrix}, cameraVisible.data());
+    cullStats.cameraCulled = nDrawables - cullStats.cameraVisible;
+
+    // shadow tile assignment, caster culling and cache update, only lights with dirty faces are drawn
+    shadows->update(*scene, Frustum{projectionMatrix * viewMatrix}, camPos, projectionMatrix[1][1] * height * 0.5f);
+    const ShadowStats& shadowStats = shadows->getStats();
+    cullStats.shadowVisible = shadowStats.casterDraws;
+    cullStats.shadowCulled = shadowStats.lightsDrawn * nDrawables - shadowStats.casterDraws;
+    profiler.endScope();
+
+    // build and sort draw commands. The depth queue holds every caster, it is filtered per light during submission
+    profiler.beginScope("draw queues");
+    depthQueue.clear();
+    colorQueue.clear();
+    colorQueue.setDepthRange(DepthMapFar);
+    for(uint32_t i = 0; i < nDrawables; ++i) {
+        Drawable* d = drawables[i];
+        colorQueue.setDrawableIndex(i);
+        depthQueue.setDrawableIndex(i);
+        if(cameraVisible[i])
+            d->enqueue(colorQueue, RenderPass::Color, viewMatrix);
+        if(d->getDepthProgram() && shadowStats.lightsDrawn > 0)
+            d->enqueue(depthQueue, RenderPass::Depth, viewMatrix);
+    }
+
+    profiler.endScope();
+
+    // get lights and bin them into view clusters
+    profiler.beginScope("lights");
+    lights.clear();
+    lightSpheres.clear();
+    for(PointLight* p : scene->getLights()) {
+        const glm::vec3 position{p->getModelMatrix() * glm::vec4{0, 0, 0, 1}};
+        lights.push_back(ClusterLight{glm::vec4{position, p->getRange()}, glm::vec4{p->getRadiantIntensity(), 0.f}});
+        lightSpheres.push_back(lights.back().positionRange);
+    }
+    clusters.setProjection(projectionMatrix, width, height);
+    clusters.build(viewMatrix, lightSpheres, &Resource::StaticInst().getWorkers());
+    const size_t nLights = std::min<size_t>(lights.size(), mat_spec::GUBMaxNumLights);
+
+    // write the global block of this frame into the mapped stream buffer
+    const size_t globalOffset = globalUBO->allocate(mat_spec::GUBSize, StreamBuffer::UniformOffsetAlignment());
+    uint8_t* globals = static_cast<uint8_t*>(globalUBO->data(globalOffset));
+    const GLuint numLights = static_cast<GLuint>(nLights);
+    std::memcpy(globals + mat_spec::GUBViewMatOffset, &viewMatrix, sizeof(glm::mat4));
+    std::memcpy(globals + mat_spec::GUBProjectionMatOffset, &projectionMatrix, sizeof(glm::mat4));
+    std::memcpy(globals + mat_spec::GUBCameraPosOffset, &camPos, sizeof(glm::vec3));
+    std::memcpy(globals + mat_spec::GUBNumLightsOffset, &numLights, sizeof(GLuint));
+    // programs without cluster lookup shade the first lights
+    for(size_t i = 0; i < nLights; i++) {
+        std::memcpy(globals + mat_spec::GUBLightPositionsArrayOffset + i * mat_spec::GUBLightPositionsArrayStride, &lights[i].positionRange, mat_spec::GUBLightPositionElementSize);
+        std::memcpy(globals + mat_spec::GUBLightColorsOffset + i * mat_spec::GUBLightColorsArrayStride, &lights[i].color, mat_spec::GUBLightColorElementSize);
+    }
+    glBindBufferRange(GL_UNIFORM_BUFFER, mat_spec::GUBBindingLocation, globalUBO->Handle(), globalOffset, mat_spec::GUBSize);
+
+    // cluster grid, light lists and lights in one allocation, a second allocation could move the first.
+    // Empty lists still get a range since bound ranges must not be empty
+    {
+        const size_t align = StreamBuffer::StorageOffsetAlignment();
+        auto aligned = [align](size_t bytes) {return (bytes + align - 1) / align * align;};
+        const std::vector<glm::uvec2>& grid = clusters.getClusters();
+        const std::vector<uint32_t>& indices = clusters.getLightIndices();
+        const size_t gridBytes = sizeof(ClusterHeader) + grid.size() * sizeof(glm::uvec2);
+        const size_t indexBytes = std::max<size_t>(indices.size() * sizeof(uint32_t), sizeof(uint32_t));
+        const size_t lightBytes = std::max<size_t>(lights.size() * sizeof(ClusterLight), sizeof(ClusterLight));
+        const size_t offset = clusterBuffer->allocate(aligned(gridBytes) + aligned(indexBytes) + lightBytes, align);
+        const size_t indexOffset = offset + aligned(gridBytes);
+        const size_t lightOffset = indexOffset + aligned(indexBytes);
+        uint8_t* out = static_cast<uint8_t*>(clusterBuffer->data(offset));
+        std::memcpy(out, &clusters.getHeader(), sizeof(ClusterHeader));
+        std::memcpy(out + sizeof(ClusterHeader), grid.data(), grid.size() * sizeof(glm::uvec2));
+        if(!indices.empty())
+            std::memcpy(clusterBuffer->data(indexOffset), indices.data(), indices.size() * sizeof(uint32_t));
+        if(!lights.empty())
+            std::memcpy(clusterBuffer->data(lightOffset), lights.data(), lights.size() * sizeof(ClusterLight));
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, mat_spec::ClusterBufferBinding, clusterBuffer->Handle(), offset, gridBytes);
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, mat_spec::ClusterLightIndexBinding, clusterBuffer->Handle(), indexOffset, indexBytes);
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, mat_spec::LightBufferBinding, clusterBuffer->Handle(), lightOffset, lightBytes);
+    }
+
+    // shadow records of all lights
+    const std::vector<ShadowRecord>& shadowRecords = shadows->getRecords();
+    if(!shadowRecords.empty()) {
+        const size_t bytes = shadowRecords.size() * sizeof(ShadowRecord);
+        const size_t shadowOffset = shadowBuffer->write(shadowRecords.data(), bytes, StreamBuffer::StorageOffsetAlignment());
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, mat_spec::ShadowBufferBinding, shadowBuffer->Handle(), shadowOffset, bytes);
+    }
+
+    profiler.endScope();
+
+    // the depth queue is submitted once per light with dirty faces
+    profiler.beginScope("draw batching");
+    unsortedStats = colorQueue.countStateChanges();
+    for(uint32_t i = 0; i < shadows->getLightCount(); i++) {
+        if(shadows->getDirtyFaces(i))
+            unsortedStats += depthQueue.countStateChanges(shadows->getCasters(i));
+    }
+
+    colorQueue.sort();
+    depthQueue.sort();
+
+    sortedStats = colorQueue.countStateChanges();
+    for(uint32_t i = 0; i < shadows->getLightCount(); i++) {
+        if(shadows->getDirtyFaces(i))
+            sortedStats += depthQueue.countStateChanges(shadows->getCasters(i));
+    }
+
+    // merge batched commands into instanced and multi draws, instance data and indirect commands of all passes go into one buffer each
+    instances.clear();
+    indirect.clear();
+    colorDraws.clear();
+    depthDraws.clear();
+    lightDrawOffsets.assign(1, 0);
+    colorQueue.buildDraws(nullptr, instances, indirect, colorDraws);
+    for(uint32_t i = 0; i < shadows->getLightCount(); i++) {
+        if(shadows->getDirtyFaces(i))
+            depthQueue.buildDraws(shadows->getCasters(i), instances, indirect, depthDraws);
+        lightDrawOffsets.push_back(depthDraws.size());
     }
-    size_t nLights = std::min<size_t>(lpositions.size(), mat_spec::GUBMaxNumLights);
-    lpositions.resize(mat_spec::GUBMaxNumLights);
-    lcolors.resize(mat_spec::GUBMaxNumLights);
-
-    // depth pass
-    glViewport(0, 0, DepthMapWidth, DepthMapHeight);
-    // enable hardware depth biasing
-    glEnable(GL_POLYGON_OFFSET_FILL);
-    glPolygonOffset(1.1f, 4.0f);
-    for(uint32_t i = 0; i < nLights; i++) {
-
-        glBindFramebuffer(GL_FRAMEBUFFER, lightDepthFbs[i]);
-        glClear(GL_DEPTH_BUFFER_BIT);
-        glm::vec3 lpos = lpositions[i];
-
-        // create light space matrices
-        lightMatrices.clear();
-        glm::mat4 lproj = glm::perspective(0.5f*glm::pi<float>(), (float)(DepthMapWidth)/DepthMapHeight, DepthMapNear, DepthMapFar);
-        lightMatrices.push_back(lproj*glm::lookAt(lpos, lpos + glm::vec3{1, 0, 0}, {0, -1, 0}));
-        lightMatrices.push_back(lproj*glm::lookAt(lpos, lpos + glm::vec3{-1, 0, 0}, {0, -1, 0}));
-        lightMatrices.push_back(lproj*glm::lookAt(lpos, lpos + glm::vec3{0, 1, 0}, {0, 0, 1}));
-        lightMatrices.push_back(lproj*glm::lookAt(lpos, lpos + glm::vec3{0, -1, 0}, {0, 0, -1}));
-        lightMatrices.push_back(lproj*glm::lookAt(lpos, lpos + glm::vec3{0, 0, 1}, {0, -1, 0}));
-        lightMatrices.push_back(lproj*glm::lookAt(lpos, lpos + glm::vec3{0, 0, -1}, {0, -1, 0}));
+    sortedStats.drawCalls = static_cast<uint32_t>(colorDraws.size() + depthDraws.size());
+    DrawState frameState;
+    if(!instances.empty())
+        frameState.instanceOffset = instanceBuffer->write(instances.data(), instances.size() * sizeof(InstanceData), sizeof(InstanceData));
+    if(!indirect.empty())
+        frameState.indirectOffset = indirectBuffer->write(indirect.data(), indirect.size() * sizeof(gl::DrawElementsIndirectCommand), sizeof(gl::DrawElementsIndirectCommand));
+    // handles are read after writing, a write may replace the buffer
+    frameState.instanceBuffer = instanceBuffer->Handle();
+    // draw indirect binding is global state, bound for both passes
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer->Handle());
+    profiler.endScope();
+
+    // depth pass, dirty faces of all lights are drawn into their atlas tiles
+    profiler.beginScope("depth pass");
+    profiler.beginGpuScope("depth pass");
+    shadows->beginRender();
+    for(uint32_t i = 0; i < shadows->getLightCount(); i++) {
+        const uint8_t dirtyFaces = shadows->getDirtyFaces(i);
+        if(!dirtyFaces)
+            continue;
+        const glm::vec3& lpos = shadows->getLightPosition(i);
+        shadows->setViewports(i);
 
         programInUse = 0;
-        for(auto& drawable : scene->getNodes()) {
-            if(Drawable* d = dynamic_cast<Drawable*>(drawable.second.get())) {
-                if(d->getDepthProgram()) {
-                    if(programInUse != d->getDepthProgram()->program_id) {
-                        programInUse = d->getDepthProgram()->program_id;
-                        d->getDepthProgram()->setShaderParameter("SM[0]", lightMatrices);
-                        d->getDepthProgram()->setShaderParameter("lightFarPlane", (float)DepthMapFar);
-                        d->getDepthProgram()->setShaderParameter("lightNearPlane", (float)DepthMapNear);
-                        d->getDepthProgram()->use();
-                        // uniform vec3 lightPos;
-                        // uniform float far_plane;
-                        glUniform3fv(d->getDepthProgram()->getUniformInfo("lightPos").Location, 1, &lpos[0]);
-                    }
-                    d->drawDepth();
-                }
+        DrawState state;
+        for(size_t draw = lightDrawOffsets[i]; draw < lightDrawOffsets[i + 1]; ++draw) {
+            const RenderDraw& rd = depthDraws[draw];
+            Drawable* d = rd.command->drawable;
+            if(programInUse != d->getDepthProgram()->program_id) {
+                programInUse = d->getDepthProgram()->program_id;
+                d->getDepthProgram()->setShaderParameter(ShadowFaceMatrices, shadows->getFaceMatrices(i));
+                d->getDepthProgram()->setShaderParameter(ShadowFaceMask, (GLuint)dirtyFaces);
+                d->getDepthProgram()->setShaderParameter(LightFarPlane, (float)DepthMapFar);
+                d->getDepthProgram()->setShaderParameter(LightNearPlane, (float)DepthMapNear);
+                d->getDepthProgram()->use();
+                // uniform vec3 lightPos;
+                // uniform float far_plane;
+                glUniform3fv(d->getDepthProgram()->getUniformLocation(LightPosition), 1, &lpos[0]);
+                state = frameState;
             }
+            if(rd.indirectCount > 0)
+                d->drawIndirect(RenderPass::Depth, rd.command->object, rd.firstIndirect, rd.indirectCount, state);
+            else if(rd.instanceCount > 0)
+                d->drawInstanced(RenderPass::Depth, rd.command->object, rd.firstInstance, rd.instanceCount, state);
+            else
+                d->draw(RenderPass::Depth, rd.command->object, state);
         }
+        glBindVertexArray(0);
     }
-    glDisable(GL_POLYGON_OFFSET_FILL);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    shadows->endRender(targetFramebuffer);
+    profiler.endGpuScope();
+    profiler.endScope();
 
-   
-    // update point light positions
-    globalUBO->SubData(lpositions, mat_spec::GUBLightPositionsArrayOffset, mat_spec::GUBLightPositionsArrayStride);
-    globalUBO->SubData(lcolors, mat_spec::GUBLightColorsOffset, mat_spec::GUBLightColorsArrayStride);
-    globalUBO->SubData<GLuint>(nLights, mat_spec::GUBNumLightsOffset);
 
     static float SamplerDiskRadius = 0.1;
     if(Window::StaticInst().arrow_up) {
@@ -167,32 +320,54 @@ void Renderer::render(float delta) {
         std::cout << "SamplerDiskRadius: " << SamplerDiskRadius << std::endl;
     }
 
+    // textures of materials enqueued this frame
+    profiler.beginScope("material table");
+    MaterialTable& materialTable = Resource::StaticInst().getMaterialTable();
+    materialTable.update();
+    materialTable.bind();
+    profiler.endScope();
+
     // color pass
+    profiler.beginScope("color pass");
+    profiler.beginGpuScope("color pass");
     glViewport(0, 0, width, height);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     programInUse = 0;
-    for(auto& drawable : scene->getNodes()) {
-        if(Drawable* d = dynamic_cast<Drawable*>(drawable.second.get())) {
-            if(programInUse != d->getColorProgram()->program_id) {
-                programInUse = d->getColorProgram()->program_id;
-                d->getColorProgram()->setShaderParameter("lightFarPlane", (float)DepthMapFar);
-                d->getColorProgram()->setShaderParameter("lightNearPlane", (float)DepthMapNear);
-                d->getColorProgram()->use();
-
-                glUniform1f(d->getColorProgram()->getUniformInfo("SamplingRadius").Location, SamplerDiskRadius);
-
-                for(uint32_t light = 0; light < nLights; light++) {
-                    glUniform1i(d->getColorProgram()->getUniformInfo("lightDepthTex[0]").Location + light, 10 + light);
-                    glActiveTexture(gl::TextureUnit[10 + light]);
-                    depthTexs[light]->bind();
-                }
-            }
-            d->drawColor();
+    DrawState state;
+    for(const RenderDraw& rd : colorDraws) {
+        Drawable* d = rd.command->drawable;
+        if(programInUse != d->getColorProgram()->program_id) {
+            programInUse = d->getColorProgram()->program_id;
+            d->getColorProgram()->setShaderParameter(LightFarPlane, (float)DepthMapFar);
+            d->getColorProgram()->setShaderParameter(LightNearPlane, (float)DepthMapNear);
+            d->getColorProgram()->use();
+
+            glUniform1f(d->getColorProgram()->getUniformLocation(SamplingRadius), SamplerDiskRadius);
+
+            glUniform1i(d->getColorProgram()->getUniformLocation(ShadowMapSampler), mat_spec::ShadowMapTextureUnit);
+            glActiveTexture(gl::TextureUnit[mat_spec::ShadowMapTextureUnit]);
+            shadows->getAtlas().bind();
+            state = frameState;
         }
+        if(rd.indirectCount > 0)
+            d->drawIndirect(RenderPass::Color, rd.command->object, rd.firstIndirect, rd.indirectCount, state);
+        else if(rd.instanceCount > 0)
+            d->drawInstanced(RenderPass::Color, rd.command->object, rd.firstInstance, rd.instanceCount, state);
+        else
+            d->draw(RenderPass::Color, rd.command->object, state);
     }
+    glBindVertexArray(0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    profiler.endGpuScope();
+    profiler.endScope();
 
     if(scene->getSkySphere()) {
+        ProfileScope skyScope{profiler, "sky pass", true};
         scene->getSkySphere()->getColorProgram()->use();
         scene->getSkySphere()->drawColor();
     }
+
+    // fence this frame's stream buffer regions
+    StreamBuffer::EndFrame();
+    profiler.endFrame();
 }
\ No newline at end of file
@@ -11,22 +11,45 @@
 
 #include <iostream>
 #include <vector>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <filesystem>
 
 #include <resource.h>
 #include <texture.h>
 #include <geometry.h>
+#include <geometry_arena.h>
 #include <material.h>
+#include <material_table.h>
+#include <texture_streamer.h>
+#include <texture_cache.h>
 
+// worker threads decode textures, the global failure string is not thread safe
+#define STBI_NO_FAILURE_STRINGS
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
 #include <tiny_obj_wrapper.h>
+#include <thread_pool.h>
+#include <obj_loader.h>
+#include <mesh_cache.h>
+#include <mesh_optimize.h>
 
 #include <glm/gtx/string_cast.hpp>
 
 using namespace ssre;
 
-Resource::Resource(std::string assetPath) : assetPath{std::move(assetPath)} {
+Resource::Resource(std::string assetPath) :
+    geometryArena{std::make_unique<GeometryArena>()},
+    materialTable{std::make_unique<MaterialTable>()},
+    workers{std::make_unique<util::ThreadPool>()},
+    textureStreamer{std::make_unique<TextureStreamer>(*workers)},
+    textureCompression{TextureCompression::None},
+    vertexFormat{VertexFormat::Float},
+    assetPath{std::move(assetPath)} {
     stbi_set_flip_vertically_on_load(true);
 }
 
@@ -34,6 +57,12 @@ Resource::~Resource() {
 
 }
 
+uint64_t Resource::importKey() const noexcept {
+    uint32_t epsilonBits;
+    std::memcpy(&epsilonBits, &weldEpsilon, sizeof(epsilonBits));
+    return uint64_t{epsilonBits} | (uint64_t{optimizeMeshes} << 32);
+}
+
 std::shared_ptr<Texture> Resource::getTexture(const std::string& name) {
     auto itr = textures.find(name);
     if(itr != textures.end()) {
@@ -42,11 +71,98 @@ std::shared_ptr<Texture> Resource::getTexture(const std::string& name) {
     return {};
 }
 
+void Resource::setTextureCompression(TextureCompression compression) {
+    if(!texcache::isSupported(compression)) {
+        std::cerr << "Resource: texture compression is not supported, textures are loaded uncompressed" << std::endl;
+        compression = TextureCompression::None;
+    }
+    textureCompression = compression;
+}
+
+size_t Resource::bakeTextures(TextureCompression compression, const std::string& directory) {
+    std::vector<std::filesystem::path> files;
+    std::error_code ec;
+    for(auto it = std::filesystem::recursive_directory_iterator{assetPath + directory, ec}; !ec && it != std::filesystem::recursive_directory_iterator{}; it.increment(ec)) {
+        std::string ext = it->path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) {return static_cast<char>(std::tolower(c));});
+        if(it->is_regular_file(ec) && (ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".tga" || ext == ".bmp"))
+            files.push_back(it->path());
+    }
+
+    // one image per worker, blocks of an image are compressed serially
+    std::atomic<size_t> baked{0};
+    workers->parallel_for(files.size(), [&](std::size_t i) {
+        std::string name = files[i].filename().string();
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) {return static_cast<char>(std::tolower(c));});
+        const TextureUsage usage = name.find("normal") != std::string::npos ? TextureUsage::Normal : TextureUsage::Color;
+
+        const std::string sourcePath = files[i].string();
+        texcache::CompressedImage image;
+        float error = 0.f;
+        if(!texcache::bake(sourcePath, compression, usage, nullptr, image, &error)) {
+            std::cerr << "Resource: unable to bake " << sourcePath << std::endl;
+            return;
+        }
+        if(!texcache::writeCache(sourcePath + texcache::FileExtension, sourcePath, compression, usage, image)) {
+            std::cerr << "Resource: unable to write texture cache " << sourcePath << texcache::FileExtension << std::endl;
+            return;
+        }
+        std::cout << "Resource: baked " << sourcePath << " as " << bc::formatName(image.format) << ", rms error " << error << std::endl;
+        ++baked;
+    });
+    return baked;
+}
+
+std::shared_ptr<Texture2D> Resource::loadCompressed2DTexture(const std::string& path, TextureUsage usage) {
+    texcache::CompressedImage image;
+    if(!texcache::load(assetPath + path, textureCompression, usage, workers.get(), image))
+        return {};
+
+    std::shared_ptr<Texture2D> tex = std::make_shared<Texture2D>(path);
+    for(uint32_t l = 0; l < image.levels.size(); ++l) {
+        const texcache::Level& level = image.levels[l];
+        tex->setCompressedData(image.data.data() + level.offset, bc::glFormat(image.format), level.width, level.height, level.size, l);
+    }
+    tex->bind();
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(image.levels.size() - 1));
+    glBindTexture(GL_TEXTURE_2D, 0);
+    tex->setFilterMode(gl::TextureParamFilter::TEXTURE_MIN_FILTER, gl::TextureFilterMode::LINEAR_MIPMAP_LINEAR);
+    return tex;
+}
+
+std::shared_ptr<Texture> Resource::load2DTextureAsync(const std::string& path) {
+    return load2DTextureAsync(path, TextureUsage::Color);
+}
+
+std::shared_ptr<Texture> Resource::load2DTextureAsync(const std::string& path, TextureUsage usage) {
+    if(path.empty())
+        return load2DTexture(path, usage);
+    std::shared_ptr<Texture> out = getTexture(path);
+    if(!out) {
+        std::shared_ptr<Texture2D> tex = std::make_shared<Texture2D>(path);
+        textureStreamer->load(tex, assetPath + path, textureCompression, usage);
+        out = tex;
+        textures.insert(std::make_pair(out->getName(), out));
+    }
+    return out;
+}
+
 std::shared_ptr<Texture> Resource::load2DTexture(const std::string& path) {
+    return load2DTexture(path, TextureUsage::Color);
+}
+
+std::shared_ptr<Texture> Resource::load2DTexture(const std::string& path, TextureUsage usage) {
     std::shared_ptr<Texture> out;
     bool error = false;
     if(!path.empty()) {
         out = getTexture(path);
+        if(!out && textureCompression != TextureCompression::None) {
+            // compressed textures have their mip chain baked
+            if(std::shared_ptr<Texture2D> tex = loadCompressed2DTexture(path, usage)) {
+                textures.insert(std::make_pair(tex->getName(), tex));
+                return tex;
+            }
+        }
         if(!out) {
             std::string file = assetPath + path;
             int width, height, nrChannels;
@@ -67,6 +183,8 @@ std::shared_ptr<Texture> Resource::load2DTexture(const std::string& path) {
                     std::cerr << "unable to load unsupported texture format." + file + " Channels:" + std::to_string(nrChannels) << std::endl;
                 }
                 stbi_image_free(image);
+                if(!error)
+                    tex->generateMipMap();
 
                 out = tex;
                 textures.insert(std::make_pair(out->getName(), out));
@@ -94,302 +212,166 @@ std::shared_ptr<Texture> Resource::load2DTexture(const std::string& path) {
                 }
             }
             tex->setData(err_data.data(), gl::PixelFormat::RGB, gl::PixelType::UNSIGNED_BYTE, gl::TextureInternalFormat::RGB, width, height);
+            tex->generateMipMap();
             out = tex;
             textures.insert(std::make_pair(error_tex_name, out));
         }
     }
-    out->generateMipMap();
     return out;
 }
 
 std::shared_ptr<Geometry> Resource::loadObj(const std::string& file, const std::string& baseDir) {
-    const float FaceDPCutoff = 0.7f; // prevent tangents from varying too much
     std::string fullName = baseDir + file;
     auto geom = geometries.find(fullName);
     if(geom == geometries.end()) {
         std::cout << "Resource: load " << fullName << std::endl;
-        tinyobj::attrib_t attrib;
-        std::vector<tinyobj::shape_t> shapes;
-        std::vector<tinyobj::material_t> mat_array;
-        std::string warn;
-        std::string err;
-        bool rc = tinyobj::LoadObj(&attrib, &shapes, &mat_array, &warn, &err, (assetPath + fullName).c_str(), (assetPath + baseDir).c_str());
-
-        struct Vertex {
-            glm::vec3 position{};
-            glm::vec3 tangent{};
-            glm::vec3 bitangent{};
-            glm::vec3 normal{};
-            glm::vec2 texpos{-1, -1};
-        };
-        std::vector<Vertex> vertices(attrib.vertices.size() / 3);
-
-        // each vertex has GeomSizeAndStride values associated with it
-        //std::vector<GLfloat> buffer_data((attrib.vertices.size() / 3) * GeomSizeAndStride);
-        std::vector<GLfloat> buffer_data;
-
-        SSRE_CHECK_THROW(rc, err);
+        auto startTime = std::chrono::steady_clock::now();
 
-        if (shapes.size() > 0) {
+        const std::string sourcePath = assetPath + fullName;
+        const std::string cachePath = sourcePath + meshcache::FileExtension;
 
+        // precooked geometry, the mapping is released once data is uploaded
+        meshcache::MeshView cached;
+        if(auto mapping = meshcache::openCache(cachePath, sourcePath, importKey(), cached)) {
             std::vector<MaterialInfo> materials;
             std::vector<DrawObject> objects;
 
-            // load materials
             materials.push_back(MaterialInfo{}); // default material at mat_id 0
-            for(auto& mat : mat_array) {
+            for(auto& mat : cached.materials) {
                 materials.push_back(MaterialInfo{tinyobj_wrapper::material_t{mat}, baseDir});
             }
 
-            // Loop over shapes
-            for (size_t s = 0; s < shapes.size(); ++s) {
-                // Loop over faces(polygon)
-                const std::size_t num_faces = shapes[s].mesh.num_face_vertices.size();
-
-                size_t index_offset = 0;
-                // num face vertices array size is number of faces in shape
-                std::vector<GLuint> element_data;
-                for (size_t f = 0; f < num_faces; f++) {
-                    // get all face info
-                    glm::vec3 verts[3] = {};
-                    bool normalsValid = false;
-                    glm::vec3 normals[3] = {};
-                    bool coordsValid = false;
-                    glm::vec2 coords[3] = {};
-                    glm::vec3 tans[3] = {};
-                    glm::vec3 bitans[3] = {};
-                    tinyobj::index_t indices[3] = {};
-                    for (size_t v = 0; v < 3; v++) {                    
-                        indices[v] = shapes[s].mesh.indices[index_offset + v];
-
-                        uint32_t vertex_index = 3*indices[v].vertex_index;
-                        uint32_t normal_index = 3*indices[v].normal_index;
-                        uint32_t tex_index = 2*indices[v].texcoord_index;
-
-                        assert(indices[v].vertex_index >= 0);
-
-                        verts[v] = {
-                            attrib.vertices[vertex_index+0],
-                            attrib.vertices[vertex_index+1],
-                            attrib.vertices[vertex_index+2]
-                        };
-
-                        if(attrib.normals.size() > 0) {
-                            if(normal_index >= 0) {
-                                normals[v] = {
-                                    attrib.normals[normal_index+0],
-                                    attrib.normals[normal_index+1],
-                                    attrib.normals[normal_index+2]
-                                };
-                                normals[v] = glm::normalize(normals[v]);
-                                normalsValid = true;
-                            } else {
-                                std::cerr << "Warn: vertex has no normal index" << std::endl;
-                            }
-                        } else {
-                            std::cout << "Warm: " << fullName << " has no normals" << std::endl;
-                        }
-
-                        if(attrib.texcoords.size() > 0) {
-                            if(tex_index >= 0) {
-                                coords[v] = {
-                                    attrib.texcoords[tex_index+0],
-                                    - attrib.texcoords[tex_index+1]
-                                };
-                                coordsValid = true;
-                            }
-                        } else {
-                            std::cout << "Warm: " << fullName << " has no texture coordinates" << std::endl;
-                        }
-                    }
-
-                    bool forceNewVert[3] = {};
-                    if(coordsValid) {
-                        glm::vec3 dp0 = verts[1] - verts[0];
-                        glm::vec3 dp1 = verts[2] - verts[0];
-
-                        glm::vec2 duv1 = coords[1] - coords[0];
-                        glm::vec2 duv0 = coords[2] - coords[0];
-
-                        float r = 1.f / (duv0.x*duv1.y - duv0.y*duv1.x);
-                        glm::vec3 ftangent = glm::normalize((dp0*duv1.y - dp1*duv0.y)*r);
-                        glm::vec3 fbitangent = glm::normalize((dp1*duv0.x - dp0*duv1.x)*r);
-
-                        // create normal corrected tangents and bitangents
-                        float n0dp = glm::dot(ftangent, normals[0]);
-                        float n1dp = glm::dot(ftangent, normals[1]);
-                        float n2dp = glm::dot(ftangent, normals[2]);
-
-                        glm::vec3 tangent[3];
-                        tangent[0] = glm::normalize(ftangent - n0dp * normals[0]);
-                        tangent[1] = glm::normalize(ftangent - n1dp * normals[1]);
-                        tangent[2] = glm::normalize(ftangent - n2dp * normals[2]);
-
-                        n0dp = glm::dot(fbitangent, normals[0]);
-                        n1dp = glm::dot(fbitangent, normals[1]);
-                        n2dp = glm::dot(fbitangent, normals[2]);
-
-                        glm::vec3 bitangent[3];
-                        // bitangent[0] = fbitangent - n0dp * normals[0];
-                        // bitangent[1] = fbitangent - n1dp * normals[1];
-                        // bitangent[2] = fbitangent - n2dp * normals[2];
-                        bitangent[0] = glm::normalize(glm::cross(normals[0], tangent[0]));
-                        bitangent[1] = glm::normalize(glm::cross(normals[1], tangent[1]));
-                        bitangent[2] = glm::normalize(glm::cross(normals[2], tangent[2]));
-
-                        // assign normal corrected tangents and bitangents
-                        tans[0] = tangent[0];
-                        tans[1] = tangent[1];
-                        tans[2] = tangent[2];
-                        bitans[0] = bitangent[0];
-                        bitans[1] = bitangent[1];
-                        bitans[2] = bitangent[2];
-                        // tans[0] = ftangent;
-                        // tans[1] = ftangent;
-                        // tans[2] = ftangent;
-                        // bitans[0] = fbitangent;
-                        // bitans[1] = fbitangent;
-                        // bitans[2] = fbitangent;
-
-                        glm::vec3 avgN = normals[0] + normals[1] + normals[2];
-                        avgN = glm::normalize(avgN);
-                        float avdp = glm::dot(glm::normalize(glm::cross(ftangent, fbitangent)), avgN);
-                        if(avdp < 0) {
-                            std::swap(tans[0], bitans[0]);
-                            std::swap(tans[1], bitans[1]);
-                            std::swap(tans[2], bitans[2]);
-                            std::swap(ftangent, fbitangent);
-                        }
-
-                        for (uint32_t v = 0; v < 3; v++){
-                            // mesh normal
-                            glm::vec3 n = glm::normalize(normals[v]);
-                            // existing normal
-                            glm::vec3 en = vertices[indices[v].vertex_index].normal;
-                            if(en != glm::vec3{0, 0, 0}) {
-                                float dp = 1;
-                                dp = glm::dot(en, n);
-                                // check if faces are different
-                                if(dp < 0.8) {
-                                    forceNewVert[v] = true;
-                                    continue;
-                                }
-                            }
-                            
-                            // check existing against texture coordinates
-                            if(vertices[indices[v].vertex_index].texpos != glm::vec2{-1, -1}) {
-                                // check if vertex texture coords differ from those at assigned index
-                                if(glm::length(vertices[indices[v].vertex_index].texpos - coords[v]) > 0.001) {
-                                    forceNewVert[v] = true;
-                                    continue;
-                                }
-                            }
-                        }
-
-                        
-
-                        // std::cout << "n0: " << glm::to_string(normals[0]) << std::endl;
-                        // std::cout << "n1: " << glm::to_string(normals[1]) << std::endl;
-                        // std::cout << "n2: " << glm::to_string(normals[2]) << std::endl;
-
-                        // std::cout << "fndp: " << glm::dot(glm::normalize(normals[0]), glm::normalize(glm::cross(tangent0, bitangent0))) << std::endl;
-                        // std::cout << "fndp: " << glm::dot(glm::normalize(normals[1]), glm::normalize(glm::cross(tangent1, bitangent1))) << std::endl;
-                        // std::cout << "fndp: " << glm::dot(glm::normalize(normals[2]), glm::normalize(glm::cross(tangent2, bitangent2))) << std::endl;
-
-                    } else {
-                        std::cout << "Warm: " << fullName << " is missing texture coordinates, cannot find tangent and bitangent" << std::endl;
-                    }
-
-                    // save data
-                    for(uint32_t v = 0; v < 3; ++v) {
-                        uint32_t elem_ind = indices[v].vertex_index;
-
-                        if(forceNewVert[v]) {
-                            elem_ind = vertices.size();
-                            vertices.push_back({
-                                verts[v],
-                                tans[v],
-                                bitans[v],
-                                normals[v],
-                                coords[v]
-                            });
-                        } else {
-                            vertices[elem_ind] = {
-                                verts[v],
-                                vertices[elem_ind].tangent + tans[v],
-                                vertices[elem_ind].bitangent + bitans[v],
-                                normals[v],
-                                coords[v]
-                            };
-                        }
-
-                        element_data.push_back(elem_ind);
-                    }
-                    index_offset += 3;
-                }
+            for(const auto& range : cached.drawRanges) {
+                DrawObject dobj{};
+                dobj.numElements = range.indexCount;
+                dobj.material_id = range.materialId;
+                dobj.elements.assign(cached.indexData + range.firstIndex, cached.indexData + range.firstIndex + range.indexCount);
+                objects.push_back(std::move(dobj));
+            }
 
-                // create buffer data
-                uint32_t nElems = element_data.size();
-                std::vector<GLuint> newElements;
-                for(uint32_t i = 0; i < nElems; i++) {
-                    uint32_t ind = element_data[i];
+            std::shared_ptr<Geometry> newGeom = std::make_shared<Geometry>(std::move(objects), cached.vertexData, cached.vertexCount, vertexFormat);
+            newGeom->setMaterials(materials);
 
-                    uint32_t dind = ind * GeomSizeAndStride;
+            auto loadTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+            std::cout << "Resource: loaded " << fullName << " from cache (" << cached.vertexCount << " vertices, "
+                << cached.drawRanges.size() << " shapes) in " << loadTime.count() << " ms" << std::endl;
 
-                    // if(ind == tind) {
-                        // buffer_data[dind] = vertices[ind][0];
-                        // buffer_data[dind+1] = vertices[ind][1];
-                        // buffer_data[dind+2] = vertices[ind][2];
+            geometries.insert(std::make_pair(fullName, newGeom));
+            return newGeom;
+        }
 
-                        // buffer_data[dind+3] = tangents[ind][0];
-                        // buffer_data[dind+4] = tangents[ind][1];
-                        // buffer_data[dind+5] = tangents[ind][2];
+        obj::ObjFile objFile;
+        std::string warn;
+        std::string err;
+        bool rc = obj::loadObj(objFile, sourcePath, assetPath + baseDir, *workers, warn, err);
+        if(!warn.empty())
+            std::cout << "Warn: " << fullName << ": " << warn << std::endl;
 
-                        // buffer_data[dind+6] = bitangents[ind][0];
-                        // buffer_data[dind+7] = bitangents[ind][1];
-                        // buffer_data[dind+8] = bitangents[ind][2];
+        SSRE_CHECK_THROW(rc, err);
 
-                        // buffer_data[dind+9] = texcoords[tind][0];
-                        // buffer_data[dind+10] = texcoords[tind][1];
-                    // } else {
-                        newElements.push_back(buffer_data.size() / GeomSizeAndStride);
+        const auto& shapes = objFile.shapes;
+        if (shapes.size() > 0) {
 
-                        buffer_data.push_back(vertices[ind].position[0]);
-                        buffer_data.push_back(vertices[ind].position[1]);
-                        buffer_data.push_back(vertices[ind].position[2]);
+            std::vector<MaterialInfo> materials;
+            std::vector<DrawObject> objects;
 
-                        buffer_data.push_back(vertices[ind].tangent[0]);
-                        buffer_data.push_back(vertices[ind].tangent[1]);
-                        buffer_data.push_back(vertices[ind].tangent[2]);
+            // load materials
+            materials.push_back(MaterialInfo{}); // default material at mat_id 0
+            for(auto& mat : objFile.materials) {
+                materials.push_back(MaterialInfo{tinyobj_wrapper::material_t{mat}, baseDir});
+            }
 
-                        buffer_data.push_back(vertices[ind].bitangent[0]);
-                        buffer_data.push_back(vertices[ind].bitangent[1]);
-                        buffer_data.push_back(vertices[ind].bitangent[2]);
+            // build tangent frames and welded vertex data for each shape concurrently
+            std::vector<obj::ShapeBuffer> shapeBuffers(shapes.size());
+            std::vector<meshopt::VertexCacheStats> cacheBefore(shapes.size());
+            std::vector<meshopt::VertexCacheStats> cacheAfter(shapes.size());
+            workers->parallel_for(shapes.size(), [&](std::size_t s) {
+                obj::ShapeBuffer& sb = shapeBuffers[s];
+                sb = obj::buildShapeBuffer(objFile.attrib, shapes[s]);
+                obj::weldVertices(sb, weldEpsilon);
+
+                cacheBefore[s] = meshopt::analyzeVertexCache(sb.elements, sb.buffer_data.size() / GeomSizeAndStride);
+                if(optimizeMeshes) {
+                    meshopt::optimizeVertexCache(sb.elements, sb.buffer_data.size() / GeomSizeAndStride);
+                    meshopt::optimizeVertexFetch(sb.buffer_data, GeomSizeAndStride, sb.elements);
+                    cacheAfter[s] = meshopt::analyzeVertexCache(sb.elements, sb.buffer_data.size() / GeomSizeAndStride);
+                } else {
+                    cacheAfter[s] = cacheBefore[s];
+                }
+            });
+
+            // merge shapes into a single vertex buffer
+            std::size_t nFloats = 0;
+            std::size_t nElements = 0; // also the vertex count before welding
+            for(const auto& sb : shapeBuffers) {
+                nFloats += sb.buffer_data.size();
+                nElements += sb.elements.size();
+            }
+            std::vector<GLfloat> buffer_data;
+            buffer_data.reserve(nFloats);
+            std::vector<GLuint> elements;
+            elements.reserve(nElements);
+            std::vector<meshcache::DrawRange> drawRanges;
 
-                        buffer_data.push_back(vertices[ind].texpos[0]);
-                        buffer_data.push_back(vertices[ind].texpos[1]);
-                    // }
+            for (size_t s = 0; s < shapes.size(); ++s) {
+                obj::ShapeBuffer& sb = shapeBuffers[s];
+                if(sb.missingNormals)
+                    std::cout << "Warn: " << fullName << " shape " << shapes[s].name << " has vertices without normals" << std::endl;
+                if(sb.missingTexcoords)
+                    std::cout << "Warn: " << fullName << " shape " << shapes[s].name << " is missing texture coordinates, cannot find tangent and bitangent" << std::endl;
 
-                }
+                const GLuint base = buffer_data.size() / GeomSizeAndStride;
+                for(auto& e : sb.elements)
+                    e += base;
+                buffer_data.insert(buffer_data.end(), sb.buffer_data.begin(), sb.buffer_data.end());
 
                 // create new draw object
                 DrawObject dobj{};
-                dobj.numElements = newElements.size();
+                dobj.numElements = sb.elements.size();
                 // the first material for the shape. id is increased by 1 for default material id being -1
-                dobj.material_id = shapes[s].mesh.material_ids[0] + 1;
-                dobj.element_buffer->CopyData<GLuint>(newElements);
+                dobj.material_id = sb.material_id + 1;
+
+                drawRanges.push_back(meshcache::DrawRange{elements.size(), sb.elements.size(), dobj.material_id});
+                elements.insert(elements.end(), sb.elements.begin(), sb.elements.end());
+                dobj.elements = std::move(sb.elements);
 
                 objects.push_back(std::move(dobj));
             }
 
+            Geometry::fitToUnitCube(buffer_data);
+            const std::size_t nVertices = buffer_data.size() / GeomSizeAndStride;
+
             // make new geometry
-            std::shared_ptr<Geometry> newGeom = std::make_shared<Geometry>(std::move(objects), buffer_data);
+            std::shared_ptr<Geometry> newGeom = std::make_shared<Geometry>(std::move(objects), buffer_data.data(), nVertices, vertexFormat);
             newGeom->setMaterials(materials);
 
+            auto loadTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+            std::cout << "Resource: loaded " << fullName << " (" << nVertices << " vertices, "
+                << shapes.size() << " shapes) in " << loadTime.count() << " ms" << std::endl;
+            std::cout << "Resource: welded " << fullName << " " << nElements << " -> " << nVertices << " vertices" << std::endl;
+
+            meshopt::VertexCacheStats before, after;
+            for(size_t s = 0; s < shapes.size(); ++s) {
+                before += cacheBefore[s];
+                after += cacheAfter[s];
+            }
+            std::cout << "Resource: " << fullName << " vertex cache ACMR " << before.acmr() << " -> " << after.acmr()
+                << ", ATVR " << before.atvr() << " -> " << after.atvr() << std::endl;
+
+            meshcache::MeshView view;
+            view.vertexData = buffer_data.data();
+            view.vertexCount = nVertices;
+            view.indexData = elements.data();
+            view.indexCount = elements.size();
+            view.drawRanges = std::move(drawRanges);
+            view.materials = objFile.materials;
+            if(!meshcache::writeCache(cachePath, sourcePath, importKey(), view))
+                std::cerr << "Resource: unable to write mesh cache " << cachePath << std::endl;
+
             geometries.insert(std::make_pair(fullName, newGeom));
             return newGeom;
         }
         return {};
     }
     return geom->second;
-}
\ No newline at end of file
+}
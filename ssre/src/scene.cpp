@@ -15,6 +15,9 @@
 #include <shader.h>
 #include <mesh.h>
 #include <camera.h>
+#include <frustum.h>
+
+#include <algorithm>
 
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -28,71 +31,208 @@ Node::~Node() {
 
 }
 
-void Node::addChild(const std::shared_ptr<Node>& node) noexcept {
-    if(node != nullptr) {
-        children.push_back(node);
-    }
-}
-
 void Node::rotate(const glm::vec3& axis, float w) {
-    rotation = glm::rotate(rotation, w, axis);
+    LocalTransform& l = editLocal();
+    l.rotation = glm::rotate(l.rotation, w, axis);
 }
 
 void Node::update(float delta) {
     
 }
 
-void Node::pre_render(const glm::mat4& parentModelMatrix) {
-    glm::mat4 transform = rotation;
-    transform = parentModelMatrix * glm::translate(glm::mat4{1.f}, position) * rotation * glm::translate(glm::mat4{1.f}, offset);
-    for(auto& child : children) {
-        child->pre_render(transform);
-    }
-    model_matrix = transform * glm::scale(glm::mat4{1.f}, scale);
-}
-
 ///////////////////////////////////////////////////////////////////////
 
 Scene::Scene(std::shared_ptr<Node> root) : rootNode{std::move(root)} {
     SSRE_CHECK_THROW(rootNode, "Scene root must not be null");
-    addNodeToList(rootNode);
+    addNodeToList(rootNode, TransformHierarchy::NoParent);
+}
+
+Scene::~Scene() {
+    // nodes may outlive the scene, copy transforms back into them
+    for(size_t i = 0; i < transforms.size(); ++i)
+        detachNode(transforms.owner(i));
 }
 
 void Scene::pre_render() {
-    rootNode->pre_render(glm::mat4{1.f});
+    transforms.update();
+
+    changedDrawables.swap(addedDrawables);
+    addedDrawables.clear();
+
+    // refit bounds of drawables that moved
+    for(uint32_t i : transforms.getUpdated()) {
+        if(transformDrawables[i] != NoDrawable) {
+            updateBounds(transformDrawables[i]);
+            changedDrawables.push_back(transformDrawables[i]);
+        }
+    }
+}
+
+void Scene::updateBounds(uint32_t drawable) {
+    int32_t& proxy = drawableProxies[drawable];
+    BoundingSphere sphere;
+    if(drawables[drawable]->getWorldBounds(sphere)) {
+        const AABB box = AABB::fromSphere(sphere);
+        if(proxy == DynamicBVH::Null)
+            proxy = spatial.insert(box, drawable);
+        else
+            spatial.move(proxy, box);
+    } else if(proxy != DynamicBVH::Null) {
+        spatial.remove(proxy);
+        proxy = DynamicBVH::Null;
+    }
+}
+
+uint32_t Scene::cull(const Frustum& frustum, uint8_t* visible) {
+    std::fill(visible, visible + drawables.size(), 0);
+
+    queryResult.clear();
+    spatial.query(frustum, queryResult);
+    for(uint32_t d : queryResult)
+        visible[d] = 1;
+
+    uint32_t count = static_cast<uint32_t>(queryResult.size());
+    for(size_t d = 0; d < drawables.size(); ++d) {
+        if(drawableProxies[d] == DynamicBVH::Null) {
+            visible[d] = 1;
+            count++;
+        }
+    }
+    return count;
+}
+
+uint32_t Scene::cull(const BoundingSphere& sphere, uint8_t* visible) {
+    std::fill(visible, visible + drawables.size(), 0);
+
+    queryResult.clear();
+    spatial.query(sphere, queryResult);
+    for(uint32_t d : queryResult)
+        visible[d] = 1;
+
+    uint32_t count = static_cast<uint32_t>(queryResult.size());
+    for(size_t d = 0; d < drawables.size(); ++d) {
+        if(drawableProxies[d] == DynamicBVH::Null) {
+            visible[d] = 1;
+            count++;
+        }
+    }
+    return count;
 }
 
 void Scene::update(float delta) {
-    for(auto& n : nodes) {
-        n.second->update(delta);
+    for(size_t i = 0; i < transforms.size(); ++i) {
+        transforms.owner(i)->update(delta);
     }
 }
 
 void Scene::setCamera(const std::shared_ptr<Camera>& cam) {
     camera = cam;
-    // only update the camera parent if it is invalid
-    addNode(std::dynamic_pointer_cast<Node, Camera>(cam), (!cam->parent.expired() ? cam->parent.lock() : rootNode));
+    // add the camera below the root if it is not in the scene yet
+    if(cam->hierarchy != &transforms)
+        addNode(std::dynamic_pointer_cast<Node, Camera>(cam), rootNode);
 }
 
 bool Scene::addNode(const std::shared_ptr<Node>& node, const std::shared_ptr<Node>& parent) {
-    if(addNodeToList(node)) {
-        if(parent != nullptr) {
-            node->parent = parent;
-            parent->addChild(node);
-        } else {
-            node->parent = rootNode;
-            rootNode->addChild(node);
-        }
+    const std::shared_ptr<Node>& p = parent ? parent : rootNode;
+    if(p->hierarchy == &transforms && addNodeToList(node, p->transformIndex))
         return true;
-    }
     std::cout << "Failed to add node: " << (node ? node->name : "null") << std::endl;
     return false;
 }
 
-bool Scene::addNodeToList(const std::shared_ptr<Node>& node) {
-    if(node != nullptr && nodes.find(node->name) == nodes.end()) {
+bool Scene::addNodeToList(const std::shared_ptr<Node>& node, uint32_t parentIndex) {
+    if(node != nullptr && node->hierarchy == nullptr && nodes.find(node->name) == nodes.end()) {
         nodes.insert(std::make_pair(node->name, node));
+        // move the transform into the scene storage, children are always appended after their parent
+        node->transformIndex = transforms.add(node.get(), parentIndex, node->detached);
+        node->hierarchy = &transforms;
+
+        // type is checked once here instead of every frame by the renderer
+        if(Drawable* d = dynamic_cast<Drawable*>(node.get())) {
+            transformDrawables.push_back(static_cast<uint32_t>(drawables.size()));
+            drawables.push_back(d);
+            drawableProxies.push_back(DynamicBVH::Null);
+            updateBounds(transformDrawables.back());
+            addedDrawables.push_back(transformDrawables.back());
+        } else {
+            transformDrawables.push_back(NoDrawable);
+        }
+        if(PointLight* l = dynamic_cast<PointLight*>(node.get()))
+            lights.push_back(l);
         return true;
     }
     return false;
-}
\ No newline at end of file
+}
+
+bool Scene::removeNode(const std::shared_ptr<Node>& node) {
+    if(node == nullptr || node->hierarchy != &transforms || node == rootNode)
+        return false;
+
+    const std::vector<uint32_t> removed = transforms.subtree(node->transformIndex);
+    // keep removed nodes alive until the scene no longer references them
+    std::vector<std::shared_ptr<Node>> keep;
+    keep.reserve(removed.size());
+    std::vector<uint32_t> drawableRemap(drawables.size(), 0);
+    for(uint32_t i : removed) {
+        Node* n = transforms.owner(i);
+        auto itr = nodes.find(n->name);
+        keep.push_back(itr->second);
+        nodes.erase(itr);
+
+        const uint32_t d = transformDrawables[i];
+        if(d != NoDrawable) {
+            if(drawableProxies[d] != DynamicBVH::Null)
+                spatial.remove(drawableProxies[d]);
+            drawableRemap[d] = NoDrawable;
+        }
+        if(PointLight* l = dynamic_cast<PointLight*>(n))
+            lights.erase(std::find(lights.begin(), lights.end(), l));
+
+        detachNode(n);
+    }
+
+    // compact drawables, keeping their order
+    uint32_t next = 0;
+    for(uint32_t d = 0; d < drawables.size(); ++d) {
+        if(drawableRemap[d] == NoDrawable)
+            continue;
+        drawableRemap[d] = next;
+        drawables[next] = drawables[d];
+        drawableProxies[next] = drawableProxies[d];
+        if(drawableProxies[next] != DynamicBVH::Null)
+            spatial.setUserData(drawableProxies[next], next);
+        next++;
+    }
+    drawables.resize(next);
+    drawableProxies.resize(next);
+    // indices changed, users of drawable indices start over
+    addedDrawables.clear();
+    changedDrawables.clear();
+    drawablesVersion++;
+
+    // compact the transform to drawable map the same way TransformHierarchy::remove compacts entries
+    next = 0;
+    auto r = removed.begin();
+    for(uint32_t i = 0; i < transformDrawables.size(); ++i) {
+        if(r != removed.end() && *r == i) {
+            ++r;
+            continue;
+        }
+        const uint32_t d = transformDrawables[i];
+        transformDrawables[next++] = d == NoDrawable ? NoDrawable : drawableRemap[d];
+    }
+    transformDrawables.resize(next);
+
+    transforms.remove(removed);
+    for(uint32_t i = 0; i < transforms.size(); ++i)
+        transforms.owner(i)->transformIndex = i;
+    return true;
+}
+
+void Scene::detachNode(Node* node) {
+    node->detached = transforms.local(node->transformIndex);
+    node->model_matrix = transforms.world(node->transformIndex);
+    node->normal_matrix = transforms.normal(node->transformIndex);
+    node->hierarchy = nullptr;
+    node->transformIndex = 0;
+}
@@ -13,6 +13,8 @@
 #include <iostream>
 #include <iterator>
 #include <algorithm>
+#include <vector>
+#include <mutex>
 
 #include <shader.h>
 #include <renderer.h>
@@ -22,6 +24,50 @@
 
 using namespace ssre;
 
+namespace {
+
+// names of all uniform handles, ids index names. Names are copied out under the mutex, other threads may add names.
+struct HandleRegistry {
+    std::mutex mutex;
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<std::string> names;
+};
+
+HandleRegistry& handleRegistry() {
+    static HandleRegistry registry;
+    return registry;
+}
+
+}
+
+UniformHandle::UniformHandle(const std::string& name) {
+    HandleRegistry& registry = handleRegistry();
+    std::lock_guard<std::mutex> lock{registry.mutex};
+    auto [itr, added] = registry.ids.try_emplace(name, static_cast<uint32_t>(registry.names.size()));
+    if(added)
+        registry.names.push_back(name);
+    index = itr->second;
+}
+
+std::string UniformHandle::name() const {
+    return nameOf(index);
+}
+
+uint32_t UniformHandle::count() {
+    HandleRegistry& registry = handleRegistry();
+    std::lock_guard<std::mutex> lock{registry.mutex};
+    return static_cast<uint32_t>(registry.names.size());
+}
+
+std::string UniformHandle::nameOf(uint32_t id) {
+    HandleRegistry& registry = handleRegistry();
+    std::lock_guard<std::mutex> lock{registry.mutex};
+    return registry.names[id];
+}
+
+const UniformHandle mat_spec::ModelMatrixUniform{mat_spec::ModelMatrixUniformName};
+const UniformHandle mat_spec::NormalMatrixUniform{mat_spec::NormalMatrixUniformName};
+
 namespace ssre{
 std::ostream& operator<<(std::ostream& os, const Program& input) {
     os << "ShaderProgram: " << input.ProgramName << std::endl;
@@ -98,8 +144,7 @@ uint32_t Program::program_id_counter = 1;
 Program::Program(std::string name) : 
     ProgramName{std::move(name)}, 
     program_id{program_id_counter++}, 
-    attachedShaders{},
-    shaderUBO{std::make_unique<Buffer>(gl::BindingTarget::UNIFORM, gl::Usage::DYNAMIC_DRAW)} {
+    attachedShaders{} {
 
     gl_reference = glCreateProgram();
     if(gl_reference == 0)
@@ -118,6 +163,15 @@ void Program::SetShaderPath(gl::GLSLShaderType type, const std::string& path) {
 void Program::loadAndBuild() {
     modifiedCount++;
     built = false;
+    // detach the shaders of a previous build, they are deleted once detached
+    GLint attachedCount = 0;
+    glGetProgramiv(gl_reference, GL_ATTACHED_SHADERS, &attachedCount);
+    if(attachedCount > 0) {
+        std::vector<GLuint> attached(attachedCount);
+        glGetAttachedShaders(gl_reference, attachedCount, nullptr, attached.data());
+        for(GLuint shader : attached)
+            glDetachShader(gl_reference, shader);
+    }
     for(auto& stage : attachedShaders) {
         std::unique_ptr<Shader> shader = std::make_unique<Shader>(ProgramName, stage.first);
         shader->LoadFrom(stage.second);
@@ -136,8 +190,24 @@ void Program::loadAndBuild() {
     if(isLinked()) {
         // initialize lists of attributes and uniform variables
         updateProgramInputInfo();
+        instanceModelInputLocation = getInputInfo(mat_spec::InstanceModelAttributeName).Location;
+        instanceMaterialInputLocation = getInputInfo(mat_spec::InstanceMaterialAttributeName).Location;
         updateProgramUniformBlockInfo();
         updateProgramUniformInfo();
+        handleLocations.clear();
+        handleLayouts.clear();
+        resolveHandles();
+        materialBufferIndex = glGetProgramResourceIndex(gl_reference, GL_SHADER_STORAGE_BLOCK, mat_spec::MaterialBufferName);
+        materialIndexLocation = getUniformInfo(mat_spec::MaterialIndexUniformName).Location;
+        if(usesMaterialTable()) {
+            glShaderStorageBlockBinding(gl_reference, materialBufferIndex, mat_spec::MaterialBufferBinding);
+            GLint units[mat_spec::MaterialArrayCount];
+            for(uint32_t i = 0; i < mat_spec::MaterialArrayCount; ++i)
+                units[i] = mat_spec::MaterialArrayFirstUnit + i;
+            const GLint arrayLocation = getUniformInfo(mat_spec::MaterialArraySamplerName).Location;
+            if(arrayLocation != -1)
+                glProgramUniform1iv(gl_reference, arrayLocation, mat_spec::MaterialArrayCount, units);
+        }
         built = true;
         // additional configuration
         onBuilt();
@@ -162,11 +232,16 @@ void Program::loadAndBuild() {
 void Program::use() const {
     // set program to active
     glUseProgram(gl_reference);
-    // bind shader UBO to shader data location if available
-    if(shaderDataDescription.Location != -1)
+    // bind shader UBO to shader data location if available, changed parameters are written to a new range so draws already issued keep their values
+    if(shaderDataDescription.Location != -1) {
+        if(shaderDataChanged) {
+            shaderDataOffset = shaderUBO->write(shaderData.data(), shaderData.size(), StreamBuffer::UniformOffsetAlignment());
+            shaderDataChanged = false;
+        }
         GL_CHECKED_CALL(
-            glBindBufferRange(GL_UNIFORM_BUFFER, mat_spec::ShaderUniformBlockBindingLocation, shaderUBO->Handle(), 0, shaderUBO->size())
+            glBindBufferRange(GL_UNIFORM_BUFFER, mat_spec::ShaderUniformBlockBindingLocation, shaderUBO->Handle(), shaderDataOffset, shaderData.size())
         );
+    }
 }
 
 void Program::applyMaterial(const std::unique_ptr<Material>& material) const {
@@ -174,19 +249,34 @@ void Program::applyMaterial(const std::unique_ptr<Material>& material) const {
         std::cerr << "Attempting to apply invalid material to " + ProgramName << std::endl;
         return;
     }
-    const auto& textureInputs = material->getTextureInputs();
-    for(uint32_t i = 0; i < textureInputs.size(); i++) { 
-        if(textureInputs[i].texture) {
-            // set and activate texture unit for editing
-            glActiveTexture(gl::TextureUnit[i]);
-            textureInputs[i].texture->bind();
-            // update sampler uniform for texture
-            glUniform1i(textureInputs[i].location, i);
+    // textures are resident in the material table, the material is selected by index
+    if(usesMaterialTable()) {
+        if(materialIndexLocation != -1)
+            glUniform1ui(materialIndexLocation, material->getTableIndex());
+    } else {
+        const auto& textureInputs = material->getTextureInputs();
+        for(uint32_t i = 0; i < textureInputs.size(); i++) { 
+            if(textureInputs[i].texture) {
+                // set and activate texture unit for editing
+                glActiveTexture(gl::TextureUnit[i]);
+                textureInputs[i].texture->bind();
+                // update sampler uniform for texture
+                glUniform1i(textureInputs[i].location, i);
+            }
         }
     }
-    // update the other uniforms
-    for(const auto& param : material->getParameters()) {
-        param.second->apply();
+    // parameters in the material block are selected with one range bind, the other uniforms are set one by one
+    if(usesMaterialBlock()) {
+        const std::size_t offset = materialBlockOffset(*material);
+        glBindBufferRange(GL_UNIFORM_BUFFER, mat_spec::MaterialUniformBlockBindingLocation, materialUBO->Handle(), offset, materialDataDescription.BlockSize);
+        for(const auto& param : material->getParameters()) {
+            if(!param.second->isBlockMember())
+                param.second->apply();
+        }
+    } else {
+        for(const auto& param : material->getParameters()) {
+            param.second->apply();
+        }
     }
 }
 
@@ -329,7 +419,7 @@ void Program::updateProgramUniformBlockInfo() {
 
             //std::cout << "UB: " << name << ", GL_UNIFORM_BLOCK " << unifIndices[unifIx] << ", Location " << values[2] << std::endl;
 
-            pubd.layouts[name] = ProgramUniformBlockDescription::Layout{offsets[unifIx], sizes[unifIx], strides[unifIx]};
+            pubd.layouts[name] = ProgramUniformBlockDescription::Layout{offsets[unifIx], sizes[unifIx], strides[unifIx], static_cast<GLenum>(values[1])};
 
         }
 
@@ -338,8 +428,74 @@ void Program::updateProgramUniformBlockInfo() {
     // update shaderUBO binding if available
     if(setUniformBlockBinding(mat_spec::ShaderUniformBlockName, mat_spec::ShaderUniformBlockBindingLocation)) {
         shaderDataDescription = getUniformBlockInfo(mat_spec::ShaderUniformBlockName);
-        shaderUBO->Allocate(shaderDataDescription.BlockSize);
+        shaderData.assign(shaderDataDescription.BlockSize, 0);
+        shaderDataChanged = true;
+        // room for the block to change a few times per frame, eg. once per light, before the stream grows
+        const std::size_t alignment = StreamBuffer::UniformOffsetAlignment();
+        const std::size_t blockBytes = (shaderData.size() + alignment - 1) / alignment * alignment;
+        shaderUBO = std::make_unique<StreamBuffer>(gl::BindingTarget::UNIFORM, 16 * blockBytes);
     } else {
         shaderDataDescription = {}; // clear shader data description
+        shaderData.clear();
+        shaderUBO.reset();
+    }
+
+    // materials are repacked with the new layout when they are next applied
+    materialSlots.clear();
+    materialData.clear();
+    if(setUniformBlockBinding(mat_spec::MaterialUniformBlockName, mat_spec::MaterialUniformBlockBindingLocation)) {
+        materialDataDescription = getUniformBlockInfo(mat_spec::MaterialUniformBlockName);
+        const std::size_t alignment = StreamBuffer::UniformOffsetAlignment();
+        materialStride = (materialDataDescription.BlockSize + alignment - 1) / alignment * alignment;
+        materialUBO = std::make_unique<Buffer>(gl::BindingTarget::UNIFORM, gl::Usage::DYNAMIC_DRAW);
+    } else {
+        materialDataDescription = {};
+        materialStride = 0;
+        materialUBO.reset();
+    }
+}
+
+void Program::resolveHandles() const {
+    const uint32_t count = UniformHandle::count();
+    const uint32_t first = static_cast<uint32_t>(handleLocations.size());
+    handleLocations.resize(count, -1);
+    handleLayouts.resize(count, ProgramUniformBlockDescription::Layout{-1, -1, -1});
+    for(uint32_t id = first; id < count; ++id) {
+        const std::string name = UniformHandle::nameOf(id);
+        handleLocations[id] = getUniformInfo(name).Location;
+        handleLayouts[id] = shaderDataDescription.getLayout(name);
+    }
+}
+
+ProgramUniformDescription Program::getMaterialParameterInfo(const std::string& paramName) const {
+    auto itr = materialDataDescription.layouts.find(paramName);
+    if(itr != materialDataDescription.layouts.end())
+        return {-1, itr->second.Type, itr->second.ArraySize};
+    return getUniformInfo(paramName);
+}
+
+std::size_t Program::materialBlockOffset(const Material& material) const {
+    auto [itr, added] = materialSlots.try_emplace(material.getMaterialId(), MaterialSlot{static_cast<uint32_t>(materialSlots.size()), 0});
+    MaterialSlot& slot = itr->second;
+    const std::size_t offset = slot.index * materialStride;
+    if(added || slot.revision != material.getParameterRevision()) {
+        slot.revision = material.getParameterRevision();
+        if(materialData.size() < offset + materialStride)
+            materialData.resize(offset + materialStride, 0);
+        for(const auto& param : material.getParameters()) {
+            if(!param.second->isBlockMember())
+                continue;
+            const GLint uoff = materialDataDescription.getOffset(param.first);
+            if(uoff != -1)
+                param.second->write(materialData.data() + offset, uoff);
+        }
+        if(materialUBO->size() < materialData.size()) {
+            // grow by doubling and upload every slot, draws already issued keep the orphaned storage
+            materialUBO->Allocate(std::max(materialData.size(), 2 * materialUBO->size()));
+            materialUBO->SubData(materialData.data(), materialData.size(), 0);
+        } else {
+            materialUBO->SubData(materialData.data() + offset, materialStride, offset);
+        }
     }
+    return offset;
 }
\ No newline at end of file
@@ -0,0 +1,365 @@
+/**
+ * @file shadow.cpp
+ * @brief cached point light shadow maps
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <shadow.h>
+
+#include <algorithm>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <ssre.h>
+#include <scene.h>
+#include <renderer.h>
+#include <texture.h>
+
+using namespace ssre;
+
+namespace {
+
+bool isPowerOfTwo(uint32_t v) noexcept {
+    return v != 0 && (v & (v - 1)) == 0;
+}
+
+uint32_t floorPowerOfTwo(uint32_t v) noexcept {
+    uint32_t p = 1;
+    while(p <= v / 2)
+        p *= 2;
+    return p;
+}
+
+}
+
+AtlasAllocator::AtlasAllocator(uint32_t size, uint32_t minTile) : size{size}, minTile{minTile} {
+    SSRE_CHECK_THROW(isPowerOfTwo(size) && isPowerOfTwo(minTile) && minTile <= size, "Atlas and tile sizes must be powers of two");
+    freeTiles.resize(level(minTile) + 1);
+    freeTiles[0].insert(key(0, 0));
+}
+
+uint32_t AtlasAllocator::level(uint32_t tileSize) const noexcept {
+    uint32_t l = 0;
+    while((size >> l) > tileSize)
+        l++;
+    return l;
+}
+
+AtlasAllocator::Tile AtlasAllocator::allocate(uint32_t tileSize) {
+    tileSize = std::max(tileSize, minTile);
+    if(tileSize > size)
+        return {};
+    const uint32_t target = level(tileSize);
+    tileSize = size >> target;
+
+    // smallest free tile that fits
+    int32_t l = static_cast<int32_t>(target);
+    while(l >= 0 && freeTiles[l].empty())
+        l--;
+    if(l < 0)
+        return {};
+
+    const uint64_t k = *freeTiles[l].begin();
+    freeTiles[l].erase(freeTiles[l].begin());
+    const uint32_t x = static_cast<uint32_t>(k);
+    const uint32_t y = static_cast<uint32_t>(k >> 32);
+
+    // split down to the requested size, keeping the first quarter
+    for(; static_cast<uint32_t>(l) < target; ++l) {
+        const uint32_t s = size >> (l + 1);
+        freeTiles[l + 1].insert(key(x + s, y));
+        freeTiles[l + 1].insert(key(x, y + s));
+        freeTiles[l + 1].insert(key(x + s, y + s));
+    }
+    used += (uint64_t)tileSize * tileSize;
+    return Tile{x, y, tileSize};
+}
+
+void AtlasAllocator::free(const Tile& tile) {
+    if(!tile.valid())
+        return;
+    used -= (uint64_t)tile.size * tile.size;
+
+    uint32_t l = level(tile.size);
+    uint32_t x = tile.x, y = tile.y;
+    // merge with the three other quarters of the parent while they are free
+    while(l > 0) {
+        const uint32_t s = size >> l;
+        const uint32_t px = x - x % (2 * s);
+        const uint32_t py = y - y % (2 * s);
+        uint32_t freeSiblings = 0;
+        for(uint32_t q = 0; q < 4; ++q) {
+            const uint32_t qx = px + (q & 1) * s;
+            const uint32_t qy = py + (q >> 1) * s;
+            if((qx != x || qy != y) && freeTiles[l].count(key(qx, qy)))
+                freeSiblings++;
+        }
+        if(freeSiblings != 3)
+            break;
+        for(uint32_t q = 0; q < 4; ++q)
+            freeTiles[l].erase(key(px + (q & 1) * s, py + (q >> 1) * s));
+        x = px;
+        y = py;
+        l--;
+    }
+    freeTiles[l].insert(key(x, y));
+}
+
+///////////////////////////////////////////////////////////////////////
+
+ShadowMaps::ShadowMaps(uint32_t atlasSize, uint32_t maxTile, uint32_t minTile, float nearPlane, float farPlane) :
+    nearPlane{nearPlane},
+    farPlane{farPlane},
+    maxTile{std::min(maxTile, atlasSize)},
+    minTile{minTile},
+    atlas{std::make_unique<Texture2D>("shadowAtlas")},
+    allocator{atlasSize, minTile} {
+
+    atlas->setFilterMode(gl::TextureParamFilter::TEXTURE_MIN_FILTER, gl::TextureFilterMode::NEAREST);
+    atlas->setFilterMode(gl::TextureParamFilter::TEXTURE_MAG_FILTER, gl::TextureFilterMode::NEAREST);
+    atlas->setWrapMode(gl::TextureParamWrap::TEXTURE_WRAP_S, gl::TextureWrapMode::CLAMP_TO_EDGE);
+    atlas->setWrapMode(gl::TextureParamWrap::TEXTURE_WRAP_T, gl::TextureWrapMode::CLAMP_TO_EDGE);
+    atlas->setData(nullptr, gl::PixelFormat::DEPTH_COMPONENT, gl::PixelType::FLOAT, gl::TextureInternalFormat::DEPTH_COMPONENT16, atlasSize, atlasSize);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, atlas->getHandle(), 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    SSRE_CHECK_THROW(complete, "Shadow atlas framebuffer is not complete!");
+}
+
+ShadowMaps::~ShadowMaps() {
+    glDeleteFramebuffers(1, &framebuffer);
+}
+
+void ShadowMaps::cubeFaceMatrices(const glm::vec3& lpos, float nearPlane, float farPlane, std::vector<glm::mat4>& out) {
+    out.clear();
+    glm::mat4 lproj = glm::perspective(0.5f*glm::pi<float>(), 1.f, nearPlane, farPlane);
+    out.push_back(lproj*glm::lookAt(lpos, lpos + glm::vec3{1, 0, 0}, {0, -1, 0}));
+    out.push_back(lproj*glm::lookAt(lpos, lpos + glm::vec3{-1, 0, 0}, {0, -1, 0}));
+    out.push_back(lproj*glm::lookAt(lpos, lpos + glm::vec3{0, 1, 0}, {0, 0, 1}));
+    out.push_back(lproj*glm::lookAt(lpos, lpos + glm::vec3{0, -1, 0}, {0, 0, -1}));
+    out.push_back(lproj*glm::lookAt(lpos, lpos + glm::vec3{0, 0, 1}, {0, -1, 0}));
+    out.push_back(lproj*glm::lookAt(lpos, lpos + glm::vec3{0, 0, -1}, {0, -1, 0}));
+}
+
+uint8_t ShadowMaps::faceMask(Scene& scene, uint32_t drawable, const LightState& state) const {
+    const Drawable* d = scene.getDrawables()[drawable];
+    if(!d->getDepthProgram())
+        return 0;
+    BoundingSphere sphere;
+    if(!d->getWorldBounds(sphere))
+        return AllFaces;
+
+    // light range
+    const glm::vec3 offset = sphere.center - state.position;
+    const float range = sphere.radius + farPlane;
+    if(glm::dot(offset, offset) > range * range)
+        return 0;
+
+    uint8_t mask = 0;
+    for(uint32_t face = 0; face < 6; ++face) {
+        if(state.faceFrusta[face].intersects(sphere))
+            mask |= 1 << face;
+    }
+    return mask;
+}
+
+bool ShadowMaps::allocateTiles(LightState& state, uint32_t tileSize) {
+    for(uint32_t face = 0; face < 6; ++face) {
+        state.tiles[face] = allocator.allocate(tileSize);
+        if(!state.tiles[face].valid()) {
+            freeTiles(state);
+            return false;
+        }
+    }
+    state.tileSize = tileSize;
+    state.cached = false;
+    return true;
+}
+
+void ShadowMaps::freeTiles(LightState& state) {
+    for(AtlasAllocator::Tile& tile : state.tiles) {
+        allocator.free(tile);
+        tile = AtlasAllocator::Tile{};
+    }
+    state.tileSize = 0;
+    state.cached = false;
+}
+
+void ShadowMaps::update(Scene& scene, const Frustum& view, const glm::vec3& viewPosition, float pixelScale) {
+    const std::vector<PointLight*>& sceneLights = scene.getLights();
+    const uint32_t nDrawables = static_cast<uint32_t>(scene.getDrawables().size());
+    const uint32_t nLights = static_cast<uint32_t>(sceneLights.size());
+    frame++;
+
+    // removing drawables changes their indices, cached faces are dropped
+    const bool reindexed = scene.getDrawablesVersion() != drawablesVersion;
+    drawablesVersion = scene.getDrawablesVersion();
+
+    // tile size from the screen size of the light range, lights that cannot light anything in view get no tiles
+    lights.resize(nLights);
+    for(uint32_t i = 0; i < nLights; ++i) {
+        LightState& state = states[sceneLights[i]];
+        lights[i] = &state;
+        state.frame = frame;
+        state.dirtyFaces = 0;
+
+        const glm::vec3 position{sceneLights[i]->getModelMatrix() * glm::vec4{0, 0, 0, 1}};
+        if(position != state.position)
+            state.cached = false;
+        state.position = position;
+
+        state.wantedSize = 0;
+        if(view.intersects(BoundingSphere{position, farPlane})) {
+            const float distance = glm::length(position - viewPosition);
+            const float pixels = distance > farPlane ? pixelScale * farPlane / distance : (float)maxTile;
+            state.wantedSize = std::min(std::max(floorPowerOfTwo(static_cast<uint32_t>(pixels)), minTile), maxTile);
+        }
+    }
+
+    // release lights that left the scene
+    for(auto itr = states.begin(); itr != states.end();) {
+        if(itr->second.frame != frame) {
+            freeTiles(itr->second);
+            itr = states.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+
+    // release tiles of lights that need larger ones or much smaller ones, small changes keep the cached tiles
+    for(LightState* state : lights) {
+        if(state->tileSize != 0 && (state->wantedSize == 0 || state->wantedSize > state->tileSize || state->wantedSize * 4 <= state->tileSize))
+            freeTiles(*state);
+    }
+
+    // allocate for the most important lights first, falling back to smaller tiles when the atlas is full
+    allocationOrder.clear();
+    for(uint32_t i = 0; i < nLights; ++i) {
+        if(lights[i]->tileSize == 0 && lights[i]->wantedSize != 0)
+            allocationOrder.push_back(i);
+    }
+    std::stable_sort(allocationOrder.begin(), allocationOrder.end(), [this](uint32_t a, uint32_t b) {
+        return lights[a]->wantedSize > lights[b]->wantedSize;
+    });
+    for(uint32_t i : allocationOrder) {
+        for(uint32_t size = lights[i]->wantedSize; size >= minTile; size /= 2) {
+            if(allocateTiles(*lights[i], size))
+                break;
+        }
+    }
+
+    stats = ShadowStats{};
+    stats.lights = nLights;
+    stats.atlasUsed = allocator.getUsed();
+    records.resize(nLights);
+    const float atlasScale = 1.f / allocator.getSize();
+    for(uint32_t i = 0; i < nLights; ++i) {
+        LightState& state = *lights[i];
+        ShadowRecord& record = records[i];
+        if(state.tileSize == 0) {
+            stats.lightsWithoutTiles++;
+            for(glm::vec4& tile : record.faceTiles)
+                tile = glm::vec4{0.f};
+            continue;
+        }
+
+        if(!state.cached || reindexed) {
+            // cube is redrawn, cull all drawables against the light range then against each face
+            cubeFaceMatrices(state.position, nearPlane, farPlane, state.faceMatrices);
+            state.faceFrusta.clear();
+            for(const glm::mat4& faceMatrix : state.faceMatrices)
+                state.faceFrusta.emplace_back(faceMatrix);
+
+            state.faces.assign(nDrawables, 0);
+            inRange.resize(nDrawables);
+            scene.cull(BoundingSphere{state.position, farPlane}, inRange.data());
+            for(uint32_t d = 0; d < nDrawables; ++d) {
+                if(inRange[d])
+                    state.faces[d] = faceMask(scene, d, state);
+            }
+            state.dirtyFaces = AllFaces;
+            state.cached = true;
+        } else {
+            // only faces that saw a changed drawable before or after the change are redrawn
+            state.faces.resize(nDrawables, 0);
+            for(uint32_t d : scene.getChangedDrawables()) {
+                const uint8_t before = state.faces[d];
+                state.faces[d] = faceMask(scene, d, state);
+                state.dirtyFaces |= before | state.faces[d];
+            }
+        }
+
+        for(uint32_t face = 0; face < 6; ++face) {
+            const AtlasAllocator::Tile& tile = state.tiles[face];
+            record.faceMatrices[face] = state.faceMatrices[face];
+            record.faceTiles[face] = glm::vec4(tile.x, tile.y, tile.size, tile.size) * atlasScale;
+        }
+
+        if(state.dirtyFaces == 0)
+            continue;
+
+        state.casters.resize(nDrawables);
+        for(uint32_t d = 0; d < nDrawables; ++d) {
+            state.casters[d] = (state.faces[d] & state.dirtyFaces) != 0;
+            stats.casterDraws += state.casters[d];
+        }
+        stats.lightsDrawn++;
+        for(uint32_t face = 0; face < 6; ++face)
+            stats.facesDrawn += (state.dirtyFaces >> face) & 1;
+    }
+}
+
+void ShadowMaps::invalidate() noexcept {
+    for(auto& state : states)
+        state.second.cached = false;
+}
+
+void ShadowMaps::beginRender() {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    // clear dirty faces only, the others keep their depth from earlier frames
+    glEnable(GL_SCISSOR_TEST);
+    for(const LightState* state : lights) {
+        for(uint32_t face = 0; face < 6; ++face) {
+            if(state->dirtyFaces & (1 << face)) {
+                const AtlasAllocator::Tile& tile = state->tiles[face];
+                glScissor(tile.x, tile.y, tile.size, tile.size);
+                glClear(GL_DEPTH_BUFFER_BIT);
+            }
+        }
+    }
+
+    // enable hardware depth biasing
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(1.1f, 4.0f);
+}
+
+void ShadowMaps::setViewports(uint32_t light) const {
+    GLfloat viewports[6 * 4];
+    GLint scissors[6 * 4];
+    for(uint32_t face = 0; face < 6; ++face) {
+        const AtlasAllocator::Tile& tile = lights[light]->tiles[face];
+        viewports[4 * face + 0] = (GLfloat)tile.x;
+        viewports[4 * face + 1] = (GLfloat)tile.y;
+        viewports[4 * face + 2] = (GLfloat)tile.size;
+        viewports[4 * face + 3] = (GLfloat)tile.size;
+        scissors[4 * face + 0] = tile.x;
+        scissors[4 * face + 1] = tile.y;
+        scissors[4 * face + 2] = tile.size;
+        scissors[4 * face + 3] = tile.size;
+    }
+    glViewportArrayv(0, 6, viewports);
+    glScissorArrayv(0, 6, scissors);
+}
+
+void ShadowMaps::endRender(GLuint target) {
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, target);
+}
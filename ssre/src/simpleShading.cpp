@@ -20,11 +20,23 @@
 
 using namespace ssre;
 
+namespace {
+
+// add a parameter the program declares, in its material block or as a uniform
+template<typename T>
+void addParameter(const Program& program, Material::UniformInputs& inputs, const std::string& name, const T& value) {
+    ProgramUniformDescription info = program.getMaterialParameterInfo(name);
+    if(info.Type == gl::getGlUniformType<T>())
+        inputs.insert(std::make_pair(name, std::make_unique<Uniform<T>>(name, value, info)));
+}
+
+}
+
 std::unique_ptr<Material> SimpleShading::createMaterial(const MaterialInfo& mcfg) const {
     Material::UniformInputs uis{};
     std::vector<Material::TextureInput> textures;
 
-    //uis.insert(std::make_pair("diffuse", std::make_unique<Uniform<float>>("diffuse", mcfg.diffuse[0], getUniformInfo("diffuse"))));
+    addParameter(*this, uis, "diffuse", mcfg.diffuse);
 
     int32_t texLoc = getUniformInfo("diffuseTex").Location;
     if(texLoc != -1) {
@@ -52,30 +64,24 @@ std::unique_ptr<Material> PBRShading::createMaterial(const MaterialInfo& mcfg) c
     Material::UniformInputs uis{};
     std::vector<Material::TextureInput> textures;
 
-    int32_t texLoc = getUniformInfo("albedoMap").Location;
-    if(texLoc != -1) {
-        textures.push_back(Material::TextureInput {texLoc, "albedoMap", mcfg.diffuse_tex});
-    }
-
-    texLoc = getUniformInfo("normalMap").Location;
-    if(texLoc != -1) {
-        textures.push_back(Material::TextureInput {texLoc, "normalMap", mcfg.normal_tex});
-    }
-
-    texLoc = getUniformInfo("metallicMap").Location;
-    if(texLoc != -1) {
-        textures.push_back(Material::TextureInput {texLoc, "metallicMap", mcfg.metallic_tex});
-    }
-
-    texLoc = getUniformInfo("roughnessMap").Location;
-    if(texLoc != -1) {
-        textures.push_back(Material::TextureInput {texLoc, "roughnessMap", mcfg.roughness_tex});
-    }
-
-    texLoc = getUniformInfo("aoMap").Location;
-    if(texLoc != -1) {
-        textures.push_back(Material::TextureInput {texLoc, "aoMap", mcfg.ambient_tex});
-    }
+    // with the material table every map has a fixed slot in the material record:
+    // 0 albedo, 1 normal, 2 metallic, 3 roughness, 4 ao
+    auto addMap = [&](const char* name, const std::shared_ptr<Texture>& texture) {
+        int32_t texLoc = getUniformInfo(name).Location;
+        if(texLoc != -1 || usesMaterialTable()) {
+            textures.push_back(Material::TextureInput {static_cast<uint32_t>(texLoc), name, texture});
+        }
+    };
+    addMap("albedoMap", mcfg.diffuse_tex);
+    addMap("normalMap", mcfg.normal_tex);
+    addMap("metallicMap", mcfg.metallic_tex);
+    addMap("roughnessMap", mcfg.roughness_tex);
+    addMap("aoMap", mcfg.ambient_tex);
+
+    addParameter(*this, uis, "albedoFactor", mcfg.diffuse);
+    addParameter(*this, uis, "emissiveFactor", mcfg.emission);
+    addParameter(*this, uis, "metallicFactor", mcfg.metallic);
+    addParameter(*this, uis, "roughnessFactor", mcfg.roughness);
 
     return std::make_unique<Material>(program_id, std::move(uis), std::move(textures));
 }
@@ -24,16 +24,16 @@ SkySphere::SkySphere(std::shared_ptr<Program> prog, MaterialInfo m) :
 
     SSRE_CHECK_THROW(program, "program must not be null!");
 
-    glGenVertexArrays(1, &vaoid);
-    GLint vertl = program->getInputInfo(mat_spec::VertexAttributeName).Location;
-    GLint texl = program->getInputInfo(mat_spec::TextureAttributeName).Location;
-    geometry->configVaoAttribPtrs(0, vaoid, vertl, -1, -1, texl);
-    nElements = geometry->getDrawObjects()[0].numElements;
+    VertexInputs inputs;
+    inputs.vertex = program->getInputInfo(mat_spec::VertexAttributeName).Location;
+    inputs.texCoord = program->getInputInfo(mat_spec::TextureAttributeName).Location;
+    vaoid = geometry->getVAO(inputs);
+    drawCommand = geometry->getDrawCommand(0);
 }
 
 void SkySphere::drawColor() {
 
-    GLint mloc = program->getUniformInfo(mat_spec::ModelMatrixUniformName).Location;
+    GLint mloc = program->getUniformLocation(mat_spec::ModelMatrixUniform);
     if(mloc != -1) {
         GL_CHECKED_CALL(gl::glUniform(mm, mloc));
     }
@@ -41,6 +41,6 @@ void SkySphere::drawColor() {
     glCullFace(GL_FRONT);
     glBindVertexArray(vaoid);
     program->applyMaterial(skyMaterial);
-    GL_CHECKED_CALL(glDrawElements(GL_TRIANGLES, nElements, GL_UNSIGNED_INT, (void*)0));
+    GL_CHECKED_CALL(glDrawElementsBaseVertex(GL_TRIANGLES, drawCommand.count, GL_UNSIGNED_INT, (void*)(drawCommand.firstIndex * sizeof(GLuint)), drawCommand.baseVertex));
     glCullFace(GL_BACK);
 }
\ No newline at end of file
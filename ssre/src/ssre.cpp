@@ -35,7 +35,9 @@ ssre_shader_error::ssre_shader_error(std::string shaderName, std::string errorSt
 }
 
 
-void ssre::SSRE_init() {
+void ssre::SSRE_init(bool headless) {
+    if(headless)
+        return;
     static GLFWContext _context{};
 }
 
@@ -37,6 +37,7 @@ void Texture::setFilterMode(gl::TextureParamFilter filter, gl::TextureFilterMode
 }
 
 void Texture::generateMipMap() {
+    ++revision;
     bind();
     glGenerateMipmap((GLenum)target);
     glBindTexture((GLenum)target, 0);
@@ -52,9 +53,19 @@ Texture2D::~Texture2D() {
 
 }
 
-void Texture2D::setData(const unsigned char* data, gl::PixelFormat dataFormat, gl::PixelType dataType, gl::TextureInternalFormat internalFormat, uint32_t width, uint32_t height) {
+void Texture2D::setData(const unsigned char* data, gl::PixelFormat dataFormat, gl::PixelType dataType, gl::TextureInternalFormat internalFormat, uint32_t width, uint32_t height, uint32_t level) {
+    if(level == 0)
+        ++revision;
     bind();
-    glTexImage2D((GLenum)target, 0, (GLint)internalFormat, width, height, 0, (GLenum)dataFormat, (GLenum)dataType, data);
+    glTexImage2D((GLenum)target, level, (GLint)internalFormat, width, height, 0, (GLenum)dataFormat, (GLenum)dataType, data);
+    glBindTexture((GLenum)target, 0);
+}
+
+void Texture2D::setCompressedData(const unsigned char* data, GLenum internalFormat, uint32_t width, uint32_t height, size_t size, uint32_t level) {
+    if(level == 0)
+        ++revision;
+    bind();
+    glCompressedTexImage2D((GLenum)target, level, internalFormat, width, height, 0, (GLsizei)size, data);
     glBindTexture((GLenum)target, 0);
 }
 
@@ -0,0 +1,268 @@
+/**
+ * @file texture_cache.cpp
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <texture_cache.h>
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <iostream>
+
+#include <mapped_file.h>
+#include <texture_streamer.h>
+
+#include <stb_image.h>
+
+using namespace ssre;
+using namespace ssre::texcache;
+
+namespace {
+
+constexpr char Magic[8] = {'S', 'S', 'T', 'E', 'X', '\0', '\0', '\0'};
+constexpr uint32_t Version = 1;
+constexpr uint64_t DataAlignment = 16;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t format;            // bc::Format
+    int64_t sourceTime;         // source modification time, file clock ticks
+    uint64_t sourceSize;
+    uint32_t settings;          // compression and usage the image was baked with
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+    uint64_t pathLength;        // source path follows the header
+    uint64_t levelOffset;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+};
+
+uint32_t settingsKey(TextureCompression compression, TextureUsage usage) {
+    return static_cast<uint32_t>(compression) | (static_cast<uint32_t>(usage) << 8);
+}
+
+uint64_t align(uint64_t offset) {
+    return (offset + DataAlignment - 1) & ~(DataAlignment - 1);
+}
+
+void pad(std::ostream& out, uint64_t to) {
+    static const char zeros[DataAlignment] = {};
+    uint64_t at = static_cast<uint64_t>(out.tellp());
+    out.write(zeros, to - at);
+}
+
+// box filtered mips shorten normals, scale them back to unit length
+void renormalize(uint8_t* rgba, size_t texels) {
+    for(size_t i = 0; i < texels; ++i, rgba += 4) {
+        float n[3];
+        for(int c = 0; c < 3; ++c)
+            n[c] = rgba[c] / 127.5f - 1.f;
+        const float len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if(len < 1e-4f)
+            continue;
+        for(int c = 0; c < 3; ++c)
+            rgba[c] = static_cast<uint8_t>(std::lround((n[c] / len * 0.5f + 0.5f) * 255.f));
+    }
+}
+
+} // namespace
+
+bc::Format texcache::chooseFormat(TextureCompression compression, TextureUsage usage, bool hasAlpha) noexcept {
+    if(usage == TextureUsage::Normal)
+        return bc::Format::BC5;
+    if(compression == TextureCompression::BC7)
+        return bc::Format::BC7;
+    return hasAlpha ? bc::Format::BC3 : bc::Format::BC1;
+}
+
+bool texcache::readCache(const std::string& cachePath, const std::string& sourcePath, TextureCompression compression, TextureUsage usage, CompressedImage& image) {
+    int64_t sourceTime;
+    uint64_t sourceSize;
+    if(!util::fileStamp(sourcePath, sourceTime, sourceSize))
+        return false;
+
+    util::MappedFile file{cachePath};
+    if(!file.isOpen() || file.size() < sizeof(Header))
+        return false;
+
+    Header header;
+    std::memcpy(&header, file.data(), sizeof(Header));
+    if(std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 ||
+        header.version != Version ||
+        header.sourceTime != sourceTime ||
+        header.sourceSize != sourceSize ||
+        header.settings != settingsKey(compression, usage) ||
+        header.format > static_cast<uint32_t>(bc::Format::BC7))
+        return false;
+
+    if(header.pathLength != sourcePath.size() || header.pathLength > file.size() - sizeof(Header) ||
+        std::memcmp(file.data() + sizeof(Header), sourcePath.data(), sourcePath.size()) != 0)
+        return false;
+
+    if(header.levelOffset > file.size() || header.levelCount > (file.size() - header.levelOffset) / sizeof(Level) ||
+        header.dataOffset > file.size() || header.dataSize > file.size() - header.dataOffset || header.levelCount == 0) {
+        std::cerr << "Texture cache " << cachePath << " is corrupt" << std::endl;
+        return false;
+    }
+
+    CompressedImage out;
+    out.format = static_cast<bc::Format>(header.format);
+    out.width = header.width;
+    out.height = header.height;
+    out.levels.resize(header.levelCount);
+    std::memcpy(out.levels.data(), file.data() + header.levelOffset, header.levelCount * sizeof(Level));
+    for(const Level& level : out.levels) {
+        if(level.offset > header.dataSize || level.size > header.dataSize - level.offset ||
+            level.size != bc::compressedSize(out.format, level.width, level.height)) {
+            std::cerr << "Texture cache " << cachePath << " is corrupt" << std::endl;
+            return false;
+        }
+    }
+    out.data.assign(file.data() + header.dataOffset, file.data() + header.dataOffset + header.dataSize);
+
+    image = std::move(out);
+    return true;
+}
+
+bool texcache::writeCache(const std::string& cachePath, const std::string& sourcePath, TextureCompression compression, TextureUsage usage, const CompressedImage& image) {
+    Header header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.format = static_cast<uint32_t>(image.format);
+    if(!util::fileStamp(sourcePath, header.sourceTime, header.sourceSize))
+        return false;
+    header.settings = settingsKey(compression, usage);
+    header.width = image.width;
+    header.height = image.height;
+    header.levelCount = static_cast<uint32_t>(image.levels.size());
+    header.pathLength = sourcePath.size();
+    header.dataSize = image.data.size();
+
+    // write to a temporary file and rename, so a partially written cache is never read
+    const std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream out{tempPath, std::ios::binary | std::ios::trunc};
+        if(!out.is_open())
+            return false;
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        out.write(sourcePath.data(), sourcePath.size());
+
+        header.levelOffset = align(static_cast<uint64_t>(out.tellp()));
+        pad(out, header.levelOffset);
+        out.write(reinterpret_cast<const char*>(image.levels.data()), image.levels.size() * sizeof(Level));
+
+        header.dataOffset = align(static_cast<uint64_t>(out.tellp()));
+        pad(out, header.dataOffset);
+        out.write(reinterpret_cast<const char*>(image.data.data()), image.data.size());
+
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        if(!out.good())
+            return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if(ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool texcache::bake(const std::string& sourcePath, TextureCompression compression, TextureUsage usage, util::ThreadPool* pool,
+    CompressedImage& image, float* error) {
+    int width, height, channels;
+    unsigned char* pixels = stbi_load(sourcePath.c_str(), &width, &height, &channels, 4);
+    if(!pixels)
+        return false;
+
+    bool hasAlpha = false;
+    if(channels == 2 || channels == 4) {
+        for(size_t i = 0; i < size_t(width) * height && !hasAlpha; ++i)
+            hasAlpha = pixels[i * 4 + 3] != 255;
+    }
+
+    TextureStreamer::Image mips;
+    mips.width = width;
+    mips.height = height;
+    mips.channels = 4;
+    mips.data.assign(pixels, pixels + size_t(width) * height * 4);
+    mips.levelOffsets.assign(1, 0);
+    stbi_image_free(pixels);
+    TextureStreamer::buildMipChain(mips);
+
+    CompressedImage out;
+    out.format = chooseFormat(compression, usage, hasAlpha);
+    out.width = mips.width;
+    out.height = mips.height;
+    uint64_t size = 0;
+    for(size_t l = 0; l < mips.levelOffsets.size(); ++l) {
+        const uint32_t w = std::max(mips.width >> l, 1u), h = std::max(mips.height >> l, 1u);
+        out.levels.push_back(Level{w, h, size, bc::compressedSize(out.format, w, h)});
+        size += out.levels.back().size;
+    }
+    out.data.resize(size);
+
+    for(size_t l = 0; l < out.levels.size(); ++l) {
+        const Level& level = out.levels[l];
+        uint8_t* texels = mips.data.data() + mips.levelOffsets[l];
+        if(usage == TextureUsage::Normal && l > 0)
+            renormalize(texels, size_t(level.width) * level.height);
+        bc::compress(out.format, texels, level.width, level.height, out.data.data() + level.offset, pool);
+    }
+
+    // decode and compare level 0 on the channels the format keeps
+    if(error) {
+        const int compared = out.format == bc::Format::BC5 ? 2 : out.format == bc::Format::BC1 ? 3 : 4;
+        std::vector<uint8_t> decoded(size_t(out.width) * out.height * 4);
+        bc::decompress(out.format, out.data.data(), out.width, out.height, decoded.data());
+        double sum = 0.;
+        for(size_t i = 0; i < size_t(out.width) * out.height; ++i) {
+            for(int c = 0; c < compared; ++c) {
+                const double d = double(decoded[i * 4 + c]) - mips.data[i * 4 + c];
+                sum += d * d;
+            }
+        }
+        *error = static_cast<float>(std::sqrt(sum / (double(out.width) * out.height * compared)));
+    }
+
+    image = std::move(out);
+    return true;
+}
+
+bool texcache::load(const std::string& sourcePath, TextureCompression compression, TextureUsage usage, util::ThreadPool* pool, CompressedImage& image) {
+    const std::string cachePath = sourcePath + FileExtension;
+    if(readCache(cachePath, sourcePath, compression, usage, image))
+        return true;
+
+    float error = 0.f;
+    if(!bake(sourcePath, compression, usage, pool, image, &error))
+        return false;
+    std::cout << "Resource: baked " << sourcePath << " as " << bc::formatName(image.format) << ", " << image.levels.size()
+        << " levels, rms error " << error << std::endl;
+    if(!writeCache(cachePath, sourcePath, compression, usage, image))
+        std::cerr << "Resource: unable to write texture cache " << cachePath << std::endl;
+    return true;
+}
+
+bool texcache::isSupported(TextureCompression compression) {
+    // RGTC and BPTC are core since 3.0 and 4.2, S3TC is an extension
+    if(compression != TextureCompression::BC)
+        return true;
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for(GLint i = 0; i < count; ++i) {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if(name && std::strcmp(name, "GL_EXT_texture_compression_s3tc") == 0)
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file texture_cache.h
+ * @brief baked block compressed textures (.sstex)
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_TEXTURE_CACHE_H
+#define SSRE_TEXTURE_CACHE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <texture.h>
+#include <texture_compress.h>
+
+namespace ssre::util {
+class ThreadPool;
+}
+
+namespace ssre::texcache {
+
+constexpr const char* FileExtension = ".sstex";
+
+/**
+ * @brief one mip level, offset is relative to CompressedImage::data
+ */
+struct Level {
+    uint32_t width;
+    uint32_t height;
+    uint64_t offset;
+    uint64_t size;
+};
+
+/**
+ * @brief Compressed mip chain, ready for upload with glCompressedTexImage2D
+ *
+ *      file layout:
+ *          Header
+ *          source path
+ *          levels  (Level[levelCount])
+ *          data    (16 byte aligned, levels one after another)
+ */
+struct CompressedImage {
+    bc::Format format = bc::Format::BC1;
+    uint32_t width = 0, height = 0;
+    std::vector<Level> levels;
+    std::vector<uint8_t> data;
+};
+
+/**
+ * @brief Compressed format of a source image
+ *
+ * @param compression not TextureCompression::None
+ * @param usage
+ * @param hasAlpha the image has texels that are not opaque
+ */
+bc::Format chooseFormat(TextureCompression compression, TextureUsage usage, bool hasAlpha) noexcept;
+
+/**
+ * @brief Read the cache file at cachePath. Fails if the file is missing, has another version,
+ * was built from a different revision of sourcePath or with other settings.
+ *
+ * @return true image was read
+ */
+bool readCache(const std::string& cachePath, const std::string& sourcePath, TextureCompression compression, TextureUsage usage, CompressedImage& image);
+
+/**
+ * @brief Write image to cachePath, keyed by the current revision of sourcePath and the settings
+ *
+ * @return true cache was written
+ */
+bool writeCache(const std::string& cachePath, const std::string& sourcePath, TextureCompression compression, TextureUsage usage, const CompressedImage& image);
+
+/**
+ * @brief Decode sourcePath with stb_image, build the mip chain and compress every level.
+ * Mips of normal maps are renormalized.
+ *
+ * @param sourcePath
+ * @param compression not TextureCompression::None
+ * @param usage
+ * @param pool if not null, blocks are compressed in parallel. Must not be a pool the caller runs on.
+ * @param image
+ * @param error if not null, root mean square error of the decoded level 0 in 8 bit units
+ * @return false if the file could not be decoded
+ */
+bool bake(const std::string& sourcePath, TextureCompression compression, TextureUsage usage, util::ThreadPool* pool,
+    CompressedImage& image, float* error = nullptr);
+
+/**
+ * @brief Read the cache next to sourcePath, or bake the image and write the cache
+ *
+ * @return false if there is no cache and the file could not be decoded
+ */
+bool load(const std::string& sourcePath, TextureCompression compression, TextureUsage usage, util::ThreadPool* pool, CompressedImage& image);
+
+/**
+ * @brief formats of the compression are supported by the current context
+ */
+bool isSupported(TextureCompression compression);
+
+} // ssre::texcache
+
+#endif // SSRE_TEXTURE_CACHE_H
@@ -0,0 +1,907 @@
+/**
+ * @file texture_compress.cpp
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <texture_compress.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include <thread_pool.h>
+
+using namespace ssre;
+using namespace ssre::bc;
+
+namespace {
+
+using Texels = float[16][4];
+
+/**
+ * @brief mean and principal axis of the first n channels of the first count texels, the axis is zero for uniform blocks
+ */
+void principalAxis(const Texels& texels, int channels, float mean[4], float axis[4], int count = 16) {
+    for(int c = 0; c < 4; ++c) {
+        mean[c] = 0.f;
+        axis[c] = 0.f;
+    }
+    for(int i = 0; i < count; ++i)
+        for(int c = 0; c < channels; ++c)
+            mean[c] += texels[i][c] / count;
+
+    float cov[4][4] = {};
+    for(int i = 0; i < count; ++i)
+        for(int a = 0; a < channels; ++a)
+            for(int b = 0; b < channels; ++b)
+                cov[a][b] += (texels[i][a] - mean[a]) * (texels[i][b] - mean[b]);
+
+    // power iteration, converges quickly enough for a 4x4 block
+    float v[4] = {1.f, 1.f, 1.f, 1.f};
+    for(int it = 0; it < 8; ++it) {
+        float w[4] = {};
+        for(int a = 0; a < channels; ++a)
+            for(int b = 0; b < channels; ++b)
+                w[a] += cov[a][b] * v[b];
+        float len = 0.f;
+        for(int a = 0; a < channels; ++a)
+            len += w[a] * w[a];
+        len = std::sqrt(len);
+        if(len < 1e-6f)
+            return;
+        for(int a = 0; a < channels; ++a)
+            v[a] = w[a] / len;
+    }
+    for(int a = 0; a < channels; ++a)
+        axis[a] = v[a];
+}
+
+/**
+ * @brief endpoints at the extremes of the texels projected on the principal axis
+ */
+void axisEndpoints(const Texels& texels, int channels, float e0[4], float e1[4], int count = 16) {
+    float mean[4], axis[4];
+    principalAxis(texels, channels, mean, axis, count);
+    float lo = 0.f, hi = 0.f;
+    for(int i = 0; i < count; ++i) {
+        float p = 0.f;
+        for(int c = 0; c < channels; ++c)
+            p += (texels[i][c] - mean[c]) * axis[c];
+        lo = std::min(lo, p);
+        hi = std::max(hi, p);
+    }
+    for(int c = 0; c < 4; ++c) {
+        e0[c] = std::clamp(mean[c] + axis[c] * hi, 0.f, 255.f);
+        e1[c] = std::clamp(mean[c] + axis[c] * lo, 0.f, 255.f);
+    }
+}
+
+/**
+ * @brief least squares endpoints for fixed interpolation weights, t is the weight of e1. False if the system is singular.
+ */
+bool fitEndpoints(const Texels& texels, int channels, const float t[16], float e0[4], float e1[4], int count = 16) {
+    float a = 0.f, b = 0.f, c = 0.f;
+    float x0[4] = {}, x1[4] = {};
+    for(int i = 0; i < count; ++i) {
+        const float s = 1.f - t[i];
+        a += s * s;
+        b += s * t[i];
+        c += t[i] * t[i];
+        for(int k = 0; k < channels; ++k) {
+            x0[k] += s * texels[i][k];
+            x1[k] += t[i] * texels[i][k];
+        }
+    }
+    const float det = a * c - b * b;
+    if(std::abs(det) < 1e-6f)
+        return false;
+    for(int k = 0; k < channels; ++k) {
+        e0[k] = std::clamp((c * x0[k] - b * x1[k]) / det, 0.f, 255.f);
+        e1[k] = std::clamp((a * x1[k] - b * x0[k]) / det, 0.f, 255.f);
+    }
+    return true;
+}
+
+void loadTexels(const uint8_t* rgba, Texels& texels) {
+    for(int i = 0; i < 16; ++i)
+        for(int c = 0; c < 4; ++c)
+            texels[i][c] = rgba[i * 4 + c];
+}
+
+void write16(uint8_t* out, uint16_t v) {
+    out[0] = static_cast<uint8_t>(v);
+    out[1] = static_cast<uint8_t>(v >> 8);
+}
+
+uint16_t read16(const uint8_t* in) {
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+///////////////////////////////////
+// BC1 color
+
+uint16_t pack565(const float c[3]) {
+    const int r = static_cast<int>(std::lround(c[0] * 31.f / 255.f));
+    const int g = static_cast<int>(std::lround(c[1] * 63.f / 255.f));
+    const int b = static_cast<int>(std::lround(c[2] * 31.f / 255.f));
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void unpack565(uint16_t v, int out[3]) {
+    const int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+void colorPalette(uint16_t c0, uint16_t c1, int palette[4][3]) {
+    unpack565(c0, palette[0]);
+    unpack565(c1, palette[1]);
+    for(int k = 0; k < 3; ++k) {
+        if(c0 > c1) {
+            palette[2][k] = (2 * palette[0][k] + palette[1][k]) / 3;
+            palette[3][k] = (palette[0][k] + 2 * palette[1][k]) / 3;
+        } else {
+            palette[2][k] = (palette[0][k] + palette[1][k]) / 2;
+            palette[3][k] = 0;
+        }
+    }
+}
+
+struct ColorBlock {
+    uint16_t c0, c1;
+    uint32_t indices;
+    float error;
+};
+
+ColorBlock fitColor(const Texels& texels, const float e0[4], const float e1[4]) {
+    ColorBlock block{pack565(e0), pack565(e1), 0, 0.f};
+    if(block.c0 < block.c1)
+        std::swap(block.c0, block.c1);
+
+    // equal endpoints select three color mode, index 0 is still c0
+    int palette[4][3];
+    colorPalette(block.c0, block.c1, palette);
+    const int paletteSize = block.c0 > block.c1 ? 4 : 1;
+    for(int i = 0; i < 16; ++i) {
+        float best = 1e30f;
+        uint32_t bestIndex = 0;
+        for(int p = 0; p < paletteSize; ++p) {
+            float err = 0.f;
+            for(int k = 0; k < 3; ++k) {
+                const float d = texels[i][k] - palette[p][k];
+                err += d * d;
+            }
+            if(err < best) {
+                best = err;
+                bestIndex = p;
+            }
+        }
+        block.indices |= bestIndex << (2 * i);
+        block.error += best;
+    }
+    return block;
+}
+
+void encodeColor(const uint8_t* rgba, uint8_t* out) {
+    Texels texels;
+    loadTexels(rgba, texels);
+
+    float e0[4], e1[4];
+    axisEndpoints(texels, 3, e0, e1);
+    ColorBlock best = fitColor(texels, e0, e1);
+
+    // one refinement of the endpoints for the chosen indices
+    static constexpr float Weights[4] = {0.f, 1.f, 1.f / 3.f, 2.f / 3.f};
+    float t[16];
+    for(int i = 0; i < 16; ++i)
+        t[i] = Weights[(best.indices >> (2 * i)) & 3];
+    if(fitEndpoints(texels, 3, t, e0, e1)) {
+        ColorBlock refined = fitColor(texels, e0, e1);
+        if(refined.error < best.error)
+            best = refined;
+    }
+
+    write16(out, best.c0);
+    write16(out + 2, best.c1);
+    for(int i = 0; i < 4; ++i)
+        out[4 + i] = static_cast<uint8_t>(best.indices >> (8 * i));
+}
+
+void decodeColor(const uint8_t* block, uint8_t* rgba) {
+    const uint16_t c0 = read16(block), c1 = read16(block + 2);
+    int palette[4][3];
+    colorPalette(c0, c1, palette);
+    for(int i = 0; i < 16; ++i) {
+        const int index = (block[4 + i / 4] >> (2 * (i % 4))) & 3;
+        for(int k = 0; k < 3; ++k)
+            rgba[i * 4 + k] = static_cast<uint8_t>(palette[index][k]);
+        rgba[i * 4 + 3] = (c0 <= c1 && index == 3) ? 0 : 255;
+    }
+}
+
+///////////////////////////////////
+// BC4 single channel, the alpha of BC3 and both channels of BC5
+
+void channelPalette(uint8_t a0, uint8_t a1, int palette[8]) {
+    palette[0] = a0;
+    palette[1] = a1;
+    if(a0 > a1) {
+        for(int k = 2; k < 8; ++k)
+            palette[k] = ((8 - k) * a0 + (k - 1) * a1 + 3) / 7;
+    } else {
+        for(int k = 2; k < 6; ++k)
+            palette[k] = ((6 - k) * a0 + (k - 1) * a1 + 2) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+void encodeChannel(const uint8_t* rgba, int channel, uint8_t* out) {
+    uint8_t lo = 255, hi = 0;
+    for(int i = 0; i < 16; ++i) {
+        lo = std::min(lo, rgba[i * 4 + channel]);
+        hi = std::max(hi, rgba[i * 4 + channel]);
+    }
+
+    // eight value mode, equal endpoints leave every index at 0
+    int palette[8];
+    channelPalette(hi, lo, palette);
+    uint64_t indices = 0;
+    if(hi > lo) {
+        for(int i = 0; i < 16; ++i) {
+            const int v = rgba[i * 4 + channel];
+            int best = 256;
+            uint64_t bestIndex = 0;
+            for(int p = 0; p < 8; ++p) {
+                const int err = std::abs(v - palette[p]);
+                if(err < best) {
+                    best = err;
+                    bestIndex = p;
+                }
+            }
+            indices |= bestIndex << (3 * i);
+        }
+    }
+
+    out[0] = hi;
+    out[1] = lo;
+    for(int i = 0; i < 6; ++i)
+        out[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+}
+
+void decodeChannel(const uint8_t* block, int channel, uint8_t* rgba) {
+    int palette[8];
+    channelPalette(block[0], block[1], palette);
+    uint64_t indices = 0;
+    for(int i = 0; i < 6; ++i)
+        indices |= uint64_t{block[2 + i]} << (8 * i);
+    for(int i = 0; i < 16; ++i)
+        rgba[i * 4 + channel] = static_cast<uint8_t>(palette[(indices >> (3 * i)) & 7]);
+}
+
+///////////////////////////////////
+// BC7 mode 6, one subset with 7 bit rgba endpoints, a p-bit per endpoint and 4 bit indices
+
+constexpr int BC7Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct BC7Block {
+    uint8_t endpoint[2][4];    // 7 bit
+    uint8_t pbit[2];
+    uint8_t indices[16];
+    float error;
+};
+
+void quantizeEndpoint(const float e[4], uint8_t q[4], uint8_t& pbit) {
+    float bestErr = 1e30f;
+    for(uint8_t p = 0; p < 2; ++p) {
+        uint8_t candidate[4];
+        float err = 0.f;
+        for(int c = 0; c < 4; ++c) {
+            candidate[c] = static_cast<uint8_t>(std::clamp<long>(std::lround((e[c] - p) / 2.f), 0, 127));
+            const float d = e[c] - (candidate[c] * 2 + p);
+            err += d * d;
+        }
+        if(err < bestErr) {
+            bestErr = err;
+            pbit = p;
+            std::memcpy(q, candidate, 4);
+        }
+    }
+}
+
+void bc7Palette(const uint8_t endpoint[2][4], const uint8_t pbit[2], int palette[16][4]) {
+    for(int c = 0; c < 4; ++c) {
+        const int a = endpoint[0][c] * 2 + pbit[0], b = endpoint[1][c] * 2 + pbit[1];
+        for(int k = 0; k < 16; ++k)
+            palette[k][c] = ((64 - BC7Weights[k]) * a + BC7Weights[k] * b + 32) >> 6;
+    }
+}
+
+BC7Block fitBC7(const Texels& texels, const float e0[4], const float e1[4]) {
+    BC7Block block{};
+    quantizeEndpoint(e0, block.endpoint[0], block.pbit[0]);
+    quantizeEndpoint(e1, block.endpoint[1], block.pbit[1]);
+
+    int palette[16][4];
+    bc7Palette(block.endpoint, block.pbit, palette);
+    for(int i = 0; i < 16; ++i) {
+        float best = 1e30f;
+        for(int p = 0; p < 16; ++p) {
+            float err = 0.f;
+            for(int c = 0; c < 4; ++c) {
+                const float d = texels[i][c] - palette[p][c];
+                err += d * d;
+            }
+            if(err < best) {
+                best = err;
+                block.indices[i] = static_cast<uint8_t>(p);
+            }
+        }
+        block.error += best;
+    }
+    return block;
+}
+
+/**
+ * @brief least significant bit first, as BC7 blocks are laid out
+ */
+class BitWriter {
+public:
+    explicit BitWriter(uint8_t* out) : out{out} {std::memset(out, 0, 16);}
+
+    void write(uint32_t value, int bits) {
+        for(int i = 0; i < bits; ++i, ++pos) {
+            if((value >> i) & 1)
+                out[pos / 8] |= static_cast<uint8_t>(1 << (pos % 8));
+        }
+    }
+
+private:
+    uint8_t* out;
+    int pos = 0;
+};
+
+class BitReader {
+public:
+    explicit BitReader(const uint8_t* in) : in{in} {}
+
+    uint32_t read(int bits) {
+        uint32_t value = 0;
+        for(int i = 0; i < bits; ++i, ++pos)
+            value |= uint32_t{(in[pos / 8] >> (pos % 8)) & 1u} << i;
+        return value;
+    }
+
+private:
+    const uint8_t* in;
+    int pos = 0;
+};
+
+///////////////////////////////////
+// BC7 two subset modes, texels are split by one of 64 partitions and each subset gets its own endpoints
+
+// bit i is the subset of texel i
+constexpr uint16_t BC7Partitions[64] = {
+    0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80,
+    0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+    0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce,
+    0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+    0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a,
+    0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+    0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c,
+    0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22
+};
+
+// texel of subset 1 whose index msb is implied 0, texel 0 is the anchor of subset 0
+constexpr uint8_t BC7Anchors[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+    15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+    6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15
+};
+
+constexpr int BC7Weights2[4] = {0, 21, 43, 64};
+constexpr int BC7Weights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+
+struct BC7SubsetMode {
+    uint32_t mode;
+    int channels;       // alpha decodes to 255 in rgb modes
+    int endpointBits;   // without the p-bit
+    bool sharedPbit;    // one p-bit per subset instead of one per endpoint
+    int indexBits;
+    const int* weights;
+};
+
+// opaque blocks, 6 bit rgb endpoints with a p-bit per subset and 3 bit indices
+constexpr BC7SubsetMode BC7Mode1{1, 3, 6, true, 3, BC7Weights3};
+// blocks with alpha, 5 bit rgba endpoints with a p-bit per endpoint and 2 bit indices
+constexpr BC7SubsetMode BC7Mode7{7, 4, 5, false, 2, BC7Weights2};
+
+// partitions fitted with quantized endpoints, the best ranked by the distance of their subsets to a line
+constexpr int BC7PartitionCandidates = 4;
+
+struct BC7Subsets {
+    uint32_t partition;
+    uint8_t endpoint[2][2][4];  // subset, endpoint, channel
+    uint8_t pbit[2][2];
+    uint8_t indices[16];
+    float error;
+};
+
+/**
+ * @brief 8 bit value of an endpoint, bits counts the endpoint with its p-bit
+ */
+int bc7Unquantize(int value, int bits) {
+    return (value << (8 - bits)) | (value >> (2 * bits - 8));
+}
+
+/**
+ * @brief closest endpoint channel for a p-bit, error is the squared distance of the 8 bit value
+ */
+uint8_t bc7QuantizeChannel(float e, int pbit, int bits, float& error) {
+    const int guess = static_cast<int>(std::lround((e * ((2 << bits) - 1) / 255.f - pbit) / 2.f));
+    int best = 0;
+    error = 1e30f;
+    for(int q = std::max(guess - 1, 0); q <= std::min(guess + 1, (1 << bits) - 1); ++q) {
+        const float d = e - bc7Unquantize(q * 2 + pbit, bits + 1);
+        if(d * d < error) {
+            error = d * d;
+            best = q;
+        }
+    }
+    return static_cast<uint8_t>(best);
+}
+
+void bc7SubsetPalette(const BC7SubsetMode& mode, const uint8_t endpoint[2][4], const uint8_t pbit[2], int palette[8][4]) {
+    for(int c = 0; c < 4; ++c) {
+        const int a = c < mode.channels ? bc7Unquantize(endpoint[0][c] * 2 + pbit[0], mode.endpointBits + 1) : 255;
+        const int b = c < mode.channels ? bc7Unquantize(endpoint[1][c] * 2 + pbit[1], mode.endpointBits + 1) : 255;
+        for(int k = 0; k < (1 << mode.indexBits); ++k)
+            palette[k][c] = ((64 - mode.weights[k]) * a + mode.weights[k] * b + 32) >> 6;
+    }
+}
+
+/**
+ * @brief texels of one subset of a partition, texel holds their positions in the block
+ *
+ * @return number of texels in the subset
+ */
+int bc7Subset(const Texels& texels, uint32_t partition, int subset, Texels& out, uint8_t texel[16]) {
+    int count = 0;
+    for(int i = 0; i < 16; ++i) {
+        if(static_cast<int>((BC7Partitions[partition] >> i) & 1) != subset)
+            continue;
+        std::memcpy(out[count], texels[i], sizeof(out[count]));
+        texel[count++] = static_cast<uint8_t>(i);
+    }
+    return count;
+}
+
+/**
+ * @brief sums of texels and of their channel products, the moments of a subset add up the moments of its texels
+ */
+struct BC7Moments {
+    float count = 0.f;
+    float sum[4] = {};
+    float product[4][4] = {};
+
+    void add(const BC7Moments& other, float sign) {
+        count += sign * other.count;
+        for(int a = 0; a < 4; ++a) {
+            sum[a] += sign * other.sum[a];
+            for(int b = 0; b < 4; ++b)
+                product[a][b] += sign * other.product[a][b];
+        }
+    }
+};
+
+/**
+ * @brief squared distance of the texels to their principal axis, the total variance less the variance along the axis
+ */
+float bc7LineError(const BC7Moments& m, int channels) {
+    float cov[4][4];
+    float total = 0.f;
+    for(int a = 0; a < channels; ++a) {
+        for(int b = 0; b < channels; ++b)
+            cov[a][b] = m.product[a][b] - m.sum[a] * m.sum[b] / m.count;
+        total += cov[a][a];
+    }
+
+    // a few power iterations rank partitions well enough, the fit of the candidates decides
+    float v[4] = {1.f, 1.f, 1.f, 1.f};
+    float w[4] = {};
+    for(int it = 0; it < 4; ++it) {
+        float len = 0.f;
+        for(int a = 0; a < channels; ++a) {
+            w[a] = 0.f;
+            for(int b = 0; b < channels; ++b)
+                w[a] += cov[a][b] * v[b];
+            len += w[a] * w[a];
+        }
+        len = std::sqrt(len);
+        if(len < 1e-6f)
+            return total;
+        for(int a = 0; a < channels; ++a)
+            v[a] = w[a] / len;
+    }
+    float axial = 0.f;
+    for(int a = 0; a < channels; ++a)
+        for(int b = 0; b < channels; ++b)
+            axial += v[a] * cov[a][b] * v[b];
+    return total - axial;
+}
+
+/**
+ * @brief quantize the endpoints of the first count texels and pick their indices
+ *
+ * @return squared error of the subset
+ */
+float fitBC7Subset(const BC7SubsetMode& mode, const Texels& texels, int count, const float e0[4], const float e1[4],
+    uint8_t endpoint[2][4], uint8_t pbit[2], uint8_t indices[16]) {
+    // quantized endpoints and their error for both p-bits
+    uint8_t q[2][2][4] = {};
+    float pbitError[2][2] = {};
+    for(int p = 0; p < 2; ++p) {
+        for(int c = 0; c < mode.channels; ++c) {
+            float err;
+            q[p][0][c] = bc7QuantizeChannel(e0[c], p, mode.endpointBits, err);
+            pbitError[0][p] += err;
+            q[p][1][c] = bc7QuantizeChannel(e1[c], p, mode.endpointBits, err);
+            pbitError[1][p] += err;
+        }
+    }
+    for(int k = 0; k < 2; ++k) {
+        if(mode.sharedPbit)
+            pbit[k] = pbitError[0][1] + pbitError[1][1] < pbitError[0][0] + pbitError[1][0] ? 1 : 0;
+        else
+            pbit[k] = pbitError[k][1] < pbitError[k][0] ? 1 : 0;
+        std::memcpy(endpoint[k], q[pbit[k]][k], 4);
+    }
+
+    int palette[8][4];
+    bc7SubsetPalette(mode, endpoint, pbit, palette);
+    float error = 0.f;
+    for(int i = 0; i < count; ++i) {
+        float best = 1e30f;
+        for(int p = 0; p < (1 << mode.indexBits); ++p) {
+            float err = 0.f;
+            for(int c = 0; c < mode.channels; ++c) {
+                const float d = texels[i][c] - palette[p][c];
+                err += d * d;
+            }
+            if(err < best) {
+                best = err;
+                indices[i] = static_cast<uint8_t>(p);
+            }
+        }
+        error += best;
+    }
+    return error;
+}
+
+BC7Subsets fitBC7Subsets(const BC7SubsetMode& mode, const Texels& texels, uint32_t partition) {
+    BC7Subsets block{};
+    block.partition = partition;
+    for(int s = 0; s < 2; ++s) {
+        Texels subset;
+        uint8_t texel[16];
+        const int count = bc7Subset(texels, partition, s, subset, texel);
+
+        float e0[4], e1[4];
+        axisEndpoints(subset, mode.channels, e0, e1, count);
+        uint8_t indices[16];
+        float error = fitBC7Subset(mode, subset, count, e0, e1, block.endpoint[s], block.pbit[s], indices);
+
+        // one refinement of the endpoints for the chosen indices
+        float t[16];
+        for(int i = 0; i < count; ++i)
+            t[i] = mode.weights[indices[i]] / 64.f;
+        if(fitEndpoints(subset, mode.channels, t, e0, e1, count)) {
+            uint8_t endpoint[2][4], pbit[2], refinedIndices[16];
+            const float refined = fitBC7Subset(mode, subset, count, e0, e1, endpoint, pbit, refinedIndices);
+            if(refined < error) {
+                error = refined;
+                std::memcpy(block.endpoint[s], endpoint, sizeof(endpoint));
+                std::memcpy(block.pbit[s], pbit, sizeof(pbit));
+                std::memcpy(indices, refinedIndices, sizeof(refinedIndices));
+            }
+        }
+        for(int i = 0; i < count; ++i)
+            block.indices[texel[i]] = indices[i];
+        block.error += error;
+    }
+    return block;
+}
+
+BC7Subsets encodeBC7Subsets(const BC7SubsetMode& mode, const Texels& texels) {
+    BC7Moments moments[16], block;
+    for(int i = 0; i < 16; ++i) {
+        moments[i].count = 1.f;
+        for(int a = 0; a < mode.channels; ++a) {
+            moments[i].sum[a] = texels[i][a];
+            for(int b = 0; b < mode.channels; ++b)
+                moments[i].product[a][b] = texels[i][a] * texels[i][b];
+        }
+        block.add(moments[i], 1.f);
+    }
+
+    // rank the partitions by the distance of their subsets to a line
+    std::pair<float, uint32_t> ranked[64];
+    for(uint32_t p = 0; p < 64; ++p) {
+        BC7Moments subset;
+        for(int i = 0; i < 16; ++i) {
+            if((BC7Partitions[p] >> i) & 1)
+                subset.add(moments[i], 1.f);
+        }
+        BC7Moments rest = block;
+        rest.add(subset, -1.f);
+        ranked[p] = {bc7LineError(rest, mode.channels) + bc7LineError(subset, mode.channels), p};
+    }
+    std::partial_sort(ranked, ranked + BC7PartitionCandidates, ranked + 64);
+
+    BC7Subsets best = fitBC7Subsets(mode, texels, ranked[0].second);
+    for(int i = 1; i < BC7PartitionCandidates; ++i) {
+        const BC7Subsets candidate = fitBC7Subsets(mode, texels, ranked[i].second);
+        if(candidate.error < best.error)
+            best = candidate;
+    }
+    return best;
+}
+
+void writeBC7Subsets(const BC7SubsetMode& mode, BC7Subsets& block, uint8_t* out) {
+    // the msb of the index of each subset's anchor texel is implied 0
+    const int anchors[2] = {0, BC7Anchors[block.partition]};
+    const int top = (1 << mode.indexBits) - 1;
+    for(int s = 0; s < 2; ++s) {
+        if(block.indices[anchors[s]] <= top / 2)
+            continue;
+        std::swap(block.endpoint[s][0], block.endpoint[s][1]);
+        std::swap(block.pbit[s][0], block.pbit[s][1]);
+        for(int i = 0; i < 16; ++i) {
+            if(static_cast<int>((BC7Partitions[block.partition] >> i) & 1) == s)
+                block.indices[i] = static_cast<uint8_t>(top - block.indices[i]);
+        }
+    }
+
+    BitWriter bits{out};
+    bits.write(1u << mode.mode, mode.mode + 1);
+    bits.write(block.partition, 6);
+    for(int c = 0; c < mode.channels; ++c)
+        for(int s = 0; s < 2; ++s)
+            for(int k = 0; k < 2; ++k)
+                bits.write(block.endpoint[s][k][c], mode.endpointBits);
+    for(int s = 0; s < 2; ++s) {
+        bits.write(block.pbit[s][0], 1);
+        if(!mode.sharedPbit)
+            bits.write(block.pbit[s][1], 1);
+    }
+    for(int i = 0; i < 16; ++i)
+        bits.write(block.indices[i], i == anchors[0] || i == anchors[1] ? mode.indexBits - 1 : mode.indexBits);
+}
+
+void decodeBC7Subsets(const BC7SubsetMode& mode, const uint8_t* block, uint8_t* rgba) {
+    BitReader bits{block};
+    bits.read(mode.mode + 1);
+    const uint32_t partition = bits.read(6);
+    uint8_t endpoint[2][2][4] = {};
+    uint8_t pbit[2][2];
+    for(int c = 0; c < mode.channels; ++c)
+        for(int s = 0; s < 2; ++s)
+            for(int k = 0; k < 2; ++k)
+                endpoint[s][k][c] = static_cast<uint8_t>(bits.read(mode.endpointBits));
+    for(int s = 0; s < 2; ++s) {
+        pbit[s][0] = static_cast<uint8_t>(bits.read(1));
+        pbit[s][1] = mode.sharedPbit ? pbit[s][0] : static_cast<uint8_t>(bits.read(1));
+    }
+
+    int palette[2][8][4];
+    for(int s = 0; s < 2; ++s)
+        bc7SubsetPalette(mode, endpoint[s], pbit[s], palette[s]);
+    for(int i = 0; i < 16; ++i) {
+        const int subset = (BC7Partitions[partition] >> i) & 1;
+        const uint32_t index = bits.read(i == 0 || i == BC7Anchors[partition] ? mode.indexBits - 1 : mode.indexBits);
+        for(int c = 0; c < 4; ++c)
+            rgba[i * 4 + c] = static_cast<uint8_t>(palette[subset][index][c]);
+    }
+}
+
+///////////////////////////////////
+
+void encodeBC7(const uint8_t* rgba, uint8_t* out) {
+    Texels texels;
+    loadTexels(rgba, texels);
+
+    float e0[4], e1[4];
+    axisEndpoints(texels, 4, e0, e1);
+    BC7Block best = fitBC7(texels, e0, e1);
+
+    float t[16];
+    for(int i = 0; i < 16; ++i)
+        t[i] = BC7Weights[best.indices[i]] / 64.f;
+    if(fitEndpoints(texels, 4, t, e0, e1)) {
+        BC7Block refined = fitBC7(texels, e0, e1);
+        if(refined.error < best.error)
+            best = refined;
+    }
+
+    // blocks whose texels do not lie on one line are split in two subsets, opaque blocks keep more index precision
+    if(best.error > 0.f) {
+        bool opaque = true;
+        for(int i = 0; i < 16; ++i)
+            opaque &= rgba[i * 4 + 3] == 255;
+        const BC7SubsetMode& mode = opaque ? BC7Mode1 : BC7Mode7;
+        BC7Subsets subsets = encodeBC7Subsets(mode, texels);
+        if(subsets.error < best.error) {
+            writeBC7Subsets(mode, subsets, out);
+            return;
+        }
+    }
+
+    // the msb of the first index is implied 0
+    if(best.indices[0] >= 8) {
+        std::swap(best.endpoint[0], best.endpoint[1]);
+        std::swap(best.pbit[0], best.pbit[1]);
+        for(uint8_t& index : best.indices)
+            index = static_cast<uint8_t>(15 - index);
+    }
+
+    BitWriter bits{out};
+    bits.write(1 << 6, 7);
+    for(int c = 0; c < 4; ++c) {
+        bits.write(best.endpoint[0][c], 7);
+        bits.write(best.endpoint[1][c], 7);
+    }
+    bits.write(best.pbit[0], 1);
+    bits.write(best.pbit[1], 1);
+    bits.write(best.indices[0], 3);
+    for(int i = 1; i < 16; ++i)
+        bits.write(best.indices[i], 4);
+}
+
+void decodeBC7(const uint8_t* block, uint8_t* rgba) {
+    // the mode is the number of 0 bits before the first 1 bit
+    if((block[0] & 0x03) == 0x02) {
+        decodeBC7Subsets(BC7Mode1, block, rgba);
+        return;
+    }
+    if(block[0] == 0x80) {
+        decodeBC7Subsets(BC7Mode7, block, rgba);
+        return;
+    }
+    // other modes are never written, they decode to transparent black
+    if((block[0] & 0x7f) != 0x40) {
+        std::memset(rgba, 0, 64);
+        return;
+    }
+    BitReader bits{block};
+    bits.read(7);
+    uint8_t endpoint[2][4], pbit[2];
+    for(int c = 0; c < 4; ++c) {
+        endpoint[0][c] = static_cast<uint8_t>(bits.read(7));
+        endpoint[1][c] = static_cast<uint8_t>(bits.read(7));
+    }
+    pbit[0] = static_cast<uint8_t>(bits.read(1));
+    pbit[1] = static_cast<uint8_t>(bits.read(1));
+
+    int palette[16][4];
+    bc7Palette(endpoint, pbit, palette);
+    for(int i = 0; i < 16; ++i) {
+        const uint32_t index = bits.read(i == 0 ? 3 : 4);
+        for(int c = 0; c < 4; ++c)
+            rgba[i * 4 + c] = static_cast<uint8_t>(palette[index][c]);
+    }
+}
+
+} // namespace
+
+GLenum bc::glFormat(Format format) noexcept {
+    switch(format) {
+    case Format::BC1:
+        return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case Format::BC3:
+        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case Format::BC5:
+        return GL_COMPRESSED_RG_RGTC2;
+    default:
+        return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    }
+}
+
+const char* bc::formatName(Format format) noexcept {
+    switch(format) {
+    case Format::BC1:
+        return "BC1";
+    case Format::BC3:
+        return "BC3";
+    case Format::BC5:
+        return "BC5";
+    default:
+        return "BC7";
+    }
+}
+
+void bc::encodeBlock(Format format, const uint8_t* rgba, uint8_t* out) {
+    switch(format) {
+    case Format::BC1:
+        encodeColor(rgba, out);
+        break;
+    case Format::BC3:
+        encodeChannel(rgba, 3, out);
+        encodeColor(rgba, out + 8);
+        break;
+    case Format::BC5:
+        encodeChannel(rgba, 0, out);
+        encodeChannel(rgba, 1, out + 8);
+        break;
+    case Format::BC7:
+        encodeBC7(rgba, out);
+        break;
+    }
+}
+
+void bc::decodeBlock(Format format, const uint8_t* block, uint8_t* rgba) {
+    switch(format) {
+    case Format::BC1:
+        decodeColor(block, rgba);
+        break;
+    case Format::BC3:
+        decodeColor(block + 8, rgba);
+        decodeChannel(block, 3, rgba);
+        break;
+    case Format::BC5:
+        for(int i = 0; i < 16; ++i) {
+            rgba[i * 4 + 2] = 0;
+            rgba[i * 4 + 3] = 255;
+        }
+        decodeChannel(block, 0, rgba);
+        decodeChannel(block + 8, 1, rgba);
+        break;
+    case Format::BC7:
+        decodeBC7(block, rgba);
+        break;
+    }
+}
+
+void bc::compress(Format format, const uint8_t* rgba, uint32_t width, uint32_t height, uint8_t* out, util::ThreadPool* pool) {
+    const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    const std::size_t bytes = blockBytes(format);
+    auto encodeRow = [&](std::size_t by) {
+        uint8_t block[64];
+        for(uint32_t bx = 0; bx < blocksX; ++bx) {
+            for(uint32_t y = 0; y < 4; ++y) {
+                const uint32_t sy = std::min<uint32_t>(static_cast<uint32_t>(by) * 4 + y, height - 1);
+                for(uint32_t x = 0; x < 4; ++x) {
+                    const uint32_t sx = std::min(bx * 4 + x, width - 1);
+                    std::memcpy(block + (y * 4 + x) * 4, rgba + (std::size_t{sy} * width + sx) * 4, 4);
+                }
+            }
+            encodeBlock(format, block, out + (by * blocksX + bx) * bytes);
+        }
+    };
+
+    if(pool && pool->size() > 1 && blocksY > 1) {
+        pool->parallel_for(blocksY, encodeRow);
+    } else {
+        for(uint32_t by = 0; by < blocksY; ++by)
+            encodeRow(by);
+    }
+}
+
+void bc::decompress(Format format, const uint8_t* data, uint32_t width, uint32_t height, uint8_t* rgba) {
+    const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    const std::size_t bytes = blockBytes(format);
+    uint8_t block[64];
+    for(uint32_t by = 0; by < blocksY; ++by) {
+        for(uint32_t bx = 0; bx < blocksX; ++bx) {
+            decodeBlock(format, data + (std::size_t{by} * blocksX + bx) * bytes, block);
+            for(uint32_t y = 0; y < 4 && by * 4 + y < height; ++y) {
+                for(uint32_t x = 0; x < 4 && bx * 4 + x < width; ++x)
+                    std::memcpy(rgba + ((std::size_t{by} * 4 + y) * width + bx * 4 + x) * 4, block + (y * 4 + x) * 4, 4);
+            }
+        }
+    }
+}
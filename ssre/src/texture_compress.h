@@ -0,0 +1,99 @@
+/**
+ * @file texture_compress.h
+ * @brief BC1, BC3, BC5 and BC7 block compression
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+#ifndef SSRE_TEXTURE_COMPRESS_H
+#define SSRE_TEXTURE_COMPRESS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <ssre_gl.h>
+
+// S3TC is an extension, glad only generates core enums
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+namespace ssre::util {
+class ThreadPool;
+}
+
+namespace ssre::bc {
+
+/**
+ * @brief Block formats, every block covers 4x4 texels
+ *
+ *      BC1 rgb, 8 bytes, opaque color
+ *      BC3 rgba, 16 bytes, color with alpha
+ *      BC5 rg, 16 bytes, tangent space normal xy
+ *      BC7 rgba, 16 bytes, high quality color, written with mode 6 and the two subset modes 1 (opaque) and 7
+ */
+enum class Format : uint32_t {
+    BC1,
+    BC3,
+    BC5,
+    BC7
+};
+
+constexpr std::size_t blockBytes(Format format) noexcept {return format == Format::BC1 ? 8 : 16;}
+
+constexpr std::size_t compressedSize(Format format, uint32_t width, uint32_t height) noexcept {
+    return std::size_t{(width + 3) / 4} * ((height + 3) / 4) * blockBytes(format);
+}
+
+GLenum glFormat(Format format) noexcept;
+
+const char* formatName(Format format) noexcept;
+
+/**
+ * @brief Compress one block
+ *
+ * @param format
+ * @param rgba 16 texels in rows, 4 bytes each
+ * @param out blockBytes(format) bytes
+ */
+void encodeBlock(Format format, const uint8_t* rgba, uint8_t* out);
+
+/**
+ * @brief Decompress one block written by encodeBlock. BC5 decodes to (r, g, 0, 255).
+ *
+ * @param format
+ * @param block
+ * @param rgba 16 texels in rows, 4 bytes each
+ */
+void decodeBlock(Format format, const uint8_t* block, uint8_t* rgba);
+
+/**
+ * @brief Compress an image, edge blocks repeat the last row and column
+ *
+ * @param format
+ * @param rgba width * height texels, 4 bytes each
+ * @param width
+ * @param height
+ * @param out compressedSize(format, width, height) bytes
+ * @param pool if not null, rows of blocks are compressed in parallel
+ */
+void compress(Format format, const uint8_t* rgba, uint32_t width, uint32_t height, uint8_t* out, util::ThreadPool* pool = nullptr);
+
+/**
+ * @brief Decompress an image written by compress
+ *
+ * @param format
+ * @param data
+ * @param width
+ * @param height
+ * @param rgba width * height texels, 4 bytes each
+ */
+void decompress(Format format, const uint8_t* data, uint32_t width, uint32_t height, uint8_t* rgba);
+
+} // ssre::bc
+
+#endif // SSRE_TEXTURE_COMPRESS_H
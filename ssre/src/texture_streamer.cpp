@@ -0,0 +1,263 @@
+/**
+ * @file texture_streamer.cpp
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+
+#include <texture_streamer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include <texture.h>
+#include <texture_cache.h>
+#include <thread_pool.h>
+
+#include <stb_image.h>
+
+using namespace ssre;
+
+namespace {
+
+gl::PixelFormat channelFormat(uint32_t channels) {
+    switch(channels) {
+    case 1:
+        return gl::PixelFormat::RED;
+    case 3:
+        return gl::PixelFormat::RGB;
+    default:
+        return gl::PixelFormat::RGBA;
+    }
+}
+
+gl::TextureInternalFormat channelInternalFormat(uint32_t channels) {
+    switch(channels) {
+    case 1:
+        return gl::TextureInternalFormat::RED;
+    case 3:
+        return gl::TextureInternalFormat::RGB;
+    default:
+        return gl::TextureInternalFormat::RGBA;
+    }
+}
+
+}
+
+TextureStreamer::TextureStreamer(util::ThreadPool& workers, uint32_t maxInFlight) : workers{workers}, maxInFlight{std::max(maxInFlight, 1u)} {
+
+}
+
+TextureStreamer::~TextureStreamer() {
+    // decode jobs refer to this streamer
+    {
+        std::unique_lock<std::mutex> lock{readyMutex};
+        readyCondition.wait(lock, [this]() {return decoding == 0;});
+    }
+    for(Staging& s : staging) {
+        if(s.fence)
+            glDeleteSync(s.fence);
+        if(s.buffer)
+            glDeleteBuffers(1, &s.buffer);
+    }
+}
+
+void TextureStreamer::load(const std::shared_ptr<Texture2D>& texture, const std::string& file, TextureCompression compression, TextureUsage usage) {
+    texture->setData(PlaceholderColor, gl::PixelFormat::RGBA, gl::PixelType::UNSIGNED_BYTE, gl::TextureInternalFormat::RGBA, 1, 1);
+    pending.push_back(Request{texture, file, compression, usage});
+    startDecodes();
+}
+
+void TextureStreamer::startDecodes() {
+    while(!pending.empty() && inFlight < maxInFlight) {
+        Request request = std::move(pending.front());
+        pending.pop_front();
+        ++inFlight;
+        {
+            std::lock_guard<std::mutex> lock{readyMutex};
+            ++decoding;
+        }
+        workers.submit([this, request = std::move(request)]() mutable {
+            Image image;
+            image.texture = std::move(request.texture);
+            image.file = std::move(request.file);
+            try {
+                // bake on this worker only, the other workers decode other files
+                texcache::CompressedImage compressed;
+                if(request.compression != TextureCompression::None &&
+                    texcache::load(image.file, request.compression, request.usage, nullptr, compressed)) {
+                    image.width = compressed.width;
+                    image.height = compressed.height;
+                    image.channels = 4;
+                    image.compressedFormat = bc::glFormat(compressed.format);
+                    image.data = std::move(compressed.data);
+                    for(const texcache::Level& level : compressed.levels)
+                        image.levelOffsets.push_back(level.offset);
+                }
+                int width = 0, height = 0, channels = 0;
+                unsigned char* pixels = image.compressedFormat ? nullptr : stbi_load(image.file.c_str(), &width, &height, &channels, 0);
+                if(pixels) {
+                    // channels stays 0 for unsupported formats, they are reported as failed
+                    if(channels == 1 || channels == 3 || channels == 4) {
+                        image.width = width;
+                        image.height = height;
+                        image.channels = channels;
+                        image.data.assign(pixels, pixels + (size_t)width * height * channels);
+                        image.levelOffsets.assign(1, 0);
+                        buildMipChain(image);
+                    }
+                    stbi_image_free(pixels);
+                }
+            } catch(const std::exception&) {
+                image.channels = 0;
+                image.data.clear();
+            }
+            {
+                std::lock_guard<std::mutex> lock{readyMutex};
+                ready.push_back(std::move(image));
+                --decoding;
+                // notify under the lock, the destructor may return as soon as it is released
+                readyCondition.notify_all();
+            }
+        });
+    }
+    stats.queued = static_cast<uint32_t>(pending.size());
+    stats.decoding = inFlight;
+}
+
+void TextureStreamer::buildMipChain(Image& image) {
+    const uint32_t c = image.channels;
+    uint32_t w = image.width, h = image.height;
+    size_t source = image.levelOffsets.back();
+    while(w > 1 || h > 1) {
+        const uint32_t nw = std::max(w / 2, 1u), nh = std::max(h / 2, 1u);
+        const size_t dest = image.data.size();
+        image.data.resize(dest + (size_t)nw * nh * c);
+        const uint8_t* src = image.data.data() + source;
+        uint8_t* dst = image.data.data() + dest;
+        for(uint32_t y = 0; y < nh; ++y) {
+            const uint32_t y0 = std::min(2 * y, h - 1), y1 = std::min(2 * y + 1, h - 1);
+            for(uint32_t x = 0; x < nw; ++x) {
+                const uint32_t x0 = std::min(2 * x, w - 1), x1 = std::min(2 * x + 1, w - 1);
+                for(uint32_t k = 0; k < c; ++k) {
+                    const uint32_t sum = src[((size_t)y0 * w + x0) * c + k] + src[((size_t)y0 * w + x1) * c + k]
+                        + src[((size_t)y1 * w + x0) * c + k] + src[((size_t)y1 * w + x1) * c + k];
+                    dst[((size_t)y * nw + x) * c + k] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+        image.levelOffsets.push_back(dest);
+        source = dest;
+        w = nw;
+        h = nh;
+    }
+}
+
+bool TextureStreamer::upload(Image& image, bool wait) {
+    if(image.channels == 0) {
+        uploadError(*image.texture);
+        std::cerr << "Unable to load texture: " << image.file << std::endl;
+        ++stats.failed;
+        return true;
+    }
+
+    Staging& s = staging[nextStaging];
+    if(s.fence) {
+        const GLenum status = glClientWaitSync(s.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? UINT64_MAX : 0);
+        if(status == GL_TIMEOUT_EXPIRED)
+            return false;
+        glDeleteSync(s.fence);
+        s.fence = nullptr;
+    }
+    nextStaging = (nextStaging + 1) % StagingCount;
+
+    // the buffer is idle, so it is written without synchronization
+    if(!s.buffer)
+        glGenBuffers(1, &s.buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s.buffer);
+    if(s.size < image.data.size()) {
+        s.size = image.data.size();
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, s.size, nullptr, GL_STREAM_DRAW);
+    }
+    void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, image.data.size(), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    std::memcpy(dst, image.data.data(), image.data.size());
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    // rows of 1 and 3 channel images are not 4 byte aligned
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    const uint32_t levels = static_cast<uint32_t>(image.levelOffsets.size());
+    for(uint32_t level = 0; level < levels; ++level) {
+        const uint8_t* offset = nullptr;
+        offset += image.levelOffsets[level];
+        const uint32_t width = std::max(image.width >> level, 1u), height = std::max(image.height >> level, 1u);
+        if(image.compressedFormat) {
+            const size_t end = level + 1 < levels ? image.levelOffsets[level + 1] : image.data.size();
+            image.texture->setCompressedData(offset, image.compressedFormat, width, height, end - image.levelOffsets[level], level);
+        } else {
+            image.texture->setData(offset, channelFormat(image.channels), gl::PixelType::UNSIGNED_BYTE, channelInternalFormat(image.channels),
+                width, height, level);
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    image.texture->bind();
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    image.texture->setFilterMode(gl::TextureParamFilter::TEXTURE_MIN_FILTER, gl::TextureFilterMode::LINEAR_MIPMAP_LINEAR);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    s.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    ++stats.uploaded;
+    stats.uploadedBytes += image.data.size();
+    return true;
+}
+
+void TextureStreamer::uploadError(Texture2D& texture) {
+    static const uint8_t errorColor[3] = {244, 31, 237};
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    texture.setData(errorColor, gl::PixelFormat::RGB, gl::PixelType::UNSIGNED_BYTE, gl::TextureInternalFormat::RGB, 1, 1);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+void TextureStreamer::update(double budget) {
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&start]() {return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();};
+
+    for(bool first = true; first || elapsed() < budget; first = false) {
+        Image image;
+        {
+            std::lock_guard<std::mutex> lock{readyMutex};
+            if(ready.empty())
+                break;
+            image = std::move(ready.front());
+            ready.pop_front();
+        }
+        if(!upload(image, false)) {
+            // staging buffers are still read by the gpu
+            std::lock_guard<std::mutex> lock{readyMutex};
+            ready.push_front(std::move(image));
+            break;
+        }
+        --inFlight;
+    }
+    startDecodes();
+    stats.lastUpdateTime = elapsed();
+}
+
+void TextureStreamer::finish() {
+    startDecodes();
+    while(inFlight > 0) {
+        Image image;
+        {
+            std::unique_lock<std::mutex> lock{readyMutex};
+            readyCondition.wait(lock, [this]() {return !ready.empty();});
+            image = std::move(ready.front());
+            ready.pop_front();
+        }
+        upload(image, true);
+        --inFlight;
+        startDecodes();
+    }
+}
@@ -0,0 +1,47 @@
+/**
+ * @file thread_pool.cpp
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <thread_pool.h>
+
+using namespace ssre::util;
+
+ThreadPool::ThreadPool(std::size_t nThreads) {
+    if(nThreads == 0)
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+    workers.reserve(nThreads);
+    for(std::size_t i = 0; i < nThreads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock{queueMutex};
+        stopping = true;
+    }
+    queueCondition.notify_all();
+    for(auto& w : workers) {
+        if(w.joinable())
+            w.join();
+    }
+}
+
+void ThreadPool::workerLoop() {
+    while(true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock{queueMutex};
+            queueCondition.wait(lock, [this]{return stopping || !tasks.empty();});
+            // finish queued work before exiting
+            if(stopping && tasks.empty())
+                return;
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
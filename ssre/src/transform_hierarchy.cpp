@@ -0,0 +1,119 @@
+/**
+ * @file transform_hierarchy.cpp
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <transform_hierarchy.h>
+
+#include <ssre.h>
+
+using namespace ssre;
+
+uint32_t TransformHierarchy::add(Node* owner, uint32_t parent, const LocalTransform& local) {
+    SSRE_CHECK_THROW(parent == NoParent || parent < size(), "Transform parent must be added before its children");
+
+    const uint32_t index = static_cast<uint32_t>(size());
+    locals.push_back(local);
+    parents.push_back(parent);
+    frames.push_back(glm::mat4{1.f});
+    worlds.push_back(glm::mat4{1.f});
+    normals.push_back(glm::mat3{1.f});
+    owners.push_back(owner);
+    dirty.push_back(1);
+    firstDirty = std::min(firstDirty, index);
+    return index;
+}
+
+std::vector<uint32_t> TransformHierarchy::subtree(uint32_t root) const {
+    std::vector<uint32_t> out{root};
+    std::vector<uint8_t> inSubtree(size() - root, 0);
+    inSubtree[0] = 1;
+    // descendants always follow their parent
+    for(uint32_t i = root + 1; i < size(); ++i) {
+        if(parents[i] != NoParent && parents[i] >= root && inSubtree[parents[i] - root]) {
+            inSubtree[i - root] = 1;
+            out.push_back(i);
+        }
+    }
+    return out;
+}
+
+void TransformHierarchy::remove(const std::vector<uint32_t>& sortedIndices) {
+    if(sortedIndices.empty())
+        return;
+
+    std::vector<uint32_t> remap(size(), NoParent);
+    uint32_t next = 0;
+    auto removed = sortedIndices.begin();
+    for(uint32_t i = 0; i < size(); ++i) {
+        if(removed != sortedIndices.end() && *removed == i) {
+            ++removed;
+            continue;
+        }
+        remap[i] = next;
+        if(next != i) {
+            locals[next] = locals[i];
+            frames[next] = frames[i];
+            worlds[next] = worlds[i];
+            normals[next] = normals[i];
+            dirty[next] = dirty[i];
+            owners[next] = owners[i];
+        }
+        parents[next] = parents[i] == NoParent ? NoParent : remap[parents[i]];
+        next++;
+    }
+
+    locals.resize(next);
+    parents.resize(next);
+    frames.resize(next);
+    worlds.resize(next);
+    normals.resize(next);
+    dirty.resize(next);
+    owners.resize(next);
+    updated.clear();
+
+    firstDirty = NoParent;
+    auto d = std::find(dirty.begin(), dirty.end(), 1);
+    if(d != dirty.end())
+        firstDirty = static_cast<uint32_t>(d - dirty.begin());
+}
+
+void TransformHierarchy::update() {
+    const size_t n = size();
+    updated.clear();
+    if(firstDirty >= n)
+        return; // nothing moved
+
+    for(size_t i = firstDirty; i < n; ++i) {
+        // parents precede children, so a moved parent is already flagged
+        if(!dirty[i]) {
+            if(parents[i] == NoParent || !dirty[parents[i]])
+                continue;
+            dirty[i] = 1;
+        }
+
+        const LocalTransform& l = locals[i];
+
+        // translate(position) * rotation * translate(offset)
+        glm::mat4 frame = l.rotation;
+        frame[3] = glm::vec4{l.position, 0.f} + l.rotation * glm::vec4{l.offset, 1.f};
+
+        if(parents[i] != NoParent)
+            frame = frames[parents[i]] * frame;
+        frames[i] = frame;
+
+        glm::mat4& world = worlds[i];
+        world[0] = frame[0] * l.scale.x;
+        world[1] = frame[1] * l.scale.y;
+        world[2] = frame[2] * l.scale.z;
+        world[3] = frame[3];
+
+        normals[i] = glm::transpose(glm::inverse(glm::mat3{world}));
+        updated.push_back(static_cast<uint32_t>(i));
+    }
+
+    std::fill(dirty.begin() + firstDirty, dirty.end(), 0);
+    firstDirty = NoParent;
+}
@@ -12,14 +12,27 @@
 
 #include <iostream>
 #include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstring>
 
 #include <ssre.h>
 #include <renderer.h>
+#include <headless_context.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
 
 using namespace ssre;
 
 namespace {
 
+// seconds since the first call, glfw time is not available in headless windows
+double getTime() {
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
 // glfw error callback
 void glfw_error_callback(int error, const char *description)
 {
@@ -106,12 +119,20 @@ void gl_debug_callback(GLenum source, GLenum type, GLuint id, GLenum severity,
         break;
     }
 
-    std::cout << "[" << std::setprecision(5) << std::fixed << glfwGetTime() << "] OpenGL[" << output_source << ":" << output_severity << ":" << output_type << "] " << output_message << std::endl;
+    std::cout << "[" << std::setprecision(5) << std::fixed << getTime() << "] OpenGL[" << output_source << ":" << output_severity << ":" << output_type << "] " << output_message << std::endl;
 }
 
 }
 
-Window::Window(uint32_t width, uint32_t height, std::string name) {
+Window::Window(uint32_t width, uint32_t height, std::string name, WindowMode mode) : mode{mode}, width{width}, height{height} {
+    if(mode == WindowMode::Headless)
+        createHeadless();
+    else
+        createWindow(name);
+    initGL();
+}
+
+void Window::createWindow(const std::string& name) {
     glfwSetErrorCallback(glfw_error_callback);
 
     //request the highest possible version of OpenGL
@@ -150,7 +171,32 @@ Window::Window(uint32_t width, uint32_t height, std::string name) {
 
     // Set vsync interval
 	glfwSwapInterval(1);
+}
+
+void Window::createHeadless() {
+    headless = std::make_unique<HeadlessContext>();
+    if(!gladLoadGLLoader((GLADloadproc)HeadlessContext::getProcAddress)) {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        throw ssre_exception{"Failed to initialize GLAD"};
+    }
+
+    // offscreen target in place of the window's default framebuffer
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    SSRE_CHECK_THROW(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Headless framebuffer is not complete!");
+}
 
+void Window::initGL() {
     glViewport(0, 0, width, height);
 
     // only for core version 4.3 and later
@@ -161,27 +207,48 @@ Window::Window(uint32_t width, uint32_t height, std::string name) {
 }
 
 Window::~Window() {
+    if(headless) {
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(1, &colorBuffer);
+        glDeleteRenderbuffers(1, &depthBuffer);
+    }
 if(window_ptr)
     glfwDestroyWindow(window_ptr);
 }
 
 static double getElapsedTime() {
-    static float lastTime = glfwGetTime();
-    double thisTime = glfwGetTime();
+    static double lastTime = getTime();
+    double thisTime = getTime();
     double delta = thisTime - lastTime;
     lastTime = thisTime;
     return delta;
 }
 
-void Window::Run() {
-    if(window_ptr) {
-        while(!glfwWindowShouldClose(window_ptr)) {
-            deltaTime = getElapsedTime();
+void Window::SetRenderer(const std::shared_ptr<Renderer>& renderer) {
+    this->renderer = renderer;
+    if(renderer)
+        renderer->setTargetFramebuffer(framebuffer);
+}
 
-            // render
-            if(renderer)
-                renderer->render(deltaTime);
+void Window::Run() {
+    closeRequested = false;
+    const uint64_t lastFrame = frameLimit ? frameCount + frameLimit : 0;
+    while(!closeRequested && (!window_ptr || !glfwWindowShouldClose(window_ptr)) && (!lastFrame || frameCount < lastFrame)) {
+        deltaTime = fixedDelta > 0.f ? fixedDelta : getElapsedTime();
+
+        // render
+        if(renderer)
+            renderer->render(deltaTime);
+
+        if(!capturePattern.empty() && frameCount % captureInterval == 0) {
+            std::vector<char> path(capturePattern.size() + 32);
+            std::snprintf(path.data(), path.size(), capturePattern.c_str(), (unsigned)frameCount);
+            if(!captureFrame(path.data()))
+                std::cerr << "Frame capture to " << path.data() << " failed" << std::endl;
+        }
+        ++frameCount;
 
+        if(window_ptr) {
             // display frame
             glfwSwapBuffers(window_ptr);
             // update inputs
@@ -190,9 +257,38 @@ void Window::Run() {
             updateMouseVel();
         }
     }
+    // finish offscreen work before the caller reads results or destroys the context
+    if(headless)
+        glFinish();
+}
+
+bool Window::captureFrame(const std::string& path) const {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glReadBuffer(framebuffer ? GL_COLOR_ATTACHMENT0 : GL_BACK);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    const size_t rowBytes = width * 4;
+    std::vector<uint8_t> pixels(rowBytes * height);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    // gl rows start at the bottom
+    std::vector<uint8_t> row(rowBytes);
+    for(uint32_t y = 0; y < height / 2; ++y) {
+        uint8_t* top = pixels.data() + y * rowBytes;
+        uint8_t* bottom = pixels.data() + (height - 1 - y) * rowBytes;
+        std::memcpy(row.data(), top, rowBytes);
+        std::memcpy(top, bottom, rowBytes);
+        std::memcpy(bottom, row.data(), rowBytes);
+    }
+    return stbi_write_png(path.c_str(), width, height, 4, pixels.data(), (int)rowBytes) != 0;
 }
 
 void Window::setMouseCursorVisible(bool visible) {
+    if(!window_ptr) {
+        mouseCursorVisible = visible;
+        return;
+    }
     if(visible) {
         glfwSetInputMode(window_ptr, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
     } else {
@@ -247,6 +343,8 @@ void Window::mouse_cursor_position_callback(GLFWwindow* window, double xpos, dou
 }
 
 void Window::framebuffer_size_callback(GLFWwindow* window, int width, int height) {
+    Window::StaticInst().width = width;
+    Window::StaticInst().height = height;
     glViewport(0, 0, width, height);
     if(Window::StaticInst().framebufferResizeCallback)
         Window::StaticInst().framebufferResizeCallback(width, height);
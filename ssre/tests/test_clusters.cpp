@@ -0,0 +1,118 @@
+/**
+ * @file test_clusters.cpp
+ * @brief LightClusters::build against the brute force LightClusters::buildReference
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <clusters.h>
+#include <thread_pool.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace ssre;
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    if(!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+constexpr float Near = 0.1f;
+constexpr float Far = 100.f;
+
+// lights around the view frustum, including lights behind the camera and past the far plane
+std::vector<glm::vec4> randomLights(std::mt19937& rng, size_t count) {
+    std::uniform_real_distribution<float> xy{-60.f, 60.f};
+    std::uniform_real_distribution<float> z{-Far * 1.2f, 10.f};
+    std::uniform_real_distribution<float> range{0.05f, 20.f};
+    std::vector<glm::vec4> lights(count);
+    for(glm::vec4& l : lights)
+        l = glm::vec4{xy(rng), xy(rng), z(rng), range(rng)};
+    return lights;
+}
+
+// lights whose spheres cross the near or the far plane
+std::vector<glm::vec4> planeLights() {
+    return {
+        {0.f, 0.f, -Near, 0.5f},
+        {0.f, 0.f, 0.f, 0.2f},
+        {1.f, -1.f, 0.5f, 0.45f},
+        {0.f, 0.f, -Far, 5.f},
+        {3.f, 2.f, -Far - 1.f, 1.5f},
+        {-2.f, 0.5f, -Far + 0.01f, 0.01f},
+        {0.f, 0.f, -Far * 2.f, 1.f},    // entirely past the far plane
+        {0.f, 0.f, 5.f, 1.f}            // entirely behind the camera
+    };
+}
+
+void compare(LightClusters& clusters, const glm::mat4& view, const std::vector<glm::vec4>& lights, util::ThreadPool* pool, const std::string& name) {
+    clusters.build(view, lights, pool);
+    const std::vector<glm::uvec2> built = clusters.getClusters();
+    const std::vector<uint32_t> builtIndices = clusters.getLightIndices();
+    const uint32_t builtCount = clusters.getHeader().gridSize.w;
+
+    clusters.buildReference(view, lights);
+    check(built.size() == clusters.getClusters().size(), name + ": cluster count");
+    check(built == clusters.getClusters(), name + ": cluster offsets and counts");
+    check(builtIndices == clusters.getLightIndices(), name + ": light indices");
+    check(builtCount == clusters.getHeader().gridSize.w, name + ": header light count");
+}
+
+}
+
+int main() {
+    const glm::mat4 projection = glm::perspective(glm::radians(60.f), 16.f / 9.f, Near, Far);
+    util::ThreadPool pool{4};
+    std::mt19937 rng{1234};
+
+    LightClusters clusters{16, 9, 24};
+    clusters.setProjection(projection, 1280, 720);
+    const glm::mat4 identity{1.f};
+
+    compare(clusters, identity, {}, nullptr, "no lights");
+    check(clusters.getLightIndices().empty(), "no lights: empty index list");
+    compare(clusters, identity, {}, &pool, "no lights, pool");
+
+    const std::vector<glm::vec4> straddling = planeLights();
+    compare(clusters, identity, straddling, nullptr, "near and far planes");
+    check(!clusters.getLightIndices().empty(), "near and far planes: lights were binned");
+
+    // the pool is only used from ParallelLightCount lights on
+    for(size_t count : {size_t(1), size_t(17), LightClusters::ParallelLightCount, size_t(200), size_t(1000)}) {
+        for(int set = 0; set < 4; ++set) {
+            std::vector<glm::vec4> lights = randomLights(rng, count);
+            lights.insert(lights.end(), straddling.begin(), straddling.end());
+            const std::string name = std::to_string(lights.size()) + " lights, set " + std::to_string(set);
+            compare(clusters, identity, lights, nullptr, name);
+            compare(clusters, identity, lights, &pool, name + ", pool");
+        }
+    }
+
+    // moved camera and another grid and viewport
+    LightClusters other{8, 8, 16};
+    other.setProjection(glm::perspective(glm::radians(90.f), 1.f, Near, Far), 512, 512);
+    const glm::mat4 view = glm::lookAt(glm::vec3{10.f, 5.f, 20.f}, glm::vec3{0.f}, glm::vec3{0.f, 1.f, 0.f});
+    for(int set = 0; set < 4; ++set) {
+        const std::vector<glm::vec4> lights = randomLights(rng, 300);
+        compare(other, view, lights, nullptr, "moved camera, set " + std::to_string(set));
+        compare(other, view, lights, &pool, "moved camera, set " + std::to_string(set) + ", pool");
+    }
+
+    if(failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "clusters: all checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
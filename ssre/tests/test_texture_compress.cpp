@@ -0,0 +1,205 @@
+/**
+ * @file test_texture_compress.cpp
+ * @brief Round trips images through the BC1, BC3, BC5 and BC7 encoders and bounds the error of each format
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <texture_compress.h>
+#include <thread_pool.h>
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ssre;
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    if(!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+struct Image {
+    std::string name;
+    uint32_t width = 0, height = 0;
+    std::vector<uint8_t> rgba;
+};
+
+struct Bound {
+    bc::Format format;
+    uint32_t channels;  // compared channels, BC5 only stores red and green
+    double minPsnr;     // over the compared channels, in dB
+};
+
+// the bounds leave a few dB below what the encoder reaches on these images
+// steep gradients over small images vary every channel independently, one line per block only approximates them
+const Bound SyntheticBounds[] = {
+    {bc::Format::BC1, 3, 31.},
+    {bc::Format::BC3, 4, 32.},
+    {bc::Format::BC5, 2, 45.},
+    {bc::Format::BC7, 4, 36.}
+};
+// photos have more colors per block than a two color line fits
+const Bound SampleBounds[] = {
+    {bc::Format::BC1, 3, 28.},
+    {bc::Format::BC3, 4, 29.},
+    {bc::Format::BC5, 2, 34.},
+    {bc::Format::BC7, 4, 39.}
+};
+
+Image gradient(uint32_t width, uint32_t height) {
+    Image image{"gradient", width, height, std::vector<uint8_t>(size_t{width} * height * 4)};
+    for(uint32_t y = 0; y < height; ++y) {
+        for(uint32_t x = 0; x < width; ++x) {
+            uint8_t* texel = &image.rgba[(size_t{y} * width + x) * 4];
+            texel[0] = static_cast<uint8_t>(x * 255 / (width - 1));
+            texel[1] = static_cast<uint8_t>(y * 255 / (height - 1));
+            texel[2] = static_cast<uint8_t>((x + y) * 255 / (width + height - 2));
+            texel[3] = static_cast<uint8_t>(255 - x * 255 / (width - 1));
+        }
+    }
+    return image;
+}
+
+// unit vectors packed like a tangent space normal map
+Image normals(uint32_t width, uint32_t height) {
+    Image image{"normals", width, height, std::vector<uint8_t>(size_t{width} * height * 4)};
+    for(uint32_t y = 0; y < height; ++y) {
+        for(uint32_t x = 0; x < width; ++x) {
+            const float nx = 0.6f * std::sin(x * 0.11f), ny = 0.6f * std::cos(y * 0.07f);
+            const float nz = std::sqrt(std::max(0.f, 1.f - nx * nx - ny * ny));
+            uint8_t* texel = &image.rgba[(size_t{y} * width + x) * 4];
+            texel[0] = static_cast<uint8_t>(std::lround((nx * 0.5f + 0.5f) * 255.f));
+            texel[1] = static_cast<uint8_t>(std::lround((ny * 0.5f + 0.5f) * 255.f));
+            texel[2] = static_cast<uint8_t>(std::lround((nz * 0.5f + 0.5f) * 255.f));
+            texel[3] = 255;
+        }
+    }
+    return image;
+}
+
+// smooth color with a little noise, the encoders must not fall apart on it
+Image noisy(uint32_t width, uint32_t height, std::mt19937& rng) {
+    Image image = gradient(width, height);
+    image.name = "noisy gradient";
+    std::uniform_int_distribution<int> noise{-6, 6};
+    for(uint8_t& channel : image.rgba)
+        channel = static_cast<uint8_t>(std::clamp(channel + noise(rng), 0, 255));
+    return image;
+}
+
+bool loadSample(const std::string& file, Image& image) {
+    int width = 0, height = 0, channels = 0;
+    unsigned char* pixels = stbi_load(file.c_str(), &width, &height, &channels, 4);
+    if(!pixels)
+        return false;
+    image.name = file;
+    image.width = static_cast<uint32_t>(width);
+    image.height = static_cast<uint32_t>(height);
+    image.rgba.assign(pixels, pixels + size_t{image.width} * image.height * 4);
+    stbi_image_free(pixels);
+    return true;
+}
+
+double psnr(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, uint32_t channels) {
+    double sum = 0.;
+    size_t count = 0;
+    for(size_t texel = 0; texel < a.size(); texel += 4) {
+        for(uint32_t c = 0; c < channels; ++c) {
+            const double d = static_cast<double>(int{a[texel + c]} - int{b[texel + c]});
+            sum += d * d;
+        }
+        count += channels;
+    }
+    const double mse = sum / static_cast<double>(count);
+    return mse == 0. ? 99. : 10. * std::log10(255. * 255. / mse);
+}
+
+void roundTrip(const Image& image, const Bound& bound, util::ThreadPool& pool) {
+    const std::string name = std::string{bc::formatName(bound.format)} + " " + image.name
+        + " " + std::to_string(image.width) + "x" + std::to_string(image.height);
+    std::vector<uint8_t> data(bc::compressedSize(bound.format, image.width, image.height));
+    bc::compress(bound.format, image.rgba.data(), image.width, image.height, data.data());
+    std::vector<uint8_t> parallel(data.size());
+    bc::compress(bound.format, image.rgba.data(), image.width, image.height, parallel.data(), &pool);
+    check(data == parallel, name + ": parallel compression matches");
+
+    std::vector<uint8_t> decoded(image.rgba.size());
+    bc::decompress(bound.format, data.data(), image.width, image.height, decoded.data());
+    const double quality = psnr(image.rgba, decoded, bound.channels);
+    std::cout << name << ": " << quality << " dB" << std::endl;
+    check(quality >= bound.minPsnr, name + ": psnr " + std::to_string(quality) + " below " + std::to_string(bound.minPsnr));
+}
+
+// flat blocks have a single color and must decode to it up to endpoint rounding
+void solidBlocks() {
+    std::mt19937 rng{7};
+    std::uniform_int_distribution<int> value{0, 255};
+    for(int i = 0; i < 64; ++i) {
+        uint8_t texels[16 * 4];
+        const uint8_t color[4] = {uint8_t(value(rng)), uint8_t(value(rng)), uint8_t(value(rng)), uint8_t(value(rng))};
+        for(int t = 0; t < 16; ++t)
+            std::copy(color, color + 4, texels + t * 4);
+        for(bc::Format format : {bc::Format::BC3, bc::Format::BC5, bc::Format::BC7}) {
+            uint8_t block[16], decoded[16 * 4];
+            bc::encodeBlock(format, texels, block);
+            bc::decodeBlock(format, block, decoded);
+            const uint32_t channels = format == bc::Format::BC5 ? 2 : 4;
+            // 565 endpoints of BC3 and the 7 bit endpoints of BC7 round, the palette hits within one step
+            const int tolerance = format == bc::Format::BC5 ? 0 : (format == bc::Format::BC3 ? 4 : 1);
+            bool close = true;
+            for(int t = 0; t < 16; ++t)
+                for(uint32_t c = 0; c < channels; ++c)
+                    close &= std::abs(int{decoded[t * 4 + c]} - int{color[c]}) <= tolerance;
+            check(close, std::string{bc::formatName(format)} + ": solid block " + std::to_string(i));
+        }
+    }
+}
+
+} // namespace
+
+// argv[1] is an optional directory with sample images
+int main(int argc, char** argv) {
+    util::ThreadPool pool{4};
+    std::mt19937 rng{1234};
+
+    solidBlocks();
+
+    // odd sizes cover the repeated edge texels
+    std::vector<Image> synthetic = {gradient(64, 64), gradient(37, 21), normals(64, 48), noisy(128, 128, rng)};
+    for(const Image& image : synthetic)
+        for(const Bound& bound : SyntheticBounds)
+            roundTrip(image, bound, pool);
+
+    if(argc > 1) {
+        const std::string directory = std::string{argv[1]} + "/";
+        size_t loaded = 0;
+        for(const char* file : {"grass.jpg", "desert.jpg", "cartoonWood.jpg", "cloud.bmp"}) {
+            Image image;
+            if(!loadSample(directory + file, image))
+                continue;
+            ++loaded;
+            for(const Bound& bound : SampleBounds)
+                roundTrip(image, bound, pool);
+        }
+        check(loaded > 0, "sample images in " + directory);
+    }
+
+    if(failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "texture compress: all checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
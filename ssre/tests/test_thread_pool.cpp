@@ -0,0 +1,72 @@
+/**
+ * @file test_thread_pool.cpp
+ * @brief ThreadPool::parallel_for coverage and exception propagation
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#include <thread_pool.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ssre;
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    if(!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+} // namespace
+
+int main() {
+    util::ThreadPool pool{4};
+
+    std::vector<int> visits(1000, 0);
+    pool.parallel_for(visits.size(), [&visits](std::size_t i) {++visits[i];});
+    bool once = true;
+    for(int v : visits)
+        once &= v == 1;
+    check(once, "every index is visited once");
+
+    // a throwing range must not end parallel_for while other ranges still run
+    for(int round = 0; round < 20; ++round) {
+        std::atomic<int> running{0};
+        std::atomic<int> finished{0};
+        bool thrown = false;
+        try {
+            pool.parallel_for(64, [&](std::size_t i) {
+                ++running;
+                if(i == 0)
+                    throw std::runtime_error{"range 0"};
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                ++finished;
+                --running;
+            });
+        } catch(const std::runtime_error&) {
+            thrown = true;
+        }
+        check(thrown, "exception is rethrown, round " + std::to_string(round));
+        // the first range stops at its throwing index, the others run to completion
+        check(running == 1, "no range runs after parallel_for returned, round " + std::to_string(round));
+        check(finished == 64 - 16, "other ranges finished, round " + std::to_string(round));
+    }
+
+    if(failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "thread pool: all checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -10,6 +10,7 @@
  */
 #include <iostream>
 #include <memory>
+#include <string>
 
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -20,6 +21,7 @@
 #include <buffer.h>
 #include <renderer.h>
 #include <resource.h>
+#include <texture_streamer.h>
 #include <mesh.h>
 #include <scene.h>
 #include <camera.h>
@@ -29,13 +31,49 @@ using namespace ssre;
 
 const uint32_t width = 1920, height = 1080;
 
-int main() {
+int main(int argc, char** argv) {
+    // --headless renders offscreen without a display, --frames n stops after n frames,
+    // --capture pattern writes frames to png files, e.g. frame_%05u.png
+    // --profile name writes frame timings to name.json (chrome trace) and name.csv after the run
+    // --compress bc|bc7 loads block compressed textures, --bake writes the texture caches of all assets and exits
+    bool headless = false;
+    bool bake = false;
+    TextureCompression compression = TextureCompression::None;
+    uint64_t frames = 0;
+    std::string capture;
+    std::string profile;
+    for(int i = 1; i < argc; ++i) {
+        const std::string arg{argv[i]};
+        if(arg == "--headless")
+            headless = true;
+        else if(arg == "--frames" && i + 1 < argc)
+            frames = std::stoull(argv[++i]);
+        else if(arg == "--capture" && i + 1 < argc)
+            capture = argv[++i];
+        else if(arg == "--profile" && i + 1 < argc)
+            profile = argv[++i];
+        else if(arg == "--compress" && i + 1 < argc)
+            compression = std::string{argv[++i]} == "bc7" ? TextureCompression::BC7 : TextureCompression::BC;
+        else if(arg == "--bake")
+            bake = true;
+    }
+    if(headless && frames == 0)
+        frames = 1;
+
     try {
-        SSRE_init();
+        if(bake) {
+            Resource::ConstructStatic("./asset/");
+            const size_t baked = Resource::StaticInst().bakeTextures(compression == TextureCompression::None ? TextureCompression::BC : compression);
+            std::cout << "Baked " << baked << " textures" << std::endl;
+            return 0;
+        }
+
+        SSRE_init(headless);
 
-        Window::ConstructStatic(width, height, "Something");
+        Window::ConstructStatic(width, height, std::string{"Something"}, headless ? WindowMode::Headless : WindowMode::Windowed);
         Window::StaticInst().setMouseCursorVisible(true);
         Resource::ConstructStatic("./asset/");
+        Resource::StaticInst().setTextureCompression(compression);
 
         // move below to Window?
         {
@@ -89,29 +127,29 @@ int main() {
 
         std::shared_ptr<Geometry> cubegeom = std::make_shared<Geometry>(3.f);//Resource::StaticInst().loadObj("cube.obj");
         MaterialInfo cubemat{};
-        cubemat.diffuse_tex = Resource::StaticInst().load2DTexture("dry-dirt2-albedo.png");
-        cubemat.metallic_tex = Resource::StaticInst().load2DTexture("dry-dirt2-metalness.png");
-        cubemat.roughness_tex = Resource::StaticInst().load2DTexture("dry-dirt2-roughness.png");
-        cubemat.normal_tex = Resource::StaticInst().load2DTexture("dry-dirt2-normal2.png");
-        cubemat.ambient_tex = Resource::StaticInst().load2DTexture("dry-dirt2-ao.png");
+        cubemat.diffuse_tex = Resource::StaticInst().load2DTextureAsync("dry-dirt2-albedo.png");
+        cubemat.metallic_tex = Resource::StaticInst().load2DTextureAsync("dry-dirt2-metalness.png");
+        cubemat.roughness_tex = Resource::StaticInst().load2DTextureAsync("dry-dirt2-roughness.png");
+        cubemat.normal_tex = Resource::StaticInst().load2DTextureAsync("dry-dirt2-normal2.png", TextureUsage::Normal);
+        cubemat.ambient_tex = Resource::StaticInst().load2DTextureAsync("dry-dirt2-ao.png");
         cubegeom->setMaterialId(0, cubegeom->addMaterial(cubemat));
 
         std::shared_ptr<Geometry> geom = Resource::StaticInst().loadObj("sphere.obj");
         MaterialInfo spmat{};
-        spmat.diffuse_tex = Resource::StaticInst().load2DTexture("rustediron2_basecolor.png");
-        spmat.metallic_tex = Resource::StaticInst().load2DTexture("rustediron2_metallic.png");
-        spmat.roughness_tex = Resource::StaticInst().load2DTexture("rustediron2_roughness.png");
-        spmat.normal_tex = Resource::StaticInst().load2DTexture("rustediron2_normal.png");
-        spmat.ambient_tex = Resource::StaticInst().load2DTexture("rustediron2_ao.png");
+        spmat.diffuse_tex = Resource::StaticInst().load2DTextureAsync("rustediron2_basecolor.png");
+        spmat.metallic_tex = Resource::StaticInst().load2DTextureAsync("rustediron2_metallic.png");
+        spmat.roughness_tex = Resource::StaticInst().load2DTextureAsync("rustediron2_roughness.png");
+        spmat.normal_tex = Resource::StaticInst().load2DTextureAsync("rustediron2_normal.png", TextureUsage::Normal);
+        spmat.ambient_tex = Resource::StaticInst().load2DTextureAsync("rustediron2_ao.png");
         geom->setMaterialId(0, geom->addMaterial(spmat));
 
         std::shared_ptr<Geometry> geom0 = Resource::StaticInst().loadObj("Leather_Chair_OBJ.obj", "Leather_Chair_OBJ/");
         MaterialInfo mat0{};
-        mat0.diffuse_tex = Resource::StaticInst().load2DTexture("Leather_Chair_OBJ/Maps/Low_for_Zb_Low_for_Zb_initialShadingGroup_baseColor.png");
-        mat0.metallic_tex = Resource::StaticInst().load2DTexture("Leather_Chair_OBJ/Maps/Low_for_Zb_Low_for_Zb_initialShadingGroup_metallic.png");
-        mat0.roughness_tex = Resource::StaticInst().load2DTexture("Leather_Chair_OBJ/Maps/Low_for_Zb_Low_for_Zb_initialShadingGroup_Roughness.png");
-        mat0.normal_tex = Resource::StaticInst().load2DTexture("Leather_Chair_OBJ/Maps/Low_for_Zb_Low_for_Zb_initialShadingGroup_Normal.png");
-        mat0.ambient_tex = Resource::StaticInst().load2DTexture("Leather_Chair_OBJ/Maps/Low_for_Zb_Low_for_Zb_initialShadingGroup_AmbientOcclusion.png");
+        mat0.diffuse_tex = Resource::StaticInst().load2DTextureAsync("Leather_Chair_OBJ/Maps/Low_for_Zb_Low_for_Zb_initialShadingGroup_baseColor.png");
+        mat0.metallic_tex = Resource::StaticInst().load2DTextureAsync("Leather_Chair_OBJ/Maps/Low_for_Zb_Low_for_Zb_initialShadingGroup_metallic.png");
+        mat0.roughness_tex = Resource::StaticInst().load2DTextureAsync("Leather_Chair_OBJ/Maps/Low_for_Zb_Low_for_Zb_initialShadingGroup_Roughness.png");
+        mat0.normal_tex = Resource::StaticInst().load2DTextureAsync("Leather_Chair_OBJ/Maps/Low_for_Zb_Low_for_Zb_initialShadingGroup_Normal.png", TextureUsage::Normal);
+        mat0.ambient_tex = Resource::StaticInst().load2DTextureAsync("Leather_Chair_OBJ/Maps/Low_for_Zb_Low_for_Zb_initialShadingGroup_AmbientOcclusion.png");
         size_t mat0id = geom0->addMaterial(mat0);
         geom0->setMaterialId(0, mat0id);
         geom0->setMaterialId(1, mat0id);
@@ -154,12 +192,27 @@ int main() {
         world->addNode(ground);
 
         MaterialInfo skymat{};
-        skymat.diffuse_tex = Resource::StaticInst().load2DTexture("sky.jpg");
+        skymat.diffuse_tex = Resource::StaticInst().load2DTextureAsync("sky.jpg");
         std::shared_ptr<SkySphere> sky = std::make_shared<SkySphere>(skyprog, skymat);
         sky->setModelMatrix(glm::rotate(glm::mat4{1.f}, glm::pi<float>() / 2.f, glm::vec3{1, 0, 0}));
         world->setSkysphere(sky);
 
+        // captures show the loaded textures instead of placeholders
+        if(headless)
+            Resource::StaticInst().getTextureStreamer().finish();
+
+        Window::StaticInst().setFrameLimit(frames);
+        Window::StaticInst().setFrameCapture(capture);
+        // reproducible frames for regression captures
+        if(headless)
+            Window::StaticInst().setFixedDelta(1.f / 60.f);
         Window::StaticInst().Run();
+
+        if(!profile.empty()) {
+            renderer->getProfiler().resolveQueries();
+            renderer->getProfiler().writeChromeTrace(profile + ".json");
+            renderer->getProfiler().writeCsv(profile + ".csv");
+        }
     } catch(ssre_exception e) {
         std::cout << e.what() << std::endl;
     }
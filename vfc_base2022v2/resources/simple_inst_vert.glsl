@@ -0,0 +1,20 @@
+#version  330 core
+layout(location = 0) in vec4 vertPos;
+layout(location = 1) in vec3 vertNor;
+//per instance model matrix, takes locations 3 to 6
+layout(location = 3) in mat4 instM;
+uniform mat4 P;
+uniform mat4 V;
+uniform vec3 lightPos;
+
+out vec3 fragNor;
+out vec3 lightDir;
+out vec3 EPos;
+
+void main()
+{
+	gl_Position = P * V * instM * vertPos;
+	fragNor = (V*instM * vec4(vertNor, 0.0)).xyz;
+	lightDir = (V*vec4(1.0, 1.0, -0.5, 0.0)).xyz; //directional in camera
+	EPos = vec3(1); //PULLED for release
+}
@@ -147,3 +147,74 @@ void Shape::draw(const shared_ptr<Program> prog) const
 	CHECKED_GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
 	CHECKED_GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 }
+
+void Shape::drawInstanced(const shared_ptr<Program> prog, unsigned int instBufID, int first, int count) const
+{
+	int h_pos, h_nor, h_tex, h_inst;
+	h_pos = h_nor = h_tex = -1;
+
+	CHECKED_GL_CALL(glBindVertexArray(vaoID));
+
+	// Bind position buffer
+	h_pos = prog->getAttribute("vertPos");
+	GLSL::enableVertexAttribArray(h_pos);
+	CHECKED_GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, posBufID));
+	CHECKED_GL_CALL(glVertexAttribPointer(h_pos, 3, GL_FLOAT, GL_FALSE, 0, (const void *)0));
+
+	// Bind normal buffer
+	h_nor = prog->getAttribute("vertNor");
+	if (h_nor != -1 && norBufID != 0)
+	{
+		GLSL::enableVertexAttribArray(h_nor);
+		CHECKED_GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, norBufID));
+		CHECKED_GL_CALL(glVertexAttribPointer(h_nor, 3, GL_FLOAT, GL_FALSE, 0, (const void *)0));
+	}
+
+	if (texBufID != 0)
+	{
+		// Bind texcoords buffer
+		h_tex = prog->getAttribute("vertTex");
+
+		if (h_tex != -1 && texBufID != 0)
+		{
+			GLSL::enableVertexAttribArray(h_tex);
+			CHECKED_GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, texBufID));
+			CHECKED_GL_CALL(glVertexAttribPointer(h_tex, 2, GL_FLOAT, GL_FALSE, 0, (const void *)0));
+		}
+	}
+
+	// Bind the model matrices, a mat4 attribute takes one location per column
+	h_inst = prog->getAttribute("instM");
+	CHECKED_GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, instBufID));
+	for (int c = 0; c < 4; c++)
+	{
+		GLSL::enableVertexAttribArray(h_inst + c);
+		const size_t offset = (size_t)first * sizeof(glm::mat4) + c * sizeof(glm::vec4);
+		CHECKED_GL_CALL(glVertexAttribPointer(h_inst + c, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (const void *)offset));
+		CHECKED_GL_CALL(glVertexAttribDivisor(h_inst + c, 1));
+	}
+
+	// Bind element buffer
+	CHECKED_GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eleBufID));
+
+	// Draw
+	CHECKED_GL_CALL(glDrawElementsInstanced(GL_TRIANGLES, (int)eleBuf.size(), GL_UNSIGNED_INT, (const void *)0, count));
+
+	// Disable and unbind
+	for (int c = 0; c < 4; c++)
+	{
+		CHECKED_GL_CALL(glVertexAttribDivisor(h_inst + c, 0));
+		GLSL::disableVertexAttribArray(h_inst + c);
+	}
+	if (h_tex != -1)
+	{
+		GLSL::disableVertexAttribArray(h_tex);
+	}
+	if (h_nor != -1)
+	{
+		GLSL::disableVertexAttribArray(h_nor);
+	}
+	GLSL::disableVertexAttribArray(h_pos);
+	CHECKED_GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+	CHECKED_GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+}
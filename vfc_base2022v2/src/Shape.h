@@ -22,6 +22,8 @@ public:
 	void init();
 	void measure();
 	void draw(const std::shared_ptr<Program> prog) const;
+	// draw count instances, instBufID holds one mat4 model matrix per instance starting at instance first
+	void drawInstanced(const std::shared_ptr<Program> prog, unsigned int instBufID, int first, int count) const;
 
 	glm::vec3 min = glm::vec3(0);
 	glm::vec3 max = glm::vec3(0);
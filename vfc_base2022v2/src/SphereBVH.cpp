@@ -0,0 +1,143 @@
+#include "SphereBVH.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+#define LEAF_SIZE 8
+
+void SphereBVH::build(const SphereSet &spheres)
+{
+	set = &spheres;
+	nodes.clear();
+	order.resize(spheres.size());
+	for (int i = 0; i < spheres.size(); i++)
+		order[i] = i;
+
+	if (spheres.size() > 0) {
+		nodes.reserve(2 * spheres.size() / LEAF_SIZE + 1);
+		nodes.push_back(BVHNode());
+		buildNode(0, 0, spheres.size());
+	}
+}
+
+void SphereBVH::buildNode(int index, int first, int count)
+{
+	const SphereSet &s = *set;
+
+	/* bounds of the spheres and of their centers */
+	glm::vec3 bmin(std::numeric_limits<float>::max()), bmax(-std::numeric_limits<float>::max());
+	glm::vec3 cmin = bmin, cmax = bmax;
+	for (int i = first; i < first + count; i++) {
+		int k = order[i];
+		glm::vec3 c(s.x[k], s.y[k], s.z[k]);
+		bmin = glm::min(bmin, c - glm::vec3(s.r[k]));
+		bmax = glm::max(bmax, c + glm::vec3(s.r[k]));
+		cmin = glm::min(cmin, c);
+		cmax = glm::max(cmax, c);
+	}
+	nodes[index].min = bmin;
+	nodes[index].max = bmax;
+	nodes[index].first = first;
+	nodes[index].count = count;
+	nodes[index].left = -1;
+
+	if (count <= LEAF_SIZE)
+		return;
+
+	/* split at the median center on the longest axis */
+	glm::vec3 ext = cmax - cmin;
+	const std::vector<float> &axis = (ext.x >= ext.y && ext.x >= ext.z) ? s.x : (ext.y >= ext.z ? s.y : s.z);
+	int half = count / 2;
+	std::nth_element(order.begin() + first, order.begin() + first + half, order.begin() + first + count,
+		[&axis](int a, int b) { return axis[a] < axis[b]; });
+
+	/* children are stored next to each other */
+	int left = (int)nodes.size();
+	nodes.push_back(BVHNode());
+	nodes.push_back(BVHNode());
+	nodes[index].left = left;
+
+	buildNode(left, first, half);
+	buildNode(left + 1, first + half, count - half);
+}
+
+int SphereBVH::cull(const ViewFrustum &frustum, std::vector<int> &visible) const
+{
+	visible.clear();
+	if (nodes.empty())
+		return 0;
+
+	/* node index and planes still to test */
+	std::vector<std::pair<int, int>> stack;
+	stack.push_back(std::make_pair(0, 0x3f));
+	while (!stack.empty()) {
+		int index = stack.back().first;
+		int mask = stack.back().second;
+		stack.pop_back();
+		const BVHNode &n = nodes[index];
+
+		glm::vec3 c = (n.min + n.max)*0.5f;
+		glm::vec3 e = (n.max - n.min)*0.5f;
+		bool outside = false;
+		for (int p = 0; p < 6 && !outside; p++) {
+			if (!(mask & (1 << p)))
+				continue;
+			glm::vec4 plane = frustum.getPlane(p);
+			float d = frustum.distToPlane(p, c);
+			float r = fabsf(plane.x)*e.x + fabsf(plane.y)*e.y + fabsf(plane.z)*e.z;
+			if (d < -r)
+				outside = true;
+			else if (d >= r)
+				mask &= ~(1 << p);
+		}
+		if (outside)
+			continue;
+
+		if (n.left >= 0) {
+			stack.push_back(std::make_pair(n.left, mask));
+			stack.push_back(std::make_pair(n.left + 1, mask));
+			continue;
+		}
+
+		const SphereSet &s = *set;
+		for (int i = n.first; i < n.first + n.count; i++) {
+			int k = order[i];
+			if (mask == 0 || !frustum.cull(glm::vec3(s.x[k], s.y[k], s.z[k]), s.r[k]))
+				visible.push_back(k);
+		}
+	}
+	return set->size() - (int)visible.size();
+}
+
+void SphereBVH::query(glm::vec3 center, float radius, std::vector<int> &out) const
+{
+	out.clear();
+	if (nodes.empty())
+		return;
+
+	const SphereSet &s = *set;
+	std::vector<int> stack(1, 0);
+	while (!stack.empty()) {
+		const BVHNode &n = nodes[stack.back()];
+		stack.pop_back();
+
+		glm::vec3 closest = glm::clamp(center, n.min, n.max);
+		glm::vec3 d = closest - center;
+		if (glm::dot(d, d) > radius*radius)
+			continue;
+
+		if (n.left >= 0) {
+			stack.push_back(n.left);
+			stack.push_back(n.left + 1);
+			continue;
+		}
+		for (int i = n.first; i < n.first + n.count; i++) {
+			int k = order[i];
+			glm::vec3 dc = glm::vec3(s.x[k], s.y[k], s.z[k]) - center;
+			float rr = radius + s.r[k];
+			if (glm::dot(dc, dc) <= rr*rr)
+				out.push_back(k);
+		}
+	}
+}
@@ -0,0 +1,46 @@
+/*
+* Bounding volume hierarchy over a SphereSet for view frustum culling.
+* The models in the demo do not move, so the tree is built once with
+* median splits on the longest axis. Subtrees completely inside the
+* frustum are accepted without testing their spheres.
+*/
+#pragma once
+#ifndef SPHEREBVH_H
+#define SPHEREBVH_H
+
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "ViewFrustum.h"
+
+class SphereBVH
+{
+public:
+	// build over all spheres in the set, the set must outlive the tree
+	void build(const SphereSet &spheres);
+
+	// writes indices of spheres that are at least partly inside to visible, returns the number culled
+	int cull(const ViewFrustum &frustum, std::vector<int> &visible) const;
+
+	// writes indices of spheres overlapping the query sphere
+	void query(glm::vec3 center, float radius, std::vector<int> &out) const;
+
+	int getNodeCount() const { return (int)nodes.size(); }
+
+private:
+	struct BVHNode {
+		glm::vec3 min, max;
+		int left;   // first child, second child is left + 1, -1 for leaves
+		int first;  // leaves: range in order
+		int count;
+	};
+
+	void buildNode(int index, int first, int count);
+
+	const SphereSet *set = nullptr;
+	std::vector<BVHNode> nodes;
+	// sphere indices, leaves reference ranges of this
+	std::vector<int> order;
+};
+
+#endif // SPHEREBVH_H
@@ -0,0 +1,123 @@
+#include "ViewFrustum.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define VFC_SSE
+#endif
+
+void SphereSet::add(glm::vec3 center, float radius)
+{
+	x.push_back(center.x);
+	y.push_back(center.y);
+	z.push_back(center.z);
+	r.push_back(radius);
+}
+
+void SphereSet::clear()
+{
+	x.clear();
+	y.clear();
+	z.clear();
+	r.clear();
+}
+
+ViewFrustum::ViewFrustum()
+{
+	for (int i = 0; i < 6; i++)
+		planes[i] = glm::vec4(0);
+}
+
+void ViewFrustum::extractPlanes(const glm::mat4 &P, const glm::mat4 &V)
+{
+	/* composite matrix, glm is column major so comp[col][row] */
+	glm::mat4 comp = P*V;
+	glm::vec4 row0(comp[0][0], comp[1][0], comp[2][0], comp[3][0]);
+	glm::vec4 row1(comp[0][1], comp[1][1], comp[2][1], comp[3][1]);
+	glm::vec4 row2(comp[0][2], comp[1][2], comp[2][2], comp[3][2]);
+	glm::vec4 row3(comp[0][3], comp[1][3], comp[2][3], comp[3][3]);
+
+	planes[LEFT] = row3 + row0;
+	planes[RIGHT] = row3 - row0;
+	planes[BOTTOM] = row3 + row1;
+	planes[TOP] = row3 - row1;
+	planes[NEAR_PLANE] = row3 + row2;
+	planes[FAR_PLANE] = row3 - row2;
+
+	/* normalize so plane distances are in world units */
+	for (int i = 0; i < 6; i++)
+		planes[i] /= glm::length(glm::vec3(planes[i]));
+}
+
+float ViewFrustum::distToPlane(int plane, glm::vec3 point) const
+{
+	const glm::vec4 &p = planes[plane];
+	return p.x*point.x + p.y*point.y + p.z*point.z + p.w;
+}
+
+bool ViewFrustum::cull(glm::vec3 center, float radius) const
+{
+	for (int i = 0; i < 6; i++) {
+		if (distToPlane(i, center) < -radius)
+			return true;
+	}
+	return false;
+}
+
+int ViewFrustum::cullSet(const SphereSet &spheres, std::vector<int> &visible) const
+{
+	const int n = spheres.size();
+	visible.clear();
+	visible.reserve(n);
+	int i = 0;
+
+#if defined(__AVX__)
+	for (; i + 8 <= n; i += 8) {
+		__m256 x = _mm256_loadu_ps(&spheres.x[i]);
+		__m256 y = _mm256_loadu_ps(&spheres.y[i]);
+		__m256 z = _mm256_loadu_ps(&spheres.z[i]);
+		__m256 negR = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&spheres.r[i]));
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (int p = 0; p < 6; p++) {
+			__m256 d = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes[p].x), x), _mm256_mul_ps(_mm256_set1_ps(planes[p].y), y));
+			d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(planes[p].z), z));
+			d = _mm256_add_ps(d, _mm256_set1_ps(planes[p].w));
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, negR, _CMP_GE_OQ));
+		}
+		int bits = _mm256_movemask_ps(inside);
+		/* write the visible indices compactly */
+		for (int k = 0; k < 8; k++) {
+			if (bits & (1 << k))
+				visible.push_back(i + k);
+		}
+	}
+#elif defined(VFC_SSE)
+	for (; i + 4 <= n; i += 4) {
+		__m128 x = _mm_loadu_ps(&spheres.x[i]);
+		__m128 y = _mm_loadu_ps(&spheres.y[i]);
+		__m128 z = _mm_loadu_ps(&spheres.z[i]);
+		__m128 negR = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&spheres.r[i]));
+		__m128 inside = _mm_setzero_ps();
+		for (int p = 0; p < 6; p++) {
+			__m128 d = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p].x), x), _mm_mul_ps(_mm_set1_ps(planes[p].y), y));
+			d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(planes[p].z), z));
+			d = _mm_add_ps(d, _mm_set1_ps(planes[p].w));
+			__m128 in = _mm_cmpge_ps(d, negR);
+			inside = p == 0 ? in : _mm_and_ps(inside, in);
+		}
+		int bits = _mm_movemask_ps(inside);
+		for (int k = 0; k < 4; k++) {
+			if (bits & (1 << k))
+				visible.push_back(i + k);
+		}
+	}
+#endif
+
+	/* remainder */
+	for (; i < n; i++) {
+		if (!cull(glm::vec3(spheres.x[i], spheres.y[i], spheres.z[i]), spheres.r[i]))
+			visible.push_back(i);
+	}
+	return n - (int)visible.size();
+}
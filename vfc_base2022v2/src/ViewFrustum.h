@@ -0,0 +1,52 @@
+/*
+* View frustum culling for bounding spheres.
+* Call extractPlanes(P, V) once per camera per frame, then cull single
+* spheres with cull() or whole SphereSets with cullSet(), which tests
+* 4 (SSE) or 8 (AVX) spheres at a time and writes the indices of the
+* visible spheres to a list.
+*/
+#pragma once
+#ifndef VIEWFRUSTUM_H
+#define VIEWFRUSTUM_H
+
+#include <vector>
+
+#include "glm/glm.hpp"
+
+/* bounding spheres stored as separate arrays so they can be loaded 4 or 8 at a time */
+class SphereSet
+{
+public:
+	std::vector<float> x, y, z, r;
+
+	void add(glm::vec3 center, float radius);
+	void clear();
+	int size() const { return (int)x.size(); }
+};
+
+class ViewFrustum
+{
+public:
+	enum Plane { LEFT = 0, RIGHT, BOTTOM, TOP, NEAR_PLANE, FAR_PLANE };
+
+	ViewFrustum();
+
+	// pull the six planes out of P*V, normals point inside and are unit length
+	void extractPlanes(const glm::mat4 &P, const glm::mat4 &V);
+
+	// signed distance, positive inside
+	float distToPlane(int plane, glm::vec3 point) const;
+
+	// returns true if the sphere is completely outside
+	bool cull(glm::vec3 center, float radius) const;
+
+	// writes indices of spheres that are at least partly inside to visible, returns the number culled
+	int cullSet(const SphereSet &spheres, std::vector<int> &visible) const;
+
+	const glm::vec4 &getPlane(int plane) const { return planes[plane]; }
+
+private:
+	glm::vec4 planes[6];
+};
+
+#endif // VIEWFRUSTUM_H
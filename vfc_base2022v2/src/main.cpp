@@ -6,7 +6,7 @@
  PRESS:
  'g' : camera runs on spline (not great points - you can fix them)
  'z': wireframe
- 'p' : evetually to CULL (you need to fix TODOs)
+ 'p' : toggle view frustum culling
  **EARLY RELEASE NO GAME CAMERA scroll for pitch and yaw camera
 
  // View Frustum Culling base code for CPE 476 VFC workshop
@@ -31,6 +31,8 @@
 #include "Spline.h"
 #include "util.h"
 #include "transForms.h"
+#include "ViewFrustum.h"
+#include "SphereBVH.h"
 
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tiny_obj_loader/tiny_obj_loader.h>
@@ -39,8 +41,9 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #define PI 3.1415927
-#define numO 80
+#define numO 100000
 enum Mat {ruby=0, brass, copper, gold, tone1, tone2, tone3, tone4, shadow};
+#define NUM_MATS (Mat::shadow+1)
 
 using namespace std;
 using namespace glm;
@@ -100,6 +103,29 @@ public:
 	bool CULL = false;
 	int cullCount;
 
+	//bounding spheres of the models, same order as NefTrans and SnowTrans
+	SphereSet NefSpheres;
+	SphereSet SnowSpheres;
+	//hierarchies over the spheres, built once since the models do not move
+	SphereBVH NefBVH;
+	SphereBVH SnowBVH;
+	//frustums of the game camera and the top down camera
+	ViewFrustum gameFrustum;
+	ViewFrustum topFrustum;
+	//indices of models to draw this frame
+	vector<int> visibleNef, visibleSnow;
+	vector<int> topNef, topSnow;
+
+	//instanced drawing of nef and the dogs
+	std::shared_ptr<Program> instProg;
+	std::shared_ptr<Program> texInstProg;
+	//model matrices of one drawScene, dogs first then nef grouped by material
+	GLuint InstBuffObj = 0;
+	vector<mat4> instMats;
+	//cull count is printed once a second
+	float reportTime = 0;
+	int reportFrames = 0;
+
 	/* load shader, textures, set up data */
 	void init(const std::string& resourceDirectory)
 	{
@@ -145,6 +171,37 @@ public:
 		texProg->addAttribute("vertNor");
 		texProg->addAttribute("vertTex");
 
+		// Same shading as prog and texProg with the model matrix read per instance
+		instProg = make_shared<Program>();
+		instProg->setVerbose(true);
+		instProg->setShaderNames(resourceDirectory + "/simple_inst_vert.glsl", resourceDirectory + "/simple_frag.glsl");
+		instProg->init();
+		instProg->addUniform("P");
+		instProg->addUniform("V");
+		instProg->addUniform("MatAmb");
+		instProg->addUniform("MatDif");
+		instProg->addUniform("MatSpec");
+		instProg->addUniform("MatShine");
+		instProg->addUniform("lightPos");
+		instProg->addAttribute("vertPos");
+		instProg->addAttribute("vertNor");
+		instProg->addAttribute("instM");
+
+		texInstProg = make_shared<Program>();
+		texInstProg->setVerbose(true);
+		texInstProg->setShaderNames(resourceDirectory + "/tex_inst_vert.glsl", resourceDirectory + "/tex_frag0.glsl");
+		texInstProg->init();
+		texInstProg->addUniform("P");
+		texInstProg->addUniform("V");
+		texInstProg->addUniform("flip");
+		texInstProg->addUniform("Texture0");
+		texInstProg->addUniform("MatShine");
+		texInstProg->addUniform("lightPos");
+		texInstProg->addAttribute("vertPos");
+		texInstProg->addAttribute("vertNor");
+		texInstProg->addAttribute("vertTex");
+		texInstProg->addAttribute("instM");
+
 		//read in a load the texture
 		texture0 = make_shared<Texture>();
 		texture0->setFilename(resourceDirectory + "/cloud.bmp");
@@ -172,12 +229,15 @@ public:
 		float tx, tz, s, r; 
 		float Wscale = 11.0*(numO/10.0);
 		srand(time(NULL));
+		NefTrans.reserve(numO);
+		SnowTrans.reserve(numO);
 
 		for (int i=0; i < numO; i++) {
 			if(i < 10) {
 				Wscale = 18.0;
 			} else {
-				Wscale = 18.0*(numO/10.0);
+				//keep the density of the first 10 so large counts stay spread over the view
+				Wscale = 18.0*sqrt(numO/10.0);
 			}
 			tx = 0.2 + Wscale*niceRand()-Wscale/2.0;
 			tz = 0.1 + Wscale*niceRand()-Wscale/2.0;
@@ -193,7 +253,12 @@ public:
     		//note 'bounding sphere' approximate - fix for your models!
 			transForms t2 = transForms(vec3(tx, -0.5, tz), r, 0.5, 1.5, i%8);
 			SnowTrans.push_back(t2);
+
+			NefSpheres.add(t1.mTrans, t1.mRadius);
+			SnowSpheres.add(t2.mTrans, t2.mRadius);
 		}
+		NefBVH.build(NefSpheres);
+		SnowBVH.build(SnowSpheres);
 
 	}
 
@@ -248,6 +313,9 @@ public:
 
 		//code to load in the ground plane (CPU defined data passed to GPU)
 		initGround();
+
+		//instance buffer, refilled by every drawScene
+		glGenBuffers(1, &InstBuffObj);
 	}
 
 	//directly pass quad for the ground to the GPU
@@ -317,13 +385,18 @@ public:
 
 	/* alt. model transforms -  - these are insane because they came from p2B and P4*/
     mat4 SetModel(shared_ptr<Program> curS, vec3 trans, float rotY, float rotX, vec3 sc) {
+    	mat4 ctm = GetModel(trans, rotY, rotX, sc);
+    	glUniformMatrix4fv(curS->getUniform("M"), 1, GL_FALSE, value_ptr(ctm));
+    	return ctm;
+    }
+
+    /* same transform without setting it, for instances */
+    mat4 GetModel(vec3 trans, float rotY, float rotX, vec3 sc) {
     	mat4 Trans = translate( glm::mat4(1.0f), trans);
     	mat4 RotateY = rotate( glm::mat4(1.0f), rotY, glm::vec3(0.0f, 1, 0));
     	mat4 RotateX = rotate( glm::mat4(1.0f), rotX, glm::vec3(1,0 ,0));
     	mat4 Sc = scale( glm::mat4(1.0f), sc);
-    	mat4 ctm = Trans*RotateY*Sc*RotateX;
-    	glUniformMatrix4fv(curS->getUniform("M"), 1, GL_FALSE, value_ptr(ctm));
-    	return ctm;
+    	return Trans*RotateY*Sc*RotateX;
     }
 
     void SetModel(std::shared_ptr<Program> prog, std::shared_ptr<MatrixStack>M) {
@@ -376,20 +449,15 @@ public:
 
 /* code to draw the scene - it will be helpful to be able to draw your geometry more than once*/
 //may use different shaders
-    void drawScene(mat4 P, mat4 V, bool cullFlag) {
+//nefIdx and snowIdx list the models to draw, cullFlag culls the remaining objects against the game camera
+    void drawScene(mat4 P, mat4 V, const vector<int> &nefIdx, const vector<int> &snowIdx, bool cullFlag) {
 
     	//For any shader switch be sure to set up ALL data
     	//matrix transforms for scene
 
-		// Draw an array lay out of doggos - textured meshes
-    	texProg->bind();
-    	glUniformMatrix4fv(texProg->getUniform("P"), 1, GL_FALSE, value_ptr(P));
-    	glUniformMatrix4fv(texProg->getUniform("V"), 1, GL_FALSE, value_ptr(V));
-    	glUniform3f(texProg->getUniform("lightPos"), 2.0+lightTrans, 2.0, 2.9);
-    	glUniform1f(texProg->getUniform("MatShine"), 27.9);
-    	glUniform1i(texProg->getUniform("flip"), 1);
-    	texture2->bind(texProg->getUniform("Texture0"));
-
+    	/* pack the model matrices of the dogs and nef into the instance buffer so each
+    	   group is one draw call instead of one per model */
+    	instMats.clear();
     	float dScale = 1.0/(theDog->max.x-theDog->min.x);
     	float sp = 3.0;
     	float off = -3.5;
@@ -397,18 +465,75 @@ public:
     		for (int j=0; j < 3; j++) {
     			mat4 t = glm::translate(mat4(1.0), vec3(off+sp*i, -0.5, off+sp*j));
     			mat4 s = glm::scale(mat4(1.0), vec3(dScale));
-    			glUniformMatrix4fv(texProg->getUniform("M"), 1, GL_FALSE, value_ptr(t*s));
     			//TODO look at this conditional and understand it - total hack on size
     			if( !cullFlag || !ViewFrustCull(vec3(off+sp*i, -0.5, off+sp*j), 3.0)) {
-    				theDog->draw(texProg);
+    				instMats.push_back(t*s);
     			}
     		}
     	}
-    	
+    	int numDogs = (int)instMats.size();
+
+    	//counting sort of nef by material, every nef also adds a shadow instance
+    	//nef instances with material m are [matFirst[m], matFirst[m+1])
+    	int matCount[NUM_MATS] = {0};
+    	int matFirst[NUM_MATS+1];
+    	for (int i : nefIdx)
+    		matCount[NefTrans[i].matID]++;
+    	matCount[Mat::shadow] += (int)nefIdx.size();
+    	matFirst[0] = numDogs;
+    	for (int m = 0; m < NUM_MATS; m++)
+    		matFirst[m+1] = matFirst[m] + matCount[m];
+    	instMats.resize(matFirst[NUM_MATS]);
+
+    	int matNext[NUM_MATS];
+    	copy(matFirst, matFirst + NUM_MATS, matNext);
+    	float meshScale = 1.0/(nef->max.x-nef->min.x);
+    	for (int i : nefIdx) {
+    		instMats[matNext[NefTrans[i].matID]++] = GetModel(vec3(NefTrans[i].mTrans.x, NefTrans[i].mTrans.y, NefTrans[i].mTrans.z), NefTrans[i].mRot, -3.14/2.0, vec3(meshScale));
+    		//fake mesh planar shadow - offsets hardcoded - not ideal should depend on light, etc.
+    		instMats[matNext[Mat::shadow]++] = GetModel(vec3(NefTrans[i].mTrans.x+0.2, NefTrans[i].mTrans.y-0.15, NefTrans[i].mTrans.z+0.2), NefTrans[i].mRot, -3.14/2.0, vec3(meshScale, 0.1*meshScale, meshScale));
+    	}
+
+    	glBindBuffer(GL_ARRAY_BUFFER, InstBuffObj);
+    	glBufferData(GL_ARRAY_BUFFER, instMats.size()*sizeof(mat4), instMats.data(), GL_STREAM_DRAW);
+    	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		// Draw an array lay out of doggos - textured meshes
+    	texInstProg->bind();
+    	glUniformMatrix4fv(texInstProg->getUniform("P"), 1, GL_FALSE, value_ptr(P));
+    	glUniformMatrix4fv(texInstProg->getUniform("V"), 1, GL_FALSE, value_ptr(V));
+    	glUniform3f(texInstProg->getUniform("lightPos"), 2.0+lightTrans, 2.0, 2.9);
+    	glUniform1f(texInstProg->getUniform("MatShine"), 27.9);
+    	glUniform1i(texInstProg->getUniform("flip"), 1);
+    	texture2->bind(texInstProg->getUniform("Texture0"));
+    	if (numDogs > 0)
+    		theDog->drawInstanced(texInstProg, InstBuffObj, 0, numDogs);
+    	texInstProg->unbind();
+
     	//the ground plane is also textured so draw it
+    	texProg->bind();
+    	glUniformMatrix4fv(texProg->getUniform("P"), 1, GL_FALSE, value_ptr(P));
+    	glUniformMatrix4fv(texProg->getUniform("V"), 1, GL_FALSE, value_ptr(V));
+    	glUniform3f(texProg->getUniform("lightPos"), 2.0+lightTrans, 2.0, 2.9);
+    	glUniform1f(texProg->getUniform("MatShine"), 27.9);
+    	glUniform1i(texProg->getUniform("flip"), 1);
+    	texture2->bind(texProg->getUniform("Texture0"));
     	drawGround(texProg);
     	texProg->unbind();
 
+    	//draw Nefriti and the shadows, one draw per material
+    	instProg->bind();
+    	glUniformMatrix4fv(instProg->getUniform("P"), 1, GL_FALSE, value_ptr(P));
+    	glUniformMatrix4fv(instProg->getUniform("V"), 1, GL_FALSE, value_ptr(V));
+    	glUniform3f(instProg->getUniform("lightPos"), 2.0+lightTrans, 2.0, 2.9);
+    	for (int m = 0; m < NUM_MATS; m++) {
+    		if (matCount[m] == 0)
+    			continue;
+    		SetMaterial(instProg, m);
+    		nef->drawInstanced(instProg, InstBuffObj, matFirst[m], matCount[m]);
+    	}
+    	instProg->unbind();
+
     	//swap shaders set up all data
 		//use the diffuse material shader
     	prog->bind();
@@ -417,35 +542,20 @@ public:
     	glUniformMatrix4fv(texProg->getUniform("V"), 1, GL_FALSE, value_ptr(V));
     	glUniform3f(prog->getUniform("lightPos"), 2.0+lightTrans, 2.0, 2.9);
 
-    	for (int i=0; i < numO; i++)  {
-    		//draw Nefriti, placeholder code to check for culling
-    		if( !cullFlag || !ViewFrustCull(NefTrans[i].mTrans, NefTrans[i].mRadius)) {
-    			SetMaterial(prog, NefTrans[i].matID);
-    			float meshScale = 1.0/(nef->max.x-nef->min.x);
-    			SetModel(prog, vec3(NefTrans[i].mTrans.x, NefTrans[i].mTrans.y, NefTrans[i].mTrans.z), NefTrans[i].mRot, -3.14/2.0, vec3(meshScale));
-      			//draw the mesh 
-    			nef->draw(prog);
-      			//fake mesh planar shadow - offsets hardcoded - not ideal should depend on light, etc.
-    			SetMaterial(prog, Mat::shadow);
-    			SetModel(prog, vec3(NefTrans[i].mTrans.x+0.2, NefTrans[i].mTrans.y-0.15, NefTrans[i].mTrans.z+0.2), NefTrans[i].mRot, -3.14/2.0, vec3(meshScale, 0.1*meshScale, meshScale));
-    			nef->draw(prog);
-    		}
-
+    	for (int i : snowIdx)  {
     		/*now draw the hierarchiucal model - pseudo Baymax*/
-    		if( !cullFlag || !ViewFrustCull(SnowTrans[i].mTrans, SnowTrans[i].mRadius)) {
-      			/* transforms weird because of code re-use - mostly ignore */
-    			mat4 Trans = glm::translate( glm::mat4(1.0f), vec3(SnowTrans[i].mTrans.x, SnowTrans[i].mTrans.y+0.1, SnowTrans[i].mTrans.z));
-    			mat4 RotateY = glm::rotate( glm::mat4(1.0f), SnowTrans[i].mRot, glm::vec3(0.0f, 1, 0));
-    			mat4 Sc = glm::scale( glm::mat4(1.0f), vec3(SnowTrans[i].mScale));
-    			mat4 com = Trans*RotateY*Sc;
-    			SetMaterial(prog, SnowTrans[i].matID);
-    			drawHierModel(com, prog);
-
-    			//fake mesh planar shadow - offsets hardcoded - not ideal should depend on light, etc.
-    			SetMaterial(prog, Mat::shadow);
-    			com =  SetModel(prog, vec3(SnowTrans[i].mTrans.x+0.2, SnowTrans[i].mTrans.y-0.5, SnowTrans[i].mTrans.z+0.2), SnowTrans[i].mRot, -3.14/2.0, vec3(0.3, 0.1, 0.3));
-    			drawHierModel(com, prog);
-    		}
+    		/* transforms weird because of code re-use - mostly ignore */
+    		mat4 Trans = glm::translate( glm::mat4(1.0f), vec3(SnowTrans[i].mTrans.x, SnowTrans[i].mTrans.y+0.1, SnowTrans[i].mTrans.z));
+    		mat4 RotateY = glm::rotate( glm::mat4(1.0f), SnowTrans[i].mRot, glm::vec3(0.0f, 1, 0));
+    		mat4 Sc = glm::scale( glm::mat4(1.0f), vec3(SnowTrans[i].mScale));
+    		mat4 com = Trans*RotateY*Sc;
+    		SetMaterial(prog, SnowTrans[i].matID);
+    		drawHierModel(com, prog);
+
+    		//fake mesh planar shadow - offsets hardcoded - not ideal should depend on light, etc.
+    		SetMaterial(prog, Mat::shadow);
+    		com =  SetModel(prog, vec3(SnowTrans[i].mTrans.x+0.2, SnowTrans[i].mTrans.y-0.5, SnowTrans[i].mTrans.z+0.2), SnowTrans[i].mRot, -3.14/2.0, vec3(0.3, 0.1, 0.3));
+    		drawHierModel(com, prog);
     	} 
 
         prog->unbind();
@@ -472,13 +582,28 @@ public:
     	//compute game camera view
     	mat4 GameCamView = GetView(prog);
 
-    	//only extract the planes for the game camaera
+    	//extract the planes for the game camera and cull the models with the hierarchies
     	ExtractVFPlanes(PerProj, GameCamView);
 
     	cullCount = 0;
+    	if (CULL) {
+    		cullCount += NefBVH.cull(gameFrustum, visibleNef);
+    		cullCount += SnowBVH.cull(gameFrustum, visibleSnow);
+    	} else {
+    		allIndices(visibleNef);
+    		allIndices(visibleSnow);
+    	}
+
     	//draw scene from 'game camera' perspective
-    	drawScene(PerProj, GameCamView, CULL);
-    	cout << "cull count: " << cullCount << endl;
+    	drawScene(PerProj, GameCamView, visibleNef, visibleSnow, CULL);
+
+    	reportTime += frametime;
+    	reportFrames++;
+    	if (reportTime >= 1.0) {
+    		cout << "cull count: " << cullCount << " of " << 2*numO << ", " << reportFrames/reportTime << " fps" << endl;
+    		reportTime = 0;
+    		reportFrames = 0;
+    	}
 
     	//draw big background sphere (always)
     	texProg->bind();
@@ -496,96 +621,51 @@ public:
     	mat4 TopView = GetTopView();
     	glClear( GL_DEPTH_BUFFER_BIT);
     	glViewport(0, 0, 300, 300);
-    	drawScene(OrthoProj, TopView, false);
+    	//only models in the top down view, this view does not show culling
+    	topFrustum.extractPlanes(OrthoProj, TopView);
+    	NefBVH.cull(topFrustum, topNef);
+    	SnowBVH.cull(topFrustum, topSnow);
+    	drawScene(OrthoProj, TopView, topNef, topSnow, false);
 
-  		/* draw the culled scene from a top down camera - nothing culled yet - fix that */
+  		/* draw the culled scene from a top down camera */
     	glClear( GL_DEPTH_BUFFER_BIT);
     	glViewport(0, height-300, 300, 300);
-    	drawScene(OrthoProj, TopView, CULL);
+    	drawScene(OrthoProj, TopView, visibleNef, visibleSnow, CULL);
 
     }
 
 
 
- 	/* VFC code starts here TODO - start here and fill in these functions!!!*/
-	vec4 Left, Right, Bottom, Top, Near, Far;
-	vec4 planes[6];
-
-/*TODO fill in */
-void ExtractVFPlanes(mat4 P, mat4 V) {
+ 	/* VFC code starts here */
 
-  /* composite matrix */
-  mat4 comp = P*V;
-  vec3 n; //use to pull out normal
-  float l; //length of normal for plane normalization
-
-  Left.x = comp[0][3] + comp[0][0]; 
-  Left.y = comp[1][3] + comp[1][0]; 
-  Left.z = comp[2][3] + comp[2][0]; 
-  Left.w = comp[3][3] + comp[3][0];
-  planes[0] = Left;
-  cout << "Left' " << Left.x << " " << Left.y << " " <<Left.z << " " << Left.w << endl;
-  
-  Right.x = 0; // see handout to fill in with values from comp
-  Right.y = 0; // see handout to fill in with values from comp
-  Right.z = 0; // see handout to fill in with values from comp
-  Right.w = 0; // see handout to fill in with values from comp
-  planes[1] = Right;
-  cout << "Right " << Right.x << " " << Right.y << " " <<Right.z << " " << Right.w << endl;
-
-  Bottom.x = 0; // see handout to fill in with values from comp
-  Bottom.y = 0; // see handout to fill in with values from comp
-  Bottom.z = 0; // see handout to fill in with values from comp
-  Bottom.w = 0; // see handout to fill in with values from comp
-  planes[2] = Bottom;
-  cout << "Bottom " << Bottom.x << " " << Bottom.y << " " <<Bottom.z << " " << Bottom.w << endl;
-  
-  Top.x = 0; // see handout to fill in with values from comp
-  Top.y = 0; // see handout to fill in with values from comp
-  Top.z = 0; // see handout to fill in with values from comp
-  Top.w = 0; // see handout to fill in with values from comp
-  planes[3] = Top;
-  cout << "Top " << Top.x << " " << Top.y << " " <<Top.z << " " << Top.w << endl;
-
-  Near.x = 0; // see handout to fill in with values from comp
-  Near.y = 0; // see handout to fill in with values from comp
-  Near.z = 0; // see handout to fill in with values from comp
-  Near.w = 0; // see handout to fill in with values from comp
-  planes[4] = Near;
-  cout << "Near " << Near.x << " " << Near.y << " " <<Near.z << " " << Near.w << endl;
-
-  Far.x = 0; // see handout to fill in with values from comp
-  Far.y = 0; // see handout to fill in with values from comp
-  Far.z = 0; // see handout to fill in with values from comp
-  Far.w = 0; // see handout to fill in with values from comp
-  planes[5] = Far;
-  cout << "Far " << Far.x << " " << Far.y << " " <<Far.z << " " << Far.w << endl;
+/* fill list with every model index, used when not culling */
+void allIndices(vector<int> &list) {
+  list.resize(numO);
+  for (int i=0; i < numO; i++)
+    list[i] = i;
 }
 
+/* planes of the game camera, see ViewFrustum */
+void ExtractVFPlanes(mat4 P, mat4 V) {
+  gameFrustum.extractPlanes(P, V);
+}
 
-/* helper function to compute distance to the plane */
-/* TODO: fill in */
+/* helper function to compute distance to the plane, plane must be normalized */
 float DistToPlane(float A, float B, float C, float D, vec3 point) {
-  return 0;
+  return A*point.x + B*point.y + C*point.z + D;
 }
 
 /* Actual cull on planes */
 //returns 1 to CULL
-//TODO fill in
 int ViewFrustCull(vec3 center, float radius) {
-
-  float dist;
-
   if (CULL) {
-    cout << "testing against all planes" << endl;
     for (int i=0; i < 6; i++) {
-      dist = DistToPlane(planes[i].x, planes[i].y, planes[i].z, planes[i].w, center);
-      //test against each plane
+      vec4 p = gameFrustum.getPlane(i);
+      if (DistToPlane(p.x, p.y, p.z, p.w, center) < -radius)
+        return 1;
     }
-    return 0; 
-  } else {
-    return 0;
   }
+  return 0;
 }
 
 /* code to draw waving hierarchical model */
@@ -732,58 +812,58 @@ int ViewFrustCull(vec3 center, float radius) {
 
       		switch (i) {
     			case 0: //jade
-      			glUniform3f(prog->getUniform("MatAmb"), 0.0135, 0.02225,  0.01575);
-      			glUniform3f(prog->getUniform("MatDif"), 0.14,  0.39,  0.23);
-      			glUniform3f(prog->getUniform("MatSpec"), 0.116228,  0.116228,  0.116228 );
-      			glUniform1f(prog->getUniform("MatShine"), 10.0);
+      			glUniform3f(curS->getUniform("MatAmb"), 0.0135, 0.02225,  0.01575);
+      			glUniform3f(curS->getUniform("MatDif"), 0.14,  0.39,  0.23);
+      			glUniform3f(curS->getUniform("MatSpec"), 0.116228,  0.116228,  0.116228 );
+      			glUniform1f(curS->getUniform("MatShine"), 10.0);
       			break;
       			case 1: //brass
-      			glUniform3f(prog->getUniform("MatAmb"), 0.3294, 0.2235, 0.02745);
-      			glUniform3f(prog->getUniform("MatDif"), 0.7804, 0.5686, 0.11373);
-      			glUniform3f(prog->getUniform("MatSpec"), 0.9922, 0.941176, 0.80784);
-      			glUniform1f(prog->getUniform("MatShine"), 27.9);
+      			glUniform3f(curS->getUniform("MatAmb"), 0.3294, 0.2235, 0.02745);
+      			glUniform3f(curS->getUniform("MatDif"), 0.7804, 0.5686, 0.11373);
+      			glUniform3f(curS->getUniform("MatSpec"), 0.9922, 0.941176, 0.80784);
+      			glUniform1f(curS->getUniform("MatShine"), 27.9);
       			break;
       			case 2: //copper
-      			glUniform3f(prog->getUniform("MatAmb"), 0.1913, 0.0735, 0.0225);
-      			glUniform3f(prog->getUniform("MatDif"), 0.7038, 0.27048, 0.0828);
-      			glUniform3f(prog->getUniform("MatSpec"), 0.257, 0.1376, 0.08601);
-      			glUniform1f(prog->getUniform("MatShine"), 12.8);
+      			glUniform3f(curS->getUniform("MatAmb"), 0.1913, 0.0735, 0.0225);
+      			glUniform3f(curS->getUniform("MatDif"), 0.7038, 0.27048, 0.0828);
+      			glUniform3f(curS->getUniform("MatSpec"), 0.257, 0.1376, 0.08601);
+      			glUniform1f(curS->getUniform("MatShine"), 12.8);
       			break;
       			case 3: // gold
-      			glUniform3f(prog->getUniform("MatAmb"), 0.09, 0.07, 0.08);
-      			glUniform3f(prog->getUniform("MatDif"), 0.91, 0.92, 0.91);
-      			glUniform3f(prog->getUniform("MatSpec"), 1.0, 0.7, 1.0);
-      			glUniform1f(prog->getUniform("MatShine"), 100.0);
+      			glUniform3f(curS->getUniform("MatAmb"), 0.09, 0.07, 0.08);
+      			glUniform3f(curS->getUniform("MatDif"), 0.91, 0.92, 0.91);
+      			glUniform3f(curS->getUniform("MatSpec"), 1.0, 0.7, 1.0);
+      			glUniform1f(curS->getUniform("MatShine"), 100.0);
       			break;
       			case 4: //tone1
-				glUniform3f(prog->getUniform("MatAmb"), 199.0/2550.0f, 151.0/2550.0f, 146.0/2550.0f);
-				glUniform3f(prog->getUniform("MatDif"), 199.0/255.0f, 151.0/255.0f, 146.0/255.0f);
-				glUniform3f(prog->getUniform("MatSpec"), 0.257, 0.1376, 0.08601);
-      			glUniform1f(prog->getUniform("MatShine"), 12.8);
+				glUniform3f(curS->getUniform("MatAmb"), 199.0/2550.0f, 151.0/2550.0f, 146.0/2550.0f);
+				glUniform3f(curS->getUniform("MatDif"), 199.0/255.0f, 151.0/255.0f, 146.0/255.0f);
+				glUniform3f(curS->getUniform("MatSpec"), 0.257, 0.1376, 0.08601);
+      			glUniform1f(curS->getUniform("MatShine"), 12.8);
 				break;
 				case 5: 
-				glUniform3f(prog->getUniform("MatAmb"), 216.0/2550.0f, 164.0/2550.0f, 151.0/2550.0f);
-				glUniform3f(prog->getUniform("MatDif"), 216.0/255.0f, 164.0/255.0f, 151.0/255.0f);
-				glUniform3f(prog->getUniform("MatSpec"), 0.257, 0.1376, 0.08601);
-      			glUniform1f(prog->getUniform("MatShine"), 12.8);
+				glUniform3f(curS->getUniform("MatAmb"), 216.0/2550.0f, 164.0/2550.0f, 151.0/2550.0f);
+				glUniform3f(curS->getUniform("MatDif"), 216.0/255.0f, 164.0/255.0f, 151.0/255.0f);
+				glUniform3f(curS->getUniform("MatSpec"), 0.257, 0.1376, 0.08601);
+      			glUniform1f(curS->getUniform("MatShine"), 12.8);
 				break;
 		 		case 6: 
-		 		glUniform3f(prog->getUniform("MatAmb"), 173.0/2550.0f, 129.0/2550.0f, 111.0/2550.0f);
-		 		glUniform3f(prog->getUniform("MatDif"), 173.0/255.0f, 129.0/255.0f, 111.0/255.0f);
-		 		glUniform3f(prog->getUniform("MatSpec"), 0.257, 0.1376, 0.08601);
-      			glUniform1f(prog->getUniform("MatShine"), 12.8);
+		 		glUniform3f(curS->getUniform("MatAmb"), 173.0/2550.0f, 129.0/2550.0f, 111.0/2550.0f);
+		 		glUniform3f(curS->getUniform("MatDif"), 173.0/255.0f, 129.0/255.0f, 111.0/255.0f);
+		 		glUniform3f(curS->getUniform("MatSpec"), 0.257, 0.1376, 0.08601);
+      			glUniform1f(curS->getUniform("MatShine"), 12.8);
 		 		break;
 		 		case 7: //tone4
-        		glUniform3f(prog->getUniform("MatAmb"), 87.0/2550.0f, 49/2550.0f, 31.0/2550.0f);
-        		glUniform3f(prog->getUniform("MatDif"), 87.0/255.0f, 49/255.0f, 31.0/255.0f);
-        		glUniform3f(prog->getUniform("MatSpec"), 0.257, 0.1376, 0.08601);
-      			glUniform1f(prog->getUniform("MatShine"), 12.8);
+        		glUniform3f(curS->getUniform("MatAmb"), 87.0/2550.0f, 49/2550.0f, 31.0/2550.0f);
+        		glUniform3f(curS->getUniform("MatDif"), 87.0/255.0f, 49/255.0f, 31.0/255.0f);
+        		glUniform3f(curS->getUniform("MatSpec"), 0.257, 0.1376, 0.08601);
+      			glUniform1f(curS->getUniform("MatShine"), 12.8);
         		break;
         		case 8: //shadow
-      			glUniform3f(prog->getUniform("MatAmb"), 0.12, 0.12, 0.12);
-      			glUniform3f(prog->getUniform("MatDif"), 0.0, 0.0, 0.0);
-      			glUniform3f(prog->getUniform("MatSpec"), 0.0, 0.0, 0.0);
-      			glUniform1f(prog->getUniform("MatShine"), 0);
+      			glUniform3f(curS->getUniform("MatAmb"), 0.12, 0.12, 0.12);
+      			glUniform3f(curS->getUniform("MatDif"), 0.0, 0.0, 0.0);
+      			glUniform3f(curS->getUniform("MatSpec"), 0.0, 0.0, 0.0);
+      			glUniform1f(curS->getUniform("MatShine"), 0);
       			break;
 
     	}